@@ -3,6 +3,8 @@
 
 #include "PinMapping.h"
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #define CONFIG_FILENAME "/config.json"
 #define CONFIG_VERSION 0x00011c00 // 0.1.28 // make sure to clean all after change
@@ -23,7 +25,12 @@
 #define MQTT_MAX_CERT_STRLEN 2560
 
 #define INV_MAX_NAME_STRLEN 31
-#define INV_MAX_COUNT 10
+// Upper limit of configured inverters, memory is only taken for the inverters in use.
+// The web API addresses inverters by an uint8_t id.
+#ifndef INV_MAX_COUNT
+#define INV_MAX_COUNT 128
+#endif
+static_assert(INV_MAX_COUNT <= 255, "Inverter ids are uint8_t");
 #define INV_MAX_CHAN_COUNT 6
 
 #define CHAN_MAX_NAME_STRLEN 31
@@ -66,6 +73,66 @@ struct SUNSPEC_INVERTER_CONFIG_T {
     CHANNEL_AC_CONFIG_T channel_ac[INV_MAX_CHAN_COUNT];
 };
 
+// List whose elements are allocated one by one and never move. Only the table of
+// N pointers is reserved up front, so other tasks keep valid references to the
+// elements while the web API appends inverters or drops trailing free slots.
+template <typename T, size_t N>
+class StableList {
+    using Items = std::vector<std::unique_ptr<T>>;
+
+public:
+    template <typename V>
+    class Iterator {
+    public:
+        explicit Iterator(const typename Items::const_iterator it)
+            : _it(it)
+        {
+        }
+        V& operator*() const { return **_it; }
+        V* operator->() const { return _it->get(); }
+        Iterator& operator++()
+        {
+            ++_it;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return _it != other._it; }
+        bool operator==(const Iterator& other) const { return _it == other._it; }
+
+    private:
+        typename Items::const_iterator _it;
+    };
+
+    StableList()
+    {
+        _items.reserve(N);
+    }
+
+    T& operator[](const size_t i) { return *_items[i]; }
+    const T& operator[](const size_t i) const { return *_items[i]; }
+    T& back() { return *_items.back(); }
+    size_t size() const { return _items.size(); }
+    void clear() { _items.clear(); }
+
+    Iterator<T> begin() { return Iterator<T>(_items.cbegin()); }
+    Iterator<T> end() { return Iterator<T>(_items.cend()); }
+    Iterator<const T> begin() const { return Iterator<const T>(_items.cbegin()); }
+    Iterator<const T> end() const { return Iterator<const T>(_items.cend()); }
+
+    // Appends zeroed elements or frees the trailing ones, the other elements stay in place
+    void resize(const size_t count)
+    {
+        while (_items.size() > count) {
+            _items.pop_back();
+        }
+        while (_items.size() < count && _items.size() < N) {
+            _items.push_back(std::make_unique<T>());
+        }
+    }
+
+private:
+    Items _items;
+};
+
 struct CONFIG_T {
     struct {
         uint32_t Version;
@@ -136,6 +203,8 @@ struct CONFIG_T {
     struct {
         uint64_t Serial;
         uint32_t PollInterval;
+        uint32_t PollIntervalMin;
+        uint32_t PollIntervalMax;
         struct {
             uint8_t PaLevel;
         } Nrf;
@@ -167,7 +236,8 @@ struct CONFIG_T {
         uint8_t Brightness;
     } Led_Single[PINMAPPING_LED_COUNT];
 
-    INVERTER_CONFIG_T Inverter[INV_MAX_COUNT];
+    // One entry per inverter slot, a slot with Serial 0 is free
+    StableList<INVERTER_CONFIG_T, INV_MAX_COUNT> Inverter;
     char Dev_PinMapping[DEV_MAX_MAPPING_NAME_STRLEN + 1];
 
     struct {
@@ -176,7 +246,7 @@ struct CONFIG_T {
         char Manufacturer[SUNSPEC_MAX_MANUFACTURER_STRLEN + 1];
         char Model[SUNSPEC_MAX_MODEL_STRLEN + 1];
         uint16_t PowerDivider{50};
-        SUNSPEC_INVERTER_CONFIG_T Inverter[INV_MAX_COUNT];
+        StableList<SUNSPEC_INVERTER_CONFIG_T, INV_MAX_COUNT> Inverter; // Same size as CONFIG_T::Inverter
     } SunSpec;
 };
 
@@ -191,6 +261,11 @@ public:
     INVERTER_CONFIG_T* getFreeInverterSlot();
     INVERTER_CONFIG_T* getInverterConfig(const uint64_t serial);
     void deleteInverterById(const uint8_t id);
+
+private:
+    // Resizes the inverter lists, new slots are free
+    void resizeInverters(const size_t count);
+    void resetInverterSlot(const uint8_t id);
 };
 
 extern ConfigurationClass Configuration;
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <EventIndex.h>
+#include <Hoymiles.h>
+#include <TaskSchedulerDeclarations.h>
+#include <mutex>
+#include <vector>
+
+#define EVENT_HISTORY_FILENAME "/eventlog.bin"
+
+#ifndef EVENT_HISTORY_MAX_COUNT
+#define EVENT_HISTORY_MAX_COUNT 500 // Events of all inverters kept in memory and on flash
+#endif
+
+#define EVENT_HISTORY_PAGE_SIZE 50
+#define EVENT_HISTORY_PAGE_MAX 100
+
+class EventHistoryClass {
+public:
+    EventHistoryClass();
+    void init(Scheduler& scheduler);
+
+    // False until the clock is set, events are only recorded with a known day
+    bool isAvailable();
+
+    // Number of events of the inverter between from and to (inclusive). Copies up to limit of them,
+    // newest first and skipping the first offset, into page.
+    size_t getEvents(const uint64_t serial, const uint32_t from, const uint32_t to,
+        const size_t offset, const size_t limit, std::vector<EventHistoryEntry_t>& page);
+
+private:
+    void loop();
+    void load();
+    void compact();
+    bool append(const EventHistoryRecord_t* records, const size_t count);
+    static bool getLocalDay(uint32_t& day, uint32_t& secondsOfDay);
+
+    Task _loopTask;
+
+    std::mutex _mutex;
+
+    EventIndex _index;
+    size_t _fileRecords = 0;
+
+    // Last AlarmLogParser update taken over, by inverter position
+    std::vector<uint32_t> _lastUpdate;
+};
+
+extern EventHistoryClass EventHistory;
@@ -6,6 +6,15 @@
 
 #define INVERTER_UPDATE_SETTINGS_INTERVAL 60000l
 
+// 1 = run the radio state machine in its own task, 0 = in the cooperative main loop
+#ifndef HOYMILES_RADIO_TASK
+#define HOYMILES_RADIO_TASK 0
+#endif
+// the Arduino loop task runs on ARDUINO_RUNNING_CORE (1), keep the radios away from it
+#ifndef HOYMILES_RADIO_TASK_CORE
+#define HOYMILES_RADIO_TASK_CORE 0
+#endif
+
 class InverterSettingsClass {
 public:
     InverterSettingsClass();
@@ -1,34 +1,75 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include <Arduino.h>
 #include <AsyncWebSocket.h>
 #include <HardwareSerial.h>
+#include <MpscRingBuffer.h>
 #include <Stream.h>
-#include <TaskSchedulerDeclarations.h>
-#include <mutex>
+#include <atomic>
 
-#define BUFFER_SIZE 500
+// console output waiting for the serial port (bytes, power of two)
+#ifndef MESSAGE_OUTPUT_BUFFER_SIZE
+#define MESSAGE_OUTPUT_BUFFER_SIZE 4096
+#endif
+#define MESSAGE_OUTPUT_SLOT_SIZE 32
+// single bytes (e.g. print(char)) are collected per task up to the end of the line or this
+// length before they take a slot of the buffer
+#define MESSAGE_OUTPUT_CHAR_BUFFER_SIZE MESSAGE_OUTPUT_SLOT_SIZE
+
+// console output collected for the websocket clients (bytes)
+#ifndef MESSAGE_OUTPUT_WS_BUFFER_SIZE
+#define MESSAGE_OUTPUT_WS_BUFFER_SIZE 512
+#endif
+// longest time (ms) output is collected before it is sent to the websocket clients
+#define MESSAGE_OUTPUT_WS_INTERVAL 250
+
+#define MESSAGE_OUTPUT_TASK_STACK_SIZE 4096
+// same as the Arduino loop task, below the radio task
+#define MESSAGE_OUTPUT_TASK_PRIORITY 1
+// sleep (ms) of the output task while there is nothing to write
+#define MESSAGE_OUTPUT_IDLE_WAIT 10
+
+struct MessageOutputStatistics_t {
+    uint32_t droppedBytes; // buffer was full
+    uint32_t wsDroppedBytes; // websocket clients did not take the output
+    uint32_t highWaterMark; // bytes
+};
 
 class MessageOutputClass : public Print {
 public:
-    MessageOutputClass();
-    void init(Scheduler& scheduler);
+    // Starts the output task, before that everything is written directly to the serial port
+    void init();
     size_t write(uint8_t c) override;
     size_t write(const uint8_t* buffer, size_t size) override;
+    int availableForWrite() override;
     void register_ws_output(AsyncWebSocket* output);
 
+    MessageOutputStatistics_t getStatistics() const;
+
 private:
+    static void taskFunction(void* arg);
     void loop();
+    void sendWs();
+    void flushChars();
+
+    MpscRingBuffer<MESSAGE_OUTPUT_SLOT_SIZE, MESSAGE_OUTPUT_BUFFER_SIZE / MESSAGE_OUTPUT_SLOT_SIZE> _buffer;
+    std::atomic<bool> _taskRunning { false };
 
-    Task _loopTask;
+    struct CharBuffer_t {
+        uint8_t data[MESSAGE_OUTPUT_CHAR_BUFFER_SIZE];
+        uint8_t len;
+    };
+    // Single bytes of the calling task which are not in the buffer yet
+    static thread_local CharBuffer_t _chars;
 
-    AsyncWebSocket* _ws = nullptr;
-    char _buffer[BUFFER_SIZE];
-    uint16_t _buff_pos = 0;
-    uint32_t _lastSend = 0;
-    bool _forceSend = false;
+    std::atomic<AsyncWebSocket*> _ws { nullptr };
+    std::atomic<uint32_t> _wsDroppedBytes { 0 };
 
-    std::mutex _msgLock;
+    // Only used by the output task
+    char _wsBuffer[MESSAGE_OUTPUT_WS_BUFFER_SIZE];
+    size_t _wsLen = 0;
+    uint32_t _wsLastSend = 0;
 };
 
 extern MessageOutputClass MessageOutput;
@@ -3,6 +3,7 @@
 
 #include <TaskSchedulerDeclarations.h>
 #include <ModbusTCP.h>
+#include <vector>
 
 class ModbusSunSpecClass : protected ModbusTCP {
 public:
@@ -60,7 +61,8 @@ private:
 
     void setPowerLimit(uint16_t limit_pct, uint16_t timeout_sec);
 
-    Limit _limit[INV_MAX_COUNT];
+    // Grows with the number of inverters that received a limit
+    std::vector<Limit> _limit;
 
     Task _loopTask;
 
@@ -5,6 +5,7 @@
 #include <Hoymiles.h>
 #include <TaskSchedulerDeclarations.h>
 #include <espMqttClient.h>
+#include <vector>
 
 class MqttHandleInverterClass {
 public:
@@ -15,12 +16,13 @@ public:
 
 private:
     void loop();
-    void publishField(std::shared_ptr<InverterAbstract> inv, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId);
+    void publishField(std::shared_ptr<InverterAbstract> inv, const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId);
     void onMqttMessage(const espMqttClientTypes::MessageProperties& properties, const char* topic, const uint8_t* payload, const size_t len, const size_t index, const size_t total);
 
     Task _loopTask;
 
-    uint32_t _lastPublishStats[INV_MAX_COUNT] = { 0 };
+    // By inverter position, grows with the number of inverters
+    std::vector<uint32_t> _lastPublishStats;
 
     FieldId_t _publishFields[14] = {
         FLD_UDC,
@@ -17,6 +17,7 @@
 #include "WebApi_ntp.h"
 #include "WebApi_power.h"
 #include "WebApi_prometheus.h"
+#include "WebApi_rfcapture.h"
 #include "WebApi_security.h"
 #include "WebApi_sunspec.h"
 #include "WebApi_sysstatus.h"
@@ -61,6 +62,7 @@ private:
     WebApiNtpClass _webApiNtp;
     WebApiPowerClass _webApiPower;
     WebApiPrometheusClass _webApiPrometheus;
+    WebApiRfCaptureClass _webApiRfCapture;
     WebApiSecurityClass _webApiSecurity;
     WebApiSunSpecClass _webApiSunSpec;
     WebApiSysstatusClass _webApiSysstatus;
@@ -17,6 +17,7 @@ enum WebApiError {
     DtuInvalidPowerLevel,
     DtuInvalidCmtFrequency,
     DtuInvalidCmtCountry,
+    DtuInvalidPollIntervalBounds,
 
     ConfigBase = 3000,
     ConfigNotDeleted,
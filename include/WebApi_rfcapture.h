@@ -0,0 +1,19 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+#include <TaskSchedulerDeclarations.h>
+
+// capture buffer (bytes) if no size is requested
+#define RF_CAPTURE_DEFAULT_SIZE (32 * 1024)
+#define RF_CAPTURE_DEFAULT_SIZE_PSRAM (1024 * 1024)
+
+class WebApiRfCaptureClass {
+public:
+    void init(AsyncWebServer& server, Scheduler& scheduler);
+
+private:
+    void onRfCaptureStatus(AsyncWebServerRequest* request);
+    void onRfCapturePost(AsyncWebServerRequest* request);
+    void onRfCaptureDownload(AsyncWebServerRequest* request);
+};
@@ -6,6 +6,7 @@
 #include <ESPAsyncWebServer.h>
 #include <Hoymiles.h>
 #include <TaskSchedulerDeclarations.h>
+#include <vector>
 
 class WebApiWsLiveClass {
 public:
@@ -17,7 +18,7 @@ private:
     static void generateInverterChannelJsonResponse(JsonObject& root, std::shared_ptr<InverterAbstract> inv);
     static void generateCommonJsonResponse(JsonVariant& root);
 
-    static void addField(JsonObject& root, std::shared_ptr<InverterAbstract> inv, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, String topic = "");
+    static void addField(JsonObject& root, std::shared_ptr<InverterAbstract> inv, const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, String topic = "");
     static void addTotalField(JsonObject& root, const String& name, const float value, const String& unit, const uint8_t digits);
 
     void onLivedataStatus(AsyncWebServerRequest* request);
@@ -25,7 +26,8 @@ private:
 
     AsyncWebSocket _ws;
 
-    uint32_t _lastPublishStats[INV_MAX_COUNT] = { 0 };
+    // By inverter position, grows with the number of inverters
+    std::vector<uint32_t> _lastPublishStats;
 
     std::mutex _mutex;
 
@@ -82,6 +82,8 @@
 
 #define DTU_SERIAL 0x99978563412U
 #define DTU_POLL_INTERVAL 5U
+#define DTU_POLL_INTERVAL_MIN 0U
+#define DTU_POLL_INTERVAL_MAX 0U
 #define DTU_NRF_PA_LEVEL 0U
 #define DTU_CMT_PA_LEVEL 0
 #define DTU_CMT_FREQUENCY 865000000U
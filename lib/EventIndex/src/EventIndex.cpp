@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "EventIndex.h"
+#include <algorithm>
+
+EventHistoryEntry_t EventIndex::makeEntry(const uint32_t day, const uint32_t secondsOfDay,
+    const int32_t startTime, const int32_t endTime, const uint16_t messageId, const uint8_t messageType)
+{
+    // The timezone offset can move the times out of 0..EVENT_INDEX_SECONDS_PER_DAY
+    const int32_t start = (startTime % EVENT_INDEX_SECONDS_PER_DAY + EVENT_INDEX_SECONDS_PER_DAY) % EVENT_INDEX_SECONDS_PER_DAY;
+    const int32_t end = (endTime % EVENT_INDEX_SECONDS_PER_DAY + EVENT_INDEX_SECONDS_PER_DAY) % EVENT_INDEX_SECONDS_PER_DAY;
+
+    const uint32_t entryDay = static_cast<uint32_t>(start) > secondsOfDay + EVENT_INDEX_FUTURE_TOLERANCE ? day - 1 : day;
+
+    EventHistoryEntry_t entry;
+    entry.Start = entryDay * EVENT_INDEX_SECONDS_PER_DAY + start;
+    entry.EndTime = endTime > 0 ? end : 0;
+    entry.MessageId = messageId;
+    entry.MessageType = messageType;
+    entry.Reserved = 0;
+    return entry;
+}
+
+bool EventIndex::insert(const uint64_t serial, const EventHistoryEntry_t& entry)
+{
+    std::vector<EventHistoryEntry_t>& entries = _entries[serial];
+
+    auto it = std::lower_bound(entries.begin(), entries.end(), entry.Start,
+        [](const EventHistoryEntry_t& e, const uint32_t start) { return e.Start < start; });
+
+    for (auto match = it; match != entries.end() && match->Start == entry.Start; ++match) {
+        if (match->MessageId != entry.MessageId) {
+            continue;
+        }
+        // Known event, only the end of an active event is taken over
+        if (entry.EndTime == 0 || match->EndTime == entry.EndTime) {
+            return false;
+        }
+        match->EndTime = entry.EndTime;
+        return true;
+    }
+
+    entries.insert(it, entry);
+    _count++;
+    return true;
+}
+
+size_t EventIndex::getEvents(const uint64_t serial, const uint32_t from, const uint32_t to,
+    const size_t offset, const size_t limit, std::vector<EventHistoryEntry_t>& page) const
+{
+    page.clear();
+
+    auto inv = _entries.find(serial);
+    if (inv == _entries.end()) {
+        return 0;
+    }
+
+    const std::vector<EventHistoryEntry_t>& entries = inv->second;
+    auto first = std::lower_bound(entries.begin(), entries.end(), from,
+        [](const EventHistoryEntry_t& e, const uint32_t start) { return e.Start < start; });
+    auto last = std::upper_bound(first, entries.end(), to,
+        [](const uint32_t start, const EventHistoryEntry_t& e) { return start < e.Start; });
+
+    const size_t total = last - first;
+    if (offset >= total) {
+        return total;
+    }
+
+    const size_t count = std::min(limit, total - offset);
+    page.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        page.push_back(*(last - 1 - offset - i));
+    }
+
+    return total;
+}
+
+size_t EventIndex::size() const
+{
+    return _count;
+}
+
+std::vector<EventHistoryRecord_t> EventIndex::compact(const size_t maxCount)
+{
+    std::vector<EventHistoryRecord_t> records;
+    records.reserve(_count);
+    for (auto& inv : _entries) {
+        for (auto& entry : inv.second) {
+            records.push_back({ inv.first, entry });
+        }
+    }
+
+    if (records.size() > maxCount) {
+        std::stable_sort(records.begin(), records.end(),
+            [](const EventHistoryRecord_t& a, const EventHistoryRecord_t& b) { return a.Entry.Start < b.Entry.Start; });
+        records.erase(records.begin(), records.end() - maxCount);
+
+        _entries.clear();
+        for (auto& record : records) {
+            _entries[record.Serial].push_back(record.Entry);
+        }
+        _count = records.size();
+    }
+
+    return records;
+}
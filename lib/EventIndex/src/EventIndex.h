@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#define EVENT_INDEX_SECONDS_PER_DAY 86400
+// events which start up to this many seconds (clock drift) after now are still taken as today
+#define EVENT_INDEX_FUTURE_TOLERANCE (5 * 60)
+
+typedef struct {
+    uint32_t Start; // Local time in seconds since 1970
+    uint32_t EndTime; // Local seconds of the day, 0 while active
+    uint16_t MessageId;
+    uint8_t MessageType; // AlarmMessageType_t
+    uint8_t Reserved;
+} EventHistoryEntry_t;
+
+typedef struct {
+    uint64_t Serial;
+    EventHistoryEntry_t Entry;
+} EventHistoryRecord_t;
+
+/*
+ * Events of all inverters, sorted by start per inverter. Neither accesses the
+ * clock nor the file system and is not thread safe, see EventHistoryClass.
+ */
+class EventIndex {
+public:
+    // Converts an alarm log entry, which only reports the time of day, to the local day
+    // and secondsOfDay of now. Events later than now were logged before midnight.
+    static EventHistoryEntry_t makeEntry(const uint32_t day, const uint32_t secondsOfDay,
+        const int32_t startTime, const int32_t endTime, const uint16_t messageId, const uint8_t messageType);
+
+    // Returns false if the event is already known with the same end
+    bool insert(const uint64_t serial, const EventHistoryEntry_t& entry);
+
+    // Number of events of the inverter between from and to (inclusive). Copies up to limit of them,
+    // newest first and skipping the first offset, into page.
+    size_t getEvents(const uint64_t serial, const uint32_t from, const uint32_t to,
+        const size_t offset, const size_t limit, std::vector<EventHistoryEntry_t>& page) const;
+
+    size_t size() const;
+
+    // Drops the oldest events above maxCount and returns one record per remaining event
+    std::vector<EventHistoryRecord_t> compact(const size_t maxCount);
+
+private:
+    std::map<uint64_t, std::vector<EventHistoryEntry_t>> _entries;
+    size_t _count = 0;
+};
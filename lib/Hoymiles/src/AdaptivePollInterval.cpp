@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "AdaptivePollInterval.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <cmath>
+
+void AdaptivePollInterval::setBounds(const uint32_t minInterval, const uint32_t maxInterval)
+{
+    _minInterval = minInterval;
+    _maxInterval = std::max(minInterval, maxInterval);
+    setInterval(_interval, _unreachable ? getBackoffMax() : _maxInterval);
+}
+
+uint32_t AdaptivePollInterval::getMinInterval() const
+{
+    return _minInterval;
+}
+
+uint32_t AdaptivePollInterval::getMaxInterval() const
+{
+    return _maxInterval;
+}
+
+uint32_t AdaptivePollInterval::getInterval() const
+{
+    return _interval;
+}
+
+bool AdaptivePollInterval::isDue() const
+{
+    return !_polled || millis() - _lastPoll >= _interval;
+}
+
+void AdaptivePollInterval::update(const bool reachable, const uint32_t lastUpdate, const float powerAc, const float powerDc)
+{
+    _lastPoll = millis();
+    _polled = true;
+
+    if (!reachable) {
+        // Back off exponentially, it is most likely dark or the inverter is switched off
+        setInterval(_unreachable ? _interval * 2 : std::max<uint32_t>(_interval * 2, POLL_ADAPTIVE_BACKOFF_START), getBackoffMax());
+        _unreachable = true;
+        return;
+    }
+
+    if (_unreachable) {
+        _unreachable = false;
+        setInterval(_minInterval, _maxInterval);
+    }
+
+    // Only evaluate new data, a failed request does not tell anything about the power
+    if (lastUpdate == _lastSample) {
+        return;
+    }
+
+    const bool firstSample = _lastSample == 0;
+    const float change = std::max(getChange(_lastPowerAc, powerAc), getChange(_lastPowerDc, powerDc));
+    _lastSample = lastUpdate;
+    _lastPowerAc = powerAc;
+    _lastPowerDc = powerDc;
+
+    if (firstSample) {
+        return;
+    }
+
+    if (change > POLL_ADAPTIVE_CHANGE_FAST) {
+        setInterval(_interval / 2, _maxInterval);
+    } else if (change < POLL_ADAPTIVE_CHANGE_STABLE) {
+        setInterval(_interval + std::max<uint32_t>(_interval / 2, 1000), _maxInterval);
+    }
+}
+
+float AdaptivePollInterval::getChange(const float previous, const float current)
+{
+    return std::fabs(current - previous) / std::max(std::fabs(previous), POLL_ADAPTIVE_POWER_FLOOR);
+}
+
+uint32_t AdaptivePollInterval::getBackoffMax() const
+{
+    // Backoff is disabled together with the adaptive interval
+    return _maxInterval > 0 ? std::max<uint32_t>(_maxInterval, POLL_ADAPTIVE_BACKOFF_MAX) : 0;
+}
+
+void AdaptivePollInterval::setInterval(const uint32_t interval, const uint32_t maxInterval)
+{
+    _interval = std::min(std::max(interval, _minInterval), maxInterval);
+}
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+// relative power change between two polls above which the interval is halved
+#ifndef POLL_ADAPTIVE_CHANGE_FAST
+#define POLL_ADAPTIVE_CHANGE_FAST 0.05f
+#endif
+// relative power change between two polls below which the interval is increased
+#ifndef POLL_ADAPTIVE_CHANGE_STABLE
+#define POLL_ADAPTIVE_CHANGE_STABLE 0.01f
+#endif
+// changes are related to at least this power (W), avoids fast polling at dawn
+#ifndef POLL_ADAPTIVE_POWER_FLOOR
+#define POLL_ADAPTIVE_POWER_FLOOR 20.0f
+#endif
+// first interval (ms) after an inverter became unreachable, doubled on every further poll
+#ifndef POLL_ADAPTIVE_BACKOFF_START
+#define POLL_ADAPTIVE_BACKOFF_START 2000
+#endif
+// unreachable inverters are polled at least this often (ms) even if the maximum interval is shorter.
+// A poll of an unreachable inverter blocks the radio for several seconds of retries.
+#ifndef POLL_ADAPTIVE_BACKOFF_MAX
+#define POLL_ADAPTIVE_BACKOFF_MAX (5 * 60 * 1000)
+#endif
+
+/*
+ * Minimum time between two polls of one inverter. Shortened while the power
+ * changes quickly, lengthened while it is stable and backed off
+ * exponentially while the inverter is unreachable. Always within the bounds
+ * except for the backoff which may exceed the maximum up to
+ * POLL_ADAPTIVE_BACKOFF_MAX.
+ */
+class AdaptivePollInterval {
+public:
+    void setBounds(const uint32_t minInterval, const uint32_t maxInterval);
+    uint32_t getMinInterval() const;
+    uint32_t getMaxInterval() const;
+
+    // Current interval in ms
+    uint32_t getInterval() const;
+    bool isDue() const;
+
+    // Has to be called for every poll with the latest known state of the inverter
+    void update(const bool reachable, const uint32_t lastUpdate, const float powerAc, const float powerDc);
+
+private:
+    static float getChange(const float previous, const float current);
+    uint32_t getBackoffMax() const;
+    void setInterval(const uint32_t interval, const uint32_t maxInterval);
+
+    uint32_t _minInterval = 0;
+    uint32_t _maxInterval = 0;
+    uint32_t _interval = 0;
+
+    uint32_t _lastPoll = 0;
+    bool _polled = false;
+
+    uint32_t _lastSample = 0;
+    float _lastPowerAc = 0;
+    float _lastPowerDc = 0;
+    bool _unreachable = false;
+};
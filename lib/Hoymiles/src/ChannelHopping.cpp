@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "ChannelHopping.h"
+#include "inverters/InverterAbstract.h"
+#include <algorithm>
+
+static constexpr uint8_t channelList[CHANNEL_QUALITY_CHANNELS] = { 3, 23, 40, 61, 75 };
+
+uint8_t ChannelHopping::getTxChannel(InverterAbstract* inv)
+{
+    if (_inverter != inv) {
+        finishRxPeriod();
+        _inverter = inv;
+    }
+
+    if (_adaptive && _inverter != nullptr) {
+        _txIndex = _inverter->ChannelQuality()->selectTxChannel();
+    } else if (++_txIndex >= CHANNEL_QUALITY_CHANNELS) {
+        _txIndex = 0;
+    }
+
+    _txMask |= 1 << _txIndex;
+    return channelList[_txIndex];
+}
+
+uint8_t ChannelHopping::getRxChannel()
+{
+    if (!_adaptive) {
+        if (++_rxIndex >= CHANNEL_QUALITY_CHANNELS) {
+            _rxIndex = 0;
+        }
+    } else if (_inverter != nullptr) {
+        _rxIndex = _inverter->ChannelQuality()->selectRxChannel();
+    } else {
+        _rxIndex = _totals.selectRxChannel();
+    }
+
+    if (_inverter != nullptr) {
+        _rxSlots[_rxIndex]++;
+    }
+    return channelList[_rxIndex];
+}
+
+void ChannelHopping::addRxFragment(const InverterAbstract& inv, const fragment_t& fragment)
+{
+    if (_inverter != &inv) {
+        return;
+    }
+
+    const uint8_t index = getChannelIndex(fragment.channel);
+    if (index >= CHANNEL_QUALITY_CHANNELS) {
+        return;
+    }
+
+    _answered = true;
+    _rxFragments[index]++;
+    _inverter->ChannelQuality()->addRssi(index, fragment.rssi);
+    _totals.addRssi(index, fragment.rssi);
+}
+
+void ChannelHopping::finishRxPeriod()
+{
+    if (_inverter == nullptr) {
+        return;
+    }
+
+    ChannelQualityTable* quality = _inverter->ChannelQuality();
+    for (uint8_t i = 0; i < CHANNEL_QUALITY_CHANNELS; i++) {
+        if (_txMask & (1 << i)) {
+            quality->addTxResult(i, _answered);
+            _totals.addTxResult(i, _answered);
+        }
+        quality->addRxResult(i, _rxSlots[i], _rxFragments[i]);
+        _totals.addRxResult(i, _rxSlots[i], _rxFragments[i]);
+    }
+
+    _inverter = nullptr;
+    _txMask = 0;
+    std::fill(_rxSlots, _rxSlots + CHANNEL_QUALITY_CHANNELS, 0);
+    std::fill(_rxFragments, _rxFragments + CHANNEL_QUALITY_CHANNELS, 0);
+    _answered = false;
+}
+
+void ChannelHopping::removeInverter(const InverterAbstract& inv)
+{
+    if (_inverter == &inv) {
+        finishRxPeriod();
+    }
+}
+
+void ChannelHopping::setAdaptive(const bool adaptive)
+{
+    _adaptive = adaptive;
+}
+
+bool ChannelHopping::isAdaptive() const
+{
+    return _adaptive;
+}
+
+const ChannelQualityTable& ChannelHopping::getTotals() const
+{
+    return _totals;
+}
+
+uint8_t ChannelHopping::getChannel(const uint8_t index)
+{
+    return channelList[std::min<uint8_t>(index, CHANNEL_QUALITY_CHANNELS - 1)];
+}
+
+uint8_t ChannelHopping::getChannelIndex(const uint8_t channel)
+{
+    return std::find(channelList, channelList + CHANNEL_QUALITY_CHANNELS, channel) - channelList;
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "ChannelQualityTable.h"
+#include "types.h"
+
+class InverterAbstract;
+
+/*
+ * Selects the NRF channels used for transmitting and listening. While an
+ * answer is expected the channels are selected by the link quality measured
+ * with the target inverter, otherwise by the quality of all inverters. The
+ * result of every rx period is added to both tables.
+ */
+class ChannelHopping {
+public:
+    // Channel of the next transmission to inv, starts a rx period if none is running
+    uint8_t getTxChannel(InverterAbstract* inv);
+    // Channel of the next rx slot
+    uint8_t getRxChannel();
+
+    // Has to be called for every received fragment with a valid crc
+    void addRxFragment(const InverterAbstract& inv, const fragment_t& fragment);
+    void finishRxPeriod();
+    // Has to be called before inv is deleted
+    void removeInverter(const InverterAbstract& inv);
+
+    // Plain round robin through all channels if disabled
+    void setAdaptive(const bool adaptive);
+    bool isAdaptive() const;
+
+    const ChannelQualityTable& getTotals() const;
+
+    static uint8_t getChannel(const uint8_t index);
+    // Returns CHANNEL_QUALITY_CHANNELS for unknown channels
+    static uint8_t getChannelIndex(const uint8_t channel);
+
+private:
+    ChannelQualityTable _totals;
+    bool _adaptive = true;
+
+    // Current rx period
+    InverterAbstract* _inverter = nullptr;
+    uint8_t _txMask = 0;
+    uint16_t _rxSlots[CHANNEL_QUALITY_CHANNELS] = {};
+    uint16_t _rxFragments[CHANNEL_QUALITY_CHANNELS] = {};
+    bool _answered = false;
+
+    uint8_t _txIndex = 0;
+    uint8_t _rxIndex = 0;
+};
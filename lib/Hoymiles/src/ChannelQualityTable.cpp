@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "ChannelQualityTable.h"
+#include <algorithm>
+
+ChannelQualityTable::ChannelQualityTable()
+{
+    clear();
+}
+
+void ChannelQualityTable::addTxResult(const uint8_t index, const bool answered)
+{
+    if (index >= CHANNEL_QUALITY_CHANNELS) {
+        return;
+    }
+
+    ChannelQualityEntry_t& entry = _entries[index];
+    entry.txCount++;
+    entry.txAnswered += answered ? 1 : 0;
+    entry.txRate += CHANNEL_QUALITY_ALPHA * ((answered ? 1.0f : 0.0f) - entry.txRate);
+}
+
+void ChannelQualityTable::addRxResult(const uint8_t index, const uint16_t slots, const uint16_t fragments)
+{
+    if (index >= CHANNEL_QUALITY_CHANNELS || slots == 0) {
+        return;
+    }
+
+    ChannelQualityEntry_t& entry = _entries[index];
+    entry.rxSlots += slots;
+    entry.rxFragments += fragments;
+    const float rate = std::min(1.0f, static_cast<float>(fragments) / slots);
+    entry.rxRate += CHANNEL_QUALITY_ALPHA * (rate - entry.rxRate);
+}
+
+void ChannelQualityTable::addRssi(const uint8_t index, const int8_t rssi)
+{
+    if (index >= CHANNEL_QUALITY_CHANNELS) {
+        return;
+    }
+
+    ChannelQualityEntry_t& entry = _entries[index];
+    if (entry.rxFragments == 0 && entry.rssi == 0) {
+        entry.rssi = rssi;
+    } else {
+        entry.rssi += static_cast<int8_t>(CHANNEL_QUALITY_ALPHA * (rssi - entry.rssi));
+    }
+}
+
+void ChannelQualityTable::clear()
+{
+    for (auto& entry : _entries) {
+        // Unknown channels are assumed to be good, they are tried first
+        entry = {};
+        entry.txRate = 1;
+        entry.rxRate = 1;
+    }
+    std::fill(_txCredit, _txCredit + CHANNEL_QUALITY_CHANNELS, 0);
+    std::fill(_rxCredit, _rxCredit + CHANNEL_QUALITY_CHANNELS, 0);
+}
+
+uint8_t ChannelQualityTable::selectTxChannel()
+{
+    float weights[CHANNEL_QUALITY_CHANNELS];
+    for (uint8_t i = 0; i < CHANNEL_QUALITY_CHANNELS; i++) {
+        weights[i] = _entries[i].txRate;
+    }
+    return select(_txCredit, weights);
+}
+
+uint8_t ChannelQualityTable::selectRxChannel()
+{
+    float weights[CHANNEL_QUALITY_CHANNELS];
+    for (uint8_t i = 0; i < CHANNEL_QUALITY_CHANNELS; i++) {
+        weights[i] = _entries[i].rxRate;
+    }
+    return select(_rxCredit, weights);
+}
+
+const ChannelQualityEntry_t& ChannelQualityTable::getEntry(const uint8_t index) const
+{
+    return _entries[std::min<uint8_t>(index, CHANNEL_QUALITY_CHANNELS - 1)];
+}
+
+uint8_t ChannelQualityTable::select(float credit[], const float weights[])
+{
+    // Smooth weighted round robin: equal weights result in a plain round robin
+    float total = 0;
+    uint8_t best = 0;
+    for (uint8_t i = 0; i < CHANNEL_QUALITY_CHANNELS; i++) {
+        const float weight = std::max(weights[i], CHANNEL_QUALITY_EXPLORE_WEIGHT);
+        credit[i] += weight;
+        total += weight;
+        if (credit[i] > credit[best]) {
+            best = i;
+        }
+    }
+    credit[best] -= total;
+    return best;
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+// amount of channels used by the NRF hopping lists
+#define CHANNEL_QUALITY_CHANNELS 5
+
+// weight of a new result in the moving success rates (0..1)
+#ifndef CHANNEL_QUALITY_ALPHA
+#define CHANNEL_QUALITY_ALPHA 0.25f
+#endif
+// minimum selection weight of a channel, bad channels are still explored from time to time
+#ifndef CHANNEL_QUALITY_EXPLORE_WEIGHT
+#define CHANNEL_QUALITY_EXPLORE_WEIGHT 0.05f
+#endif
+
+struct ChannelQualityEntry_t {
+    uint32_t txCount; // transmissions on this channel
+    uint32_t txAnswered; // transmissions answered by at least one fragment
+    uint32_t rxSlots; // rx slots listened on this channel while an answer was expected
+    uint32_t rxFragments; // fragments received on this channel
+    float txRate; // moving rate of answered transmissions (0..1)
+    float rxRate; // moving amount of fragments per rx slot (0..1)
+    int8_t rssi; // moving average of the rssi of the received fragments (dBm)
+};
+
+/*
+ * Link quality per RF channel. The moving success rates are used as weights
+ * of a smooth weighted round robin, good channels are selected more often
+ * but every channel keeps a minimum share to detect when it recovers.
+ */
+class ChannelQualityTable {
+public:
+    ChannelQualityTable();
+
+    void addTxResult(const uint8_t index, const bool answered);
+    // slots: rx slots listened on the channel, fragments: fragments received within them
+    void addRxResult(const uint8_t index, const uint16_t slots, const uint16_t fragments);
+    void addRssi(const uint8_t index, const int8_t rssi);
+    void clear();
+
+    // Returns the index of the channel used for the next transmission / rx slot
+    uint8_t selectTxChannel();
+    uint8_t selectRxChannel();
+
+    const ChannelQualityEntry_t& getEntry(const uint8_t index) const;
+
+private:
+    static uint8_t select(float credit[], const float weights[]);
+
+    ChannelQualityEntry_t _entries[CHANNEL_QUALITY_CHANNELS];
+    float _txCredit[CHANNEL_QUALITY_CHANNELS] = {};
+    float _rxCredit[CHANNEL_QUALITY_CHANNELS] = {};
+};
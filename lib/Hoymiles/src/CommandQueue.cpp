@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "CommandQueue.h"
+
+static const uint32_t maxWait[CommandPriority_Max] = {
+    UINT32_MAX, // Control commands always have the highest priority
+    COMMAND_MAX_WAIT_REALTIME,
+    COMMAND_MAX_WAIT_METADATA,
+};
+
+CommandQueue::CommandQueue()
+{
+    for (uint8_t i = 0; i < COMMAND_POOL_SIZE; i++) {
+        _nextFree[i] = i + 1 < COMMAND_POOL_SIZE ? i + 1 : -1;
+    }
+}
+
+CommandQueue::~CommandQueue()
+{
+    while (size() > 0) {
+        pop();
+    }
+}
+
+void CommandQueue::release(CommandAbstract* cmd)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    releaseSlot(cmd);
+}
+
+void CommandQueue::push(CommandAbstract* cmd)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    List_t& queue = _queues[cmd->getPriority()];
+    cmd->_next = nullptr;
+    cmd->_queueTime = millis();
+
+    const uint16_t key = cmd->getCoalesceKey();
+    if (key != 0) {
+        for (CommandAbstract** link = &queue.head; *link != nullptr; link = &(*link)->_next) {
+            CommandAbstract* queued = *link;
+            if (queued->getCoalesceKey() != key || queued->getTargetAddress() != cmd->getTargetAddress()) {
+                continue;
+            }
+
+            // Take over the position and the age of the replaced command
+            cmd->_next = queued->_next;
+            cmd->_queueTime = queued->_queueTime;
+            *link = cmd;
+            if (queue.tail == queued) {
+                queue.tail = cmd;
+            }
+            releaseSlot(queued);
+            _coalescedCount++;
+            return;
+        }
+    }
+
+    if (queue.tail == nullptr) {
+        queue.head = cmd;
+    } else {
+        queue.tail->_next = cmd;
+    }
+    queue.tail = cmd;
+    _size++;
+}
+
+CommandAbstract* CommandQueue::front()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_active == nullptr) {
+        _active = activateNext();
+    }
+    return _active;
+}
+
+void CommandQueue::pop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_active == nullptr) {
+        _active = activateNext();
+        if (_active == nullptr) {
+            return;
+        }
+    }
+
+    releaseSlot(_active);
+    _active = nullptr;
+    _size--;
+}
+
+size_t CommandQueue::size() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+uint8_t CommandQueue::getPoolUsed() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _used;
+}
+
+uint8_t CommandQueue::getPoolHighWaterMark() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _highWaterMark;
+}
+
+uint32_t CommandQueue::getPoolExhaustedCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _exhaustedCount;
+}
+
+uint32_t CommandQueue::getCoalescedCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _coalescedCount;
+}
+
+CommandWaitStatistics_t CommandQueue::getWaitStatistics(const CommandPriority_t priority) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _waitStatistics[priority];
+}
+
+CommandAbstract* CommandQueue::activateNext()
+{
+    const uint32_t now = millis();
+
+    // Oldest command which exceeded its max wait time
+    int8_t prio = -1;
+    uint32_t maxOverdue = 0;
+    for (uint8_t i = 0; i < CommandPriority_Max; i++) {
+        const CommandAbstract* head = _queues[i].head;
+        if (head == nullptr || now - head->_queueTime <= maxWait[i]) {
+            continue;
+        }
+        const uint32_t overdue = now - head->_queueTime - maxWait[i];
+        if (prio < 0 || overdue > maxOverdue) {
+            prio = i;
+            maxOverdue = overdue;
+        }
+    }
+
+    // Otherwise the highest priority
+    for (uint8_t i = 0; i < CommandPriority_Max && prio < 0; i++) {
+        if (_queues[i].head != nullptr) {
+            prio = i;
+        }
+    }
+    if (prio < 0) {
+        return nullptr;
+    }
+
+    bool promoted = false;
+    for (uint8_t i = 0; i < prio; i++) {
+        promoted |= _queues[i].head != nullptr;
+    }
+
+    List_t& queue = _queues[prio];
+    CommandAbstract* cmd = queue.head;
+    queue.head = cmd->_next;
+    if (queue.head == nullptr) {
+        queue.tail = nullptr;
+    }
+    cmd->_next = nullptr;
+
+    const uint32_t wait = now - cmd->_queueTime;
+    CommandWaitStatistics_t& stats = _waitStatistics[prio];
+    stats.count++;
+    stats.totalWait += wait;
+    stats.maxWait = std::max(stats.maxWait, wait);
+    if (promoted) {
+        stats.promoted++;
+    }
+
+    return cmd;
+}
+
+int8_t CommandQueue::takeSlot()
+{
+    const int8_t slot = _firstFree;
+    if (slot < 0) {
+        _exhaustedCount++;
+        return -1;
+    }
+
+    _firstFree = _nextFree[slot];
+    _used++;
+    _highWaterMark = std::max(_highWaterMark, _used);
+    return slot;
+}
+
+void CommandQueue::releaseSlot(CommandAbstract* cmd)
+{
+    const int8_t slot = cmd->_poolSlot;
+    cmd->~CommandAbstract();
+
+    _nextFree[slot] = _firstFree;
+    _firstFree = slot;
+    _used--;
+}
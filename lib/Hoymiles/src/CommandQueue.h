@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "commands/ActivePowerControlCommand.h"
+#include "commands/AlarmDataCommand.h"
+#include "commands/ChannelChangeCommand.h"
+#include "commands/CommandAbstract.h"
+#include "commands/DevInfoAllCommand.h"
+#include "commands/DevInfoSimpleCommand.h"
+#include "commands/GridOnProFilePara.h"
+#include "commands/ParaSetCommand.h"
+#include "commands/PowerControlCommand.h"
+#include "commands/RealTimeRunDataCommand.h"
+#include "commands/SystemConfigParaCommand.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <mutex>
+#include <new>
+
+// number of command objects per radio which can be prepared or queued at the same time
+#ifndef COMMAND_POOL_SIZE
+#define COMMAND_POOL_SIZE 24
+#endif
+
+static_assert(COMMAND_POOL_SIZE > 0 && COMMAND_POOL_SIZE <= INT8_MAX, "Invalid COMMAND_POOL_SIZE");
+
+// queued commands waiting longer than this (ms) are sent before commands of a higher priority
+#ifndef COMMAND_MAX_WAIT_REALTIME
+#define COMMAND_MAX_WAIT_REALTIME 5000
+#endif
+#ifndef COMMAND_MAX_WAIT_METADATA
+#define COMMAND_MAX_WAIT_METADATA 15000
+#endif
+
+struct CommandWaitStatistics_t {
+    uint32_t count; // commands which left the queue
+    uint64_t totalWait; // ms, 32 bits overflow after 49 days of summed waits
+    uint32_t maxWait; // ms
+    uint32_t promoted; // commands sent before higher priority ones because of their age
+};
+
+/*
+ * Fixed pool of command objects combined with one FIFO per priority.
+ * Commands are constructed in place in a free slot by allocate() and are
+ * linked intrusively. No heap memory is used after construction.
+ * All methods can be called from any task.
+ */
+class CommandQueue {
+public:
+    CommandQueue();
+    ~CommandQueue();
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    // Returns a new command or nullptr if all slots are in use.
+    // The command has to be passed to push() or release().
+    template <typename T>
+    T* allocate()
+    {
+        static_assert(sizeof(T) <= sizeof(Slot_t), "Command does not fit into a pool slot");
+        static_assert(alignof(T) <= alignof(Slot_t), "Command alignment exceeds pool slot alignment");
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        const int8_t slot = takeSlot();
+        if (slot < 0) {
+            return nullptr;
+        }
+
+        T* cmd = new (&_slots[slot]) T();
+        cmd->_poolSlot = slot;
+        return cmd;
+    }
+
+    // Returns a command which was not pushed back to the pool
+    void release(CommandAbstract* cmd);
+
+    // Replaces a queued command with the same target and coalesce key or appends
+    // the command to the queue of its priority.
+    void push(CommandAbstract* cmd);
+
+    // Returns the active command. If there is none, the next one is taken from the queues:
+    // The oldest command exceeding the max wait time of its priority, otherwise the
+    // first command of the highest priority. The active command is never replaced.
+    CommandAbstract* front();
+    // Returns the active command to the pool
+    void pop();
+    // Amount of queued commands including the active one
+    size_t size() const;
+
+    static constexpr uint8_t getPoolSize()
+    {
+        return COMMAND_POOL_SIZE;
+    }
+    uint8_t getPoolUsed() const;
+    uint8_t getPoolHighWaterMark() const;
+    uint32_t getPoolExhaustedCount() const;
+    uint32_t getCoalescedCount() const;
+    CommandWaitStatistics_t getWaitStatistics(const CommandPriority_t priority) const;
+
+private:
+    union Slot_t {
+        alignas(ActivePowerControlCommand) uint8_t activePowerControl[sizeof(ActivePowerControlCommand)];
+        alignas(AlarmDataCommand) uint8_t alarmData[sizeof(AlarmDataCommand)];
+        alignas(ChannelChangeCommand) uint8_t channelChange[sizeof(ChannelChangeCommand)];
+        alignas(DevInfoAllCommand) uint8_t devInfoAll[sizeof(DevInfoAllCommand)];
+        alignas(DevInfoSimpleCommand) uint8_t devInfoSimple[sizeof(DevInfoSimpleCommand)];
+        alignas(GridOnProFilePara) uint8_t gridOnProFilePara[sizeof(GridOnProFilePara)];
+        alignas(ParaSetCommand) uint8_t paraSet[sizeof(ParaSetCommand)];
+        alignas(PowerControlCommand) uint8_t powerControl[sizeof(PowerControlCommand)];
+        alignas(RealTimeRunDataCommand) uint8_t realTimeRunData[sizeof(RealTimeRunDataCommand)];
+        alignas(SystemConfigParaCommand) uint8_t systemConfigPara[sizeof(SystemConfigParaCommand)];
+    };
+
+    int8_t takeSlot();
+    void releaseSlot(CommandAbstract* cmd);
+    CommandAbstract* activateNext();
+
+    Slot_t _slots[COMMAND_POOL_SIZE];
+    int8_t _nextFree[COMMAND_POOL_SIZE];
+    int8_t _firstFree = 0;
+
+    struct List_t {
+        CommandAbstract* head = nullptr;
+        CommandAbstract* tail = nullptr;
+    };
+    List_t _queues[CommandPriority_Max];
+    CommandAbstract* _active = nullptr;
+    size_t _size = 0;
+
+    uint8_t _used = 0;
+    uint8_t _highWaterMark = 0;
+    uint32_t _exhaustedCount = 0;
+    uint32_t _coalescedCount = 0;
+    CommandWaitStatistics_t _waitStatistics[CommandPriority_Max] = {};
+
+    mutable std::mutex _mutex;
+};
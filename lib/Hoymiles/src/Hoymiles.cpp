@@ -16,6 +16,7 @@
 #include "inverters/HM_2CH.h"
 #include "inverters/HM_4CH.h"
 #include <Arduino.h>
+#include <algorithm>
 
 HoymilesClass Hoymiles;
 
@@ -42,89 +43,26 @@ void HoymilesClass::loop()
     _radioNrf->loop();
     _radioCmt->loop();
 
+    // Radios attached from outside (e.g. simulation) are driven by the same loop
+    for (auto& scheduler : _pollSchedulers) {
+        if (scheduler.radio != _radioNrf.get() && scheduler.radio != _radioCmt.get()) {
+            scheduler.radio->loop();
+        }
+    }
+
     if (getNumInverters() == 0) {
         return;
     }
 
-    if (millis() - _lastPoll > (_pollInterval * 1000)) {
-        static uint8_t inverterPos = 0;
-
-        std::shared_ptr<InverterAbstract> iv = getInverterByPos(inverterPos);
-        if ((iv == nullptr) || ((iv != nullptr) && (!iv->getRadio()->isInitialized()))) {
-            if (++inverterPos >= getNumInverters()) {
-                inverterPos = 0;
-            }
+    // Every radio has its own round robin so that both radios are busy at the same time
+    for (auto& scheduler : _pollSchedulers) {
+        if (millis() - scheduler.lastPoll > (_pollInterval * 1000)) {
+            pollNextInverter(scheduler);
         }
+    }
 
-        if (iv != nullptr && iv->getRadio()->isInitialized() && iv->getRadio()->isQueueEmpty()) {
-
-            if (iv->getZeroValuesIfUnreachable() && !iv->isReachable()) {
-                iv->Statistics()->zeroRuntimeData();
-            }
-
-            if (iv->getEnablePolling() || iv->getEnableCommands()) {
-                _messageOutput->print("Fetch inverter: ");
-                _messageOutput->println(iv->serial(), HEX);
-
-                if (!iv->isReachable()) {
-                    iv->sendChangeChannelRequest();
-                }
-
-                iv->sendStatsRequest();
-
-                // Fetch event log
-                const bool force = iv->EventLog()->getLastAlarmRequestSuccess() == CMD_NOK;
-                iv->sendAlarmLogRequest(force);
-
-                // Fetch limit
-                if (((millis() - iv->SystemConfigPara()->getLastUpdateRequest() > HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL)
-                        && (millis() - iv->SystemConfigPara()->getLastUpdateCommand() > HOY_SYSTEM_CONFIG_PARA_POLL_MIN_DURATION))) {
-                    _messageOutput->println("Request SystemConfigPara");
-                    iv->sendSystemConfigParaRequest();
-                }
-
-                // Set limit if required
-                if (iv->SystemConfigPara()->getLastLimitCommandSuccess() == CMD_NOK) {
-                    _messageOutput->println("Resend ActivePowerControl");
-                    iv->resendActivePowerControlRequest();
-                }
-
-                // Set power status if required
-                if (iv->PowerCommand()->getLastPowerCommandSuccess() == CMD_NOK) {
-                    _messageOutput->println("Resend PowerCommand");
-                    iv->resendPowerControlRequest();
-                }
-
-                // Fetch dev info (but first fetch stats)
-                if (iv->Statistics()->getLastUpdate() > 0) {
-                    const bool invalidDevInfo = !iv->DevInfo()->containsValidData()
-                        && iv->DevInfo()->getLastUpdateAll() > 0
-                        && iv->DevInfo()->getLastUpdateSimple() > 0;
-
-                    if (invalidDevInfo) {
-                        _messageOutput->println("DevInfo: No Valid Data");
-                    }
-
-                    if ((iv->DevInfo()->getLastUpdateAll() == 0)
-                        || (iv->DevInfo()->getLastUpdateSimple() == 0)
-                        || invalidDevInfo) {
-                        _messageOutput->println("Request device info");
-                        iv->sendDevInfoRequest();
-                    }
-                }
-
-                // Fetch grid profile
-                if (iv->Statistics()->getLastUpdate() > 0 && (iv->GridProfile()->getLastUpdate() == 0 || !iv->GridProfile()->containsValidData())) {
-                    iv->sendGridOnProFileParaRequest();
-                }
-
-                _lastPoll = millis();
-            }
-
-            if (++inverterPos >= getNumInverters()) {
-                inverterPos = 0;
-            }
-        }
+    if (millis() - _lastHousekeeping > (_pollInterval * 1000)) {
+        _lastHousekeeping = millis();
 
         // Perform housekeeping of all inverters on day change
         const int8_t currentWeekDay = Utils::getWeekDay();
@@ -149,37 +87,145 @@ void HoymilesClass::loop()
     }
 }
 
+void HoymilesClass::pollNextInverter(PollScheduler_t& scheduler)
+{
+    if (!scheduler.radio->isInitialized() || !scheduler.radio->isQueueEmpty()) {
+        return;
+    }
+
+    // Find the next inverter which is attached to this radio
+    for (size_t i = 0; i < _inverters.size(); i++) {
+        if (scheduler.inverterPos >= _inverters.size()) {
+            scheduler.inverterPos = 0;
+        }
+
+        std::shared_ptr<InverterAbstract> iv = _inverters[scheduler.inverterPos++];
+        if (iv->getRadio() != scheduler.radio || !iv->PollInterval()->isDue()) {
+            continue;
+        }
+
+        if (pollInverter(iv)) {
+            scheduler.lastPoll = millis();
+        }
+        return;
+    }
+}
+
+bool HoymilesClass::pollInverter(std::shared_ptr<InverterAbstract> iv)
+{
+    if (iv->getZeroValuesIfUnreachable() && !iv->isReachable()) {
+        iv->Statistics()->zeroRuntimeData();
+    }
+
+    if (!iv->getEnablePolling() && !iv->getEnableCommands()) {
+        return false;
+    }
+
+    // isReachable() is false while polling is disabled, that is no reason to back off the commands
+    iv->PollInterval()->update(iv->getEnablePolling() ? iv->isReachable() : true,
+        iv->Statistics()->getLastUpdate(),
+        iv->Statistics()->getChannelFieldValue(TYPE_AC, CH0, FLD_PAC),
+        iv->Statistics()->getChannelFieldValue(TYPE_INV, CH0, FLD_PDC));
+
+    HOY_LOG(SCHEDULER, INFO, "Fetch inverter: %X%08X\r\n",
+        static_cast<uint32_t>(iv->serial() >> 32), static_cast<uint32_t>(iv->serial()));
+
+    if (!iv->isReachable()) {
+        iv->sendChangeChannelRequest();
+    }
+
+    iv->sendStatsRequest();
+
+    // Fetch event log
+    const bool force = iv->EventLog()->getLastAlarmRequestSuccess() == CMD_NOK;
+    iv->sendAlarmLogRequest(force);
+
+    // Fetch limit
+    if (((millis() - iv->SystemConfigPara()->getLastUpdateRequest() > HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL)
+            && (millis() - iv->SystemConfigPara()->getLastUpdateCommand() > HOY_SYSTEM_CONFIG_PARA_POLL_MIN_DURATION))) {
+        HOY_LOG(SCHEDULER, INFO, "Request SystemConfigPara\r\n");
+        iv->sendSystemConfigParaRequest();
+    }
+
+    // Set limit if required
+    if (iv->SystemConfigPara()->getLastLimitCommandSuccess() == CMD_NOK) {
+        HOY_LOG(SCHEDULER, INFO, "Resend ActivePowerControl\r\n");
+        iv->resendActivePowerControlRequest();
+    }
+
+    // Set power status if required
+    if (iv->PowerCommand()->getLastPowerCommandSuccess() == CMD_NOK) {
+        HOY_LOG(SCHEDULER, INFO, "Resend PowerCommand\r\n");
+        iv->resendPowerControlRequest();
+    }
+
+    // Fetch dev info (but first fetch stats)
+    if (iv->Statistics()->getLastUpdate() > 0) {
+        const bool invalidDevInfo = !iv->DevInfo()->containsValidData()
+            && iv->DevInfo()->getLastUpdateAll() > 0
+            && iv->DevInfo()->getLastUpdateSimple() > 0;
+
+        if (invalidDevInfo) {
+            HOY_LOG(SCHEDULER, WARN, "DevInfo: No Valid Data\r\n");
+        }
+
+        if ((iv->DevInfo()->getLastUpdateAll() == 0)
+            || (iv->DevInfo()->getLastUpdateSimple() == 0)
+            || invalidDevInfo) {
+            HOY_LOG(SCHEDULER, INFO, "Request device info\r\n");
+            iv->sendDevInfoRequest();
+        }
+    }
+
+    // Fetch grid profile
+    if (iv->Statistics()->getLastUpdate() > 0 && (iv->GridProfile()->getLastUpdate() == 0 || !iv->GridProfile()->containsValidData())) {
+        iv->sendGridOnProFileParaRequest();
+    }
+
+    return true;
+}
+
 std::shared_ptr<InverterAbstract> HoymilesClass::addInverter(const char* name, const uint64_t serial)
+{
+    return addInverter(name, serial, _radioNrf.get(), _radioCmt.get());
+}
+
+std::shared_ptr<InverterAbstract> HoymilesClass::addInverter(const char* name, const uint64_t serial, HoymilesRadio* radioNrf, HoymilesRadio* radioCmt)
 {
     std::shared_ptr<InverterAbstract> i = nullptr;
     if (HMT_4CH::isValidSerial(serial)) {
-        i = std::make_shared<HMT_4CH>(_radioCmt.get(), serial);
+        i = std::make_shared<HMT_4CH>(radioCmt, serial);
     } else if (HMT_6CH::isValidSerial(serial)) {
-        i = std::make_shared<HMT_6CH>(_radioCmt.get(), serial);
+        i = std::make_shared<HMT_6CH>(radioCmt, serial);
     } else if (HMS_4CH::isValidSerial(serial)) {
-        i = std::make_shared<HMS_4CH>(_radioCmt.get(), serial);
+        i = std::make_shared<HMS_4CH>(radioCmt, serial);
     } else if (HMS_2CH::isValidSerial(serial)) {
-        i = std::make_shared<HMS_2CH>(_radioCmt.get(), serial);
+        i = std::make_shared<HMS_2CH>(radioCmt, serial);
     } else if (HMS_1CH::isValidSerial(serial)) {
-        i = std::make_shared<HMS_1CH>(_radioCmt.get(), serial);
+        i = std::make_shared<HMS_1CH>(radioCmt, serial);
     } else if (HMS_1CHv2::isValidSerial(serial)) {
-        i = std::make_shared<HMS_1CHv2>(_radioCmt.get(), serial);
+        i = std::make_shared<HMS_1CHv2>(radioCmt, serial);
     } else if (HM_4CH::isValidSerial(serial)) {
-        i = std::make_shared<HM_4CH>(_radioNrf.get(), serial);
+        i = std::make_shared<HM_4CH>(radioNrf, serial);
     } else if (HM_2CH::isValidSerial(serial)) {
-        i = std::make_shared<HM_2CH>(_radioNrf.get(), serial);
+        i = std::make_shared<HM_2CH>(radioNrf, serial);
     } else if (HM_1CH::isValidSerial(serial)) {
-        i = std::make_shared<HM_1CH>(_radioNrf.get(), serial);
+        i = std::make_shared<HM_1CH>(radioNrf, serial);
     } else if (HERF_2CH::isValidSerial(serial)) {
-        i = std::make_shared<HERF_2CH>(_radioNrf.get(), serial);
+        i = std::make_shared<HERF_2CH>(radioNrf, serial);
     } else if (HERF_4CH::isValidSerial(serial)) {
-        i = std::make_shared<HERF_4CH>(_radioNrf.get(), serial);
+        i = std::make_shared<HERF_4CH>(radioNrf, serial);
     }
 
     if (i) {
         i->setName(name);
         i->init();
+        i->PollInterval()->setBounds(_pollIntervalMin * 1000, _pollIntervalMax * 1000);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        addPollScheduler(i->getRadio());
         _inverters.push_back(std::move(i));
+        rebuildIndex();
         return _inverters.back();
     }
 
@@ -197,48 +243,93 @@ std::shared_ptr<InverterAbstract> HoymilesClass::getInverterByPos(const uint8_t
 
 std::shared_ptr<InverterAbstract> HoymilesClass::getInverterBySerial(const uint64_t serial)
 {
-    for (uint8_t i = 0; i < _inverters.size(); i++) {
-        if (_inverters[i]->serial() == serial) {
-            return _inverters[i];
-        }
+    const auto it = _indexBySerial.find(serial);
+    if (it == _indexBySerial.end()) {
+        return nullptr;
     }
-    return nullptr;
+    return _inverters[it->second];
+}
+
+InverterAbstract* HoymilesClass::findInverterBySerial(const uint64_t serial) const
+{
+    const auto it = _indexBySerial.find(serial);
+    if (it == _indexBySerial.end()) {
+        return nullptr;
+    }
+    return _inverters[it->second].get();
 }
 
-std::shared_ptr<InverterAbstract> HoymilesClass::getInverterByFragment(const fragment_t& fragment)
+InverterAbstract* HoymilesClass::findInverterByFragment(const fragment_t& fragment) const
 {
     if (fragment.len <= 4) {
         return nullptr;
     }
 
-    std::shared_ptr<InverterAbstract> inv;
-    for (uint8_t i = 0; i < _inverters.size(); i++) {
-        inv = _inverters[i];
-        serial_u p;
-        p.u64 = inv->serial();
+    const uint32_t radioId = (static_cast<uint32_t>(fragment.fragment[1]) << 24)
+        | (static_cast<uint32_t>(fragment.fragment[2]) << 16)
+        | (static_cast<uint32_t>(fragment.fragment[3]) << 8)
+        | fragment.fragment[4];
 
-        if ((p.b[3] == fragment.fragment[1])
-            && (p.b[2] == fragment.fragment[2])
-            && (p.b[1] == fragment.fragment[3])
-            && (p.b[0] == fragment.fragment[4])) {
+    const auto it = _indexByRadioId.find(radioId);
+    if (it == _indexByRadioId.end()) {
+        return nullptr;
+    }
+    return _inverters[it->second].get();
+}
+
+void HoymilesClass::removeInverterBySerial(const uint64_t serial)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _indexBySerial.find(serial);
+    if (it == _indexBySerial.end()) {
+        return;
+    }
+
+    HoymilesRadio* radio = _inverters[it->second]->getRadio();
+    radio->removeInverter(*_inverters[it->second]);
+    _inverters.erase(_inverters.begin() + it->second);
+    rebuildIndex();
+    removePollScheduler(radio);
+}
 
-            return inv;
+void HoymilesClass::addPollScheduler(HoymilesRadio* radio)
+{
+    for (const auto& scheduler : _pollSchedulers) {
+        if (scheduler.radio == radio) {
+            return;
         }
     }
-    return nullptr;
+    _pollSchedulers.push_back({ radio, 0, 0 });
 }
 
-void HoymilesClass::removeInverterBySerial(const uint64_t serial)
+void HoymilesClass::removePollScheduler(HoymilesRadio* radio)
 {
-    for (uint8_t i = 0; i < _inverters.size(); i++) {
-        if (_inverters[i]->serial() == serial) {
-            std::lock_guard<std::mutex> lock(_mutex);
-            _inverters.erase(_inverters.begin() + i);
+    for (const auto& inv : _inverters) {
+        if (inv->getRadio() == radio) {
+            return;
+        }
+    }
+
+    for (auto it = _pollSchedulers.begin(); it != _pollSchedulers.end(); ++it) {
+        if (it->radio == radio) {
+            _pollSchedulers.erase(it);
             return;
         }
     }
 }
 
+void HoymilesClass::rebuildIndex()
+{
+    _indexBySerial.clear();
+    _indexByRadioId.clear();
+    for (size_t i = 0; i < _inverters.size(); i++) {
+        const uint64_t serial = _inverters[i]->serial();
+        _indexBySerial.emplace(serial, i);
+        // Two serials may share the radio id, the first inverter receives the fragments (as before)
+        _indexByRadioId.emplace(static_cast<uint32_t>(serial), i);
+    }
+}
+
 size_t HoymilesClass::getNumInverters() const
 {
     return _inverters.size();
@@ -259,6 +350,52 @@ bool HoymilesClass::isAllRadioIdle() const
     return _radioNrf.get()->isIdle() && _radioCmt.get()->isIdle();
 }
 
+bool HoymilesClass::startRadioTask(const BaseType_t core)
+{
+    return _radioTask.start([this] {
+        loop();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const auto& scheduler : _pollSchedulers) {
+            if (!scheduler.radio->isIdle()) {
+                return true;
+            }
+        }
+        return false;
+    },
+        core);
+}
+
+void HoymilesClass::stopRadioTask()
+{
+    _radioTask.stop();
+}
+
+bool HoymilesClass::isRadioTaskRunning() const
+{
+    return _radioTask.isRunning();
+}
+
+RadioTaskStatistics_t HoymilesClass::getRadioTaskStatistics() const
+{
+    return _radioTask.getStatistics();
+}
+
+void HoymilesClass::wakeupRadioTask()
+{
+    _radioTask.notify();
+}
+
+void ARDUINO_ISR_ATTR HoymilesClass::wakeupRadioTaskFromIsr()
+{
+    _radioTask.notifyFromIsr();
+}
+
+RfCapture& HoymilesClass::getRfCapture()
+{
+    return _rfCapture;
+}
+
 uint32_t HoymilesClass::PollInterval() const
 {
     return _pollInterval;
@@ -269,9 +406,46 @@ void HoymilesClass::setPollInterval(const uint32_t interval)
     _pollInterval = interval;
 }
 
+void HoymilesClass::setPollIntervalBounds(const uint32_t minInterval, const uint32_t maxInterval)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pollIntervalMin = minInterval;
+    _pollIntervalMax = std::max(minInterval, maxInterval);
+    for (auto& inv : _inverters) {
+        inv->PollInterval()->setBounds(_pollIntervalMin * 1000, _pollIntervalMax * 1000);
+    }
+}
+
+uint32_t HoymilesClass::getPollIntervalMin() const
+{
+    return _pollIntervalMin;
+}
+
+uint32_t HoymilesClass::getPollIntervalMax() const
+{
+    return _pollIntervalMax;
+}
+
+void HoymilesClass::setRxTimeoutBounds(const uint32_t minTimeout, const uint32_t maxTimeout)
+{
+    _rxTimeoutMin = minTimeout;
+    _rxTimeoutMax = maxTimeout;
+}
+
+uint32_t HoymilesClass::getRxTimeoutMin() const
+{
+    return _rxTimeoutMin;
+}
+
+uint32_t HoymilesClass::getRxTimeoutMax() const
+{
+    return _rxTimeoutMax;
+}
+
 void HoymilesClass::setMessageOutput(Print* output)
 {
     _messageOutput = output;
+    HoymilesLog.setOutput(output);
 }
 
 Print* HoymilesClass::getMessageOutput()
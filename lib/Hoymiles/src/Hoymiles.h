@@ -1,13 +1,17 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "HoymilesLog.h"
 #include "HoymilesRadio_CMT.h"
 #include "HoymilesRadio_NRF.h"
+#include "RadioTask.h"
+#include "RfCapture.h"
 #include "inverters/InverterAbstract.h"
 #include "types.h"
 #include <Print.h>
 #include <SPI.h>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #define HOY_SYSTEM_CONFIG_PARA_POLL_INTERVAL (2 * 60 * 1000) // 2 minutes
@@ -24,9 +28,13 @@ public:
     Print* getMessageOutput();
 
     std::shared_ptr<InverterAbstract> addInverter(const char* name, const uint64_t serial);
+    // Allows to attach the inverter to other radios than the internal ones (e.g. simulation)
+    std::shared_ptr<InverterAbstract> addInverter(const char* name, const uint64_t serial, HoymilesRadio* radioNrf, HoymilesRadio* radioCmt);
     std::shared_ptr<InverterAbstract> getInverterByPos(const uint8_t pos);
     std::shared_ptr<InverterAbstract> getInverterBySerial(const uint64_t serial);
-    std::shared_ptr<InverterAbstract> getInverterByFragment(const fragment_t& fragment);
+    // Non-owning lookups for the radio loop, the pointer is only valid until the inverter is removed
+    InverterAbstract* findInverterBySerial(const uint64_t serial) const;
+    InverterAbstract* findInverterByFragment(const fragment_t& fragment) const;
     void removeInverterBySerial(const uint64_t serial);
     size_t getNumInverters() const;
 
@@ -36,17 +44,63 @@ public:
     uint32_t PollInterval() const;
     void setPollInterval(const uint32_t interval);
 
+    // Bounds (seconds) of the adaptive poll interval of every inverter
+    void setPollIntervalBounds(const uint32_t minInterval, const uint32_t maxInterval);
+    uint32_t getPollIntervalMin() const;
+    uint32_t getPollIntervalMax() const;
+
+    // Bounds (ms) of the timeouts learned from the response latency of every inverter.
+    // The static command timeout is never exceeded. maxTimeout = 0 disables the learning.
+    void setRxTimeoutBounds(const uint32_t minTimeout, const uint32_t maxTimeout);
+    uint32_t getRxTimeoutMin() const;
+    uint32_t getRxTimeoutMax() const;
+
     bool isAllRadioIdle() const;
 
+    // Runs loop() in its own task pinned to core (or tskNO_AFFINITY) instead of calling it from the main loop.
+    // The task is woken by the radio interrupts and by new commands.
+    bool startRadioTask(const BaseType_t core);
+    void stopRadioTask();
+    bool isRadioTaskRunning() const;
+    RadioTaskStatistics_t getRadioTaskStatistics() const;
+    void wakeupRadioTask();
+    void ARDUINO_ISR_ATTR wakeupRadioTaskFromIsr();
+
+    // Raw packets of all radios, disabled until RfCapture::begin() is called
+    RfCapture& getRfCapture();
+
 private:
+    // Round robin state of one radio, every radio polls its inverters independently
+    struct PollScheduler_t {
+        HoymilesRadio* radio;
+        uint32_t lastPoll;
+        uint8_t inverterPos;
+    };
+
+    void pollNextInverter(PollScheduler_t& scheduler);
+    bool pollInverter(std::shared_ptr<InverterAbstract> iv);
+    void addPollScheduler(HoymilesRadio* radio);
+    void removePollScheduler(HoymilesRadio* radio);
+    void rebuildIndex();
+
     std::vector<std::shared_ptr<InverterAbstract>> _inverters;
+    // Positions in _inverters by serial and by radio id (lower 4 bytes of the serial, sent in every fragment)
+    std::unordered_map<uint64_t, size_t> _indexBySerial;
+    std::unordered_map<uint32_t, size_t> _indexByRadioId;
+    std::vector<PollScheduler_t> _pollSchedulers;
     std::unique_ptr<HoymilesRadio_NRF> _radioNrf;
     std::unique_ptr<HoymilesRadio_CMT> _radioCmt;
 
     std::mutex _mutex;
+    RadioTask _radioTask;
+    RfCapture _rfCapture;
 
     uint32_t _pollInterval = 0;
-    uint32_t _lastPoll = 0;
+    uint32_t _pollIntervalMin = 0;
+    uint32_t _pollIntervalMax = 0;
+    uint32_t _rxTimeoutMin = RESPONSE_TIMEOUT_MIN;
+    uint32_t _rxTimeoutMax = RESPONSE_TIMEOUT_MAX;
+    uint32_t _lastHousekeeping = 0;
 
     Print* _messageOutput = &Serial;
 };
@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HoymilesLog.h"
+#include <algorithm>
+#include <cstdio>
+
+HoymilesLogClass HoymilesLog;
+
+void HoymilesLogClass::setOutput(Print* output)
+{
+    _output = output;
+}
+
+void HoymilesLogClass::setLevel(const uint8_t level)
+{
+    _level = level;
+}
+
+uint8_t HoymilesLogClass::getLevel() const
+{
+    return _level;
+}
+
+void HoymilesLogClass::setDeferred(const bool deferred)
+{
+    _deferred = deferred;
+}
+
+bool HoymilesLogClass::isDeferred() const
+{
+    return _deferred;
+}
+
+void HoymilesLogClass::checkFormat(const char* /*format*/, ...)
+{
+}
+
+void HoymilesLogClass::encodeString(uint8_t record[], size_t& len, const char* value)
+{
+    if (value == nullptr) {
+        value = "(null)";
+    }
+    if (len + 3 > HOY_LOG_MAX_RECORD) {
+        return;
+    }
+    const size_t stringLen = std::min<size_t>(strnlen(value, HOY_LOG_MAX_STRING), HOY_LOG_MAX_RECORD - len - 3);
+
+    record[len++] = HOY_LOG_ARG_STRING;
+    record[len++] = stringLen + 1;
+    memcpy(&record[len], value, stringLen);
+    record[len + stringLen] = '\0';
+    len += stringLen + 1;
+}
+
+void HoymilesLogClass::addHex(const uint8_t level, const uint8_t data[], const uint8_t len)
+{
+    if (level > _level) {
+        return;
+    }
+
+    if (!_deferred) {
+        Print* output = _output;
+        if (output == nullptr) {
+            return;
+        }
+        for (uint8_t i = 0; i < len; i++) {
+            output->printf("%02X ", data[i]);
+        }
+        return;
+    }
+
+    uint8_t record[HOY_LOG_MAX_RECORD];
+    const size_t dataLen = std::min<size_t>(len, HOY_LOG_MAX_RECORD - sizeof(Record_t));
+    memcpy(&record[sizeof(Record_t)], data, dataLen);
+    push(nullptr, RECORD_HEX, record, sizeof(Record_t) + dataLen);
+}
+
+void HoymilesLogClass::push(const char* format, const RecordType_t type, uint8_t record[], const size_t len)
+{
+    Record_t header;
+    header.format = format;
+    header.type = type;
+    header.len = len;
+    memcpy(record, &header, sizeof(header));
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_head + len - _tail > HOY_LOG_BUFFER_SIZE) {
+        // Keep the waiting records, their order matters more than the newest one
+        _dropped++;
+        return;
+    }
+    copyIn(_head, record, len);
+    _head += len;
+    _records++;
+}
+
+size_t HoymilesLogClass::flush(Print& output)
+{
+    size_t available = std::max(output.availableForWrite(), 0);
+    size_t written = 0;
+    uint8_t record[HOY_LOG_MAX_RECORD];
+
+    while (available > 0) {
+        // Rest of a line which did not fit the last time
+        if (_linePos < _lineLen) {
+            const size_t len = std::min(_lineLen - _linePos, available);
+            output.write(reinterpret_cast<const uint8_t*>(&_line[_linePos]), len);
+            _linePos += len;
+            written += len;
+            available -= len;
+            continue;
+        }
+
+        uint32_t dropped;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            dropped = _dropped - _droppedReported;
+            _droppedReported = _dropped;
+            if (dropped == 0) {
+                if (_head == _tail) {
+                    break;
+                }
+                Record_t header;
+                copyOut(_tail, &header, sizeof(header));
+                copyOut(_tail, record, header.len);
+                _tail += header.len;
+                _records--;
+            }
+        }
+
+        _linePos = 0;
+        if (dropped > 0) {
+            _lineLen = snprintf(_line, sizeof(_line), "Hoymiles log: %u messages dropped\r\n", dropped);
+        } else {
+            _lineLen = format(record, _line);
+        }
+    }
+    return written;
+}
+
+void HoymilesLogClass::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tail = _head;
+    _records = 0;
+    _lineLen = _linePos = 0;
+}
+
+HoymilesLogStatistics_t HoymilesLogClass::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    HoymilesLogStatistics_t statistics;
+    statistics.records = _records;
+    statistics.used = _head - _tail;
+    statistics.dropped = _dropped;
+    return statistics;
+}
+
+size_t HoymilesLogClass::format(const uint8_t record[], char line[]) const
+{
+    Record_t header;
+    memcpy(&header, record, sizeof(header));
+
+    size_t pos = 0;
+    const auto append = [&pos](const int n) {
+        if (n > 0) {
+            pos = std::min<size_t>(pos + n, HOY_LOG_MAX_LINE - 1);
+        }
+    };
+
+    if (header.type == RECORD_HEX) {
+        for (size_t i = sizeof(header); i < header.len; i++) {
+            append(snprintf(&line[pos], HOY_LOG_MAX_LINE - pos, "%02X ", record[i]));
+        }
+        return pos;
+    }
+
+    size_t arg = sizeof(header);
+    for (const char* f = header.format; *f != '\0' && pos < HOY_LOG_MAX_LINE - 1; f++) {
+        if (*f != '%') {
+            line[pos++] = *f;
+            continue;
+        }
+        if (f[1] == '%') {
+            line[pos++] = '%';
+            f++;
+            continue;
+        }
+
+        // Keep flags, width and precision, the length modifier depends on the recorded type
+        char spec[16] = "%";
+        size_t specLen = 1;
+        const char* c = f + 1;
+        while (*c != '\0' && strchr("-+ #0123456789.", *c) != nullptr && specLen < sizeof(spec) - 4) {
+            spec[specLen++] = *c++;
+        }
+        while (*c != '\0' && strchr("hlLqjzt", *c) != nullptr) {
+            c++;
+        }
+        if (*c == '\0' || arg >= header.len) {
+            break;
+        }
+        const char conversion = *c;
+        f = c;
+
+        const uint8_t type = record[arg] & 0x0f;
+        const uint8_t width = record[arg] >> 4;
+        arg++;
+
+        int64_t intValue = 0;
+        double doubleValue = 0;
+        const char* stringValue = "";
+        switch (type) {
+        case HOY_LOG_ARG_INT:
+        case HOY_LOG_ARG_UINT:
+        case HOY_LOG_ARG_POINTER:
+            if (type == HOY_LOG_ARG_POINTER) {
+                uintptr_t pointer;
+                memcpy(&pointer, &record[arg], sizeof(pointer));
+                intValue = pointer;
+                arg += sizeof(pointer);
+            } else {
+                memcpy(&intValue, &record[arg], sizeof(intValue));
+                arg += sizeof(intValue);
+            }
+            doubleValue = type == HOY_LOG_ARG_INT ? static_cast<double>(intValue) : static_cast<double>(static_cast<uint64_t>(intValue));
+            break;
+        case HOY_LOG_ARG_DOUBLE:
+            memcpy(&doubleValue, &record[arg], sizeof(doubleValue));
+            intValue = static_cast<int64_t>(doubleValue);
+            arg += sizeof(doubleValue);
+            break;
+        case HOY_LOG_ARG_STRING:
+            stringValue = reinterpret_cast<const char*>(&record[arg + 1]);
+            arg += 1 + record[arg];
+            break;
+        }
+
+        char* out = &line[pos];
+        const size_t left = HOY_LOG_MAX_LINE - pos;
+        if (strchr("di", conversion) != nullptr) {
+            strcpy(&spec[specLen], "lld");
+            append(snprintf(out, left, spec, static_cast<long long>(intValue)));
+        } else if (strchr("uxXo", conversion) != nullptr) {
+            uint64_t value = intValue;
+            // printf converts negative values of the promoted type (at least int)
+            const uint8_t bytes = std::max<uint8_t>(width, sizeof(int));
+            if (type == HOY_LOG_ARG_INT && bytes < sizeof(value)) {
+                value &= (1ULL << (bytes * 8)) - 1;
+            }
+            spec[specLen] = 'l';
+            spec[specLen + 1] = 'l';
+            spec[specLen + 2] = conversion;
+            spec[specLen + 3] = '\0';
+            append(snprintf(out, left, spec, static_cast<unsigned long long>(value)));
+        } else if (strchr("fFeEgGaA", conversion) != nullptr) {
+            spec[specLen] = conversion;
+            spec[specLen + 1] = '\0';
+            append(snprintf(out, left, spec, doubleValue));
+        } else if (conversion == 'c') {
+            strcpy(&spec[specLen], "c");
+            append(snprintf(out, left, spec, static_cast<int>(intValue)));
+        } else if (conversion == 's') {
+            strcpy(&spec[specLen], "s");
+            append(snprintf(out, left, spec, stringValue));
+        } else if (conversion == 'p') {
+            append(snprintf(out, left, "%p", reinterpret_cast<void*>(static_cast<uintptr_t>(intValue))));
+        }
+    }
+
+    line[pos] = '\0';
+    return pos;
+}
+
+void HoymilesLogClass::copyIn(const uint32_t position, const void* data, const size_t len)
+{
+    const uint32_t offset = position & (HOY_LOG_BUFFER_SIZE - 1);
+    const size_t first = std::min<size_t>(len, HOY_LOG_BUFFER_SIZE - offset);
+    memcpy(&_buffer[offset], data, first);
+    memcpy(&_buffer[0], static_cast<const uint8_t*>(data) + first, len - first);
+}
+
+void HoymilesLogClass::copyOut(const uint32_t position, void* data, const size_t len) const
+{
+    const uint32_t offset = position & (HOY_LOG_BUFFER_SIZE - 1);
+    const size_t first = std::min<size_t>(len, HOY_LOG_BUFFER_SIZE - offset);
+    memcpy(data, &_buffer[offset], first);
+    memcpy(static_cast<uint8_t*>(data) + first, &_buffer[0], len - first);
+}
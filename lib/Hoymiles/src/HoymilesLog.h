@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Print.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+#define HOY_LOG_NONE 0
+#define HOY_LOG_ERROR 1
+#define HOY_LOG_WARN 2
+#define HOY_LOG_INFO 3
+#define HOY_LOG_DEBUG 4
+#define HOY_LOG_VERBOSE 5
+
+// Highest level compiled in per module, messages above it are removed by the compiler
+#ifndef HOY_LOG_LEVEL
+#define HOY_LOG_LEVEL HOY_LOG_VERBOSE
+#endif
+// Poll scheduler: fetched inverters and requests
+#ifndef HOY_LOG_LEVEL_SCHEDULER
+#define HOY_LOG_LEVEL_SCHEDULER HOY_LOG_LEVEL
+#endif
+// Radio drivers: packet dumps, interrupts, rx periods
+#ifndef HOY_LOG_LEVEL_RADIO
+#define HOY_LOG_LEVEL_RADIO HOY_LOG_LEVEL
+#endif
+// Fragment reassembly and command evaluation
+#ifndef HOY_LOG_LEVEL_INVERTER
+#define HOY_LOG_LEVEL_INVERTER HOY_LOG_LEVEL
+#endif
+#ifndef HOY_LOG_LEVEL_PARSER
+#define HOY_LOG_LEVEL_PARSER HOY_LOG_LEVEL
+#endif
+
+// 1 = record the format and the arguments and format them when the log is flushed
+// 0 = print immediately to the message output
+#ifndef HOY_LOG_DEFERRED
+#define HOY_LOG_DEFERRED 1
+#endif
+
+// Bytes of the record ring, a power of two
+#ifndef HOY_LOG_BUFFER_SIZE
+#define HOY_LOG_BUFFER_SIZE 4096
+#endif
+
+#define HOY_LOG_MAX_RECORD 96
+#define HOY_LOG_MAX_STRING 32
+#define HOY_LOG_MAX_LINE 160
+
+static_assert((HOY_LOG_BUFFER_SIZE & (HOY_LOG_BUFFER_SIZE - 1)) == 0, "HOY_LOG_BUFFER_SIZE has to be a power of two");
+
+// HOY_LOG(RADIO, DEBUG, "RX Channel: %d --> ", channel);
+#define HOY_LOG(module, level, ...)                                   \
+    do {                                                              \
+        if constexpr (HOY_LOG_##level <= HOY_LOG_LEVEL_##module) {    \
+            if (false) {                                              \
+                HoymilesLogClass::checkFormat(__VA_ARGS__);           \
+            }                                                         \
+            HoymilesLog.add(HOY_LOG_##level, __VA_ARGS__);            \
+        }                                                             \
+    } while (0)
+
+// Prints len bytes as "%02X "
+#define HOY_LOG_HEX(module, level, data, len)                         \
+    do {                                                              \
+        if constexpr (HOY_LOG_##level <= HOY_LOG_LEVEL_##module) {    \
+            HoymilesLog.addHex(HOY_LOG_##level, data, len);           \
+        }                                                             \
+    } while (0)
+
+enum HoymilesLogArg_t : uint8_t {
+    HOY_LOG_ARG_INT,
+    HOY_LOG_ARG_UINT,
+    HOY_LOG_ARG_DOUBLE,
+    HOY_LOG_ARG_STRING,
+    HOY_LOG_ARG_POINTER,
+};
+
+struct HoymilesLogStatistics_t {
+    uint32_t records; // waiting to be formatted
+    uint32_t used; // bytes
+    uint32_t dropped; // records which did not fit into the buffer
+};
+
+/*
+ * Log of the Hoymiles library. In deferred mode the radio loop only copies the
+ * pointer to the format string and the arguments into a ring buffer, the text
+ * is formatted by flush() from the task which writes to the console.
+ */
+class HoymilesLogClass {
+public:
+    void setOutput(Print* output);
+
+    // Runtime filter below the compile time levels, HOY_LOG_NONE disables the log
+    void setLevel(const uint8_t level);
+    uint8_t getLevel() const;
+
+    void setDeferred(const bool deferred);
+    bool isDeferred() const;
+
+    template <typename... Args>
+    void add(const uint8_t level, const char* format, const Args&... args)
+    {
+        if (level > _level) {
+            return;
+        }
+
+        if (!_deferred) {
+            Print* output = _output;
+            if (output == nullptr) {
+                return;
+            }
+            if constexpr (sizeof...(args) == 0) {
+                output->print(format);
+            } else {
+                output->printf(format, args...);
+            }
+            return;
+        }
+
+        uint8_t record[HOY_LOG_MAX_RECORD];
+        size_t len = sizeof(Record_t);
+        (encode(record, len, args), ...);
+        push(format, RECORD_FORMAT, record, len);
+    }
+
+    void addHex(const uint8_t level, const uint8_t data[], const uint8_t len);
+
+    // Formats the waiting records as long as the output accepts them without blocking
+    // (Print::availableForWrite()), returns the number of bytes written. A line which
+    // does not fit is continued by the next call. Has to be called by a single task.
+    size_t flush(Print& output);
+    // Drops the waiting records and the rest of a partially written line
+    void clear();
+
+    HoymilesLogStatistics_t getStatistics() const;
+
+    // Never called, lets the compiler check the format of HOY_LOG
+    static void checkFormat(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+private:
+    enum RecordType_t : uint8_t {
+        RECORD_FORMAT,
+        RECORD_HEX,
+    };
+
+    struct Record_t {
+        const char* format; // string literal, lives as long as the firmware
+        uint8_t type;
+        uint8_t len; // including this header
+    };
+
+    template <typename T>
+    static void encode(uint8_t record[], size_t& len, const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool>) {
+            encodeValue(record, len, HOY_LOG_ARG_INT, static_cast<int64_t>(value));
+        } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            // The width is kept to print negative values with %x like printf
+            const uint8_t width = sizeof(T) << 4;
+            if constexpr (std::is_signed_v<T>) {
+                encodeValue(record, len, HOY_LOG_ARG_INT | width, static_cast<int64_t>(value));
+            } else {
+                encodeValue(record, len, HOY_LOG_ARG_UINT | width, static_cast<uint64_t>(value));
+            }
+        } else if constexpr (std::is_floating_point_v<T>) {
+            encodeValue(record, len, HOY_LOG_ARG_DOUBLE, static_cast<double>(value));
+        } else if constexpr (std::is_convertible_v<T, const char*>) {
+            encodeString(record, len, value);
+        } else {
+            static_assert(std::is_pointer_v<T>, "Unsupported log argument");
+            encodeValue(record, len, HOY_LOG_ARG_POINTER, reinterpret_cast<uintptr_t>(value));
+        }
+    }
+
+    template <typename T>
+    static void encodeValue(uint8_t record[], size_t& len, const uint8_t type, const T value)
+    {
+        if (len + 1 + sizeof(value) > HOY_LOG_MAX_RECORD) {
+            return;
+        }
+        record[len++] = type;
+        memcpy(&record[len], &value, sizeof(value));
+        len += sizeof(value);
+    }
+
+    static void encodeString(uint8_t record[], size_t& len, const char* value);
+
+    void push(const char* format, const RecordType_t type, uint8_t record[], const size_t len);
+    size_t format(const uint8_t record[], char line[]) const;
+    void copyIn(const uint32_t position, const void* data, const size_t len);
+    void copyOut(const uint32_t position, void* data, const size_t len) const;
+
+    std::atomic<Print*> _output { nullptr };
+    std::atomic<uint8_t> _level { HOY_LOG_VERBOSE };
+    std::atomic<bool> _deferred { HOY_LOG_DEFERRED != 0 };
+
+    mutable std::mutex _mutex;
+    uint8_t _buffer[HOY_LOG_BUFFER_SIZE];
+    uint32_t _head = 0; // free running positions
+    uint32_t _tail = 0;
+    uint32_t _records = 0;
+    uint32_t _dropped = 0;
+    uint32_t _droppedReported = 0;
+
+    // Formatted line of flush()
+    char _line[HOY_LOG_MAX_LINE];
+    size_t _lineLen = 0;
+    size_t _linePos = 0;
+};
+
+extern HoymilesLogClass HoymilesLog;
@@ -5,6 +5,7 @@
 #include "HoymilesRadio.h"
 #include "Hoymiles.h"
 #include "crc.h"
+#include <algorithm>
 
 serial_u HoymilesRadio::DtuSerial() const
 {
@@ -28,99 +29,179 @@ serial_u HoymilesRadio::convertSerialToRadioId(const serial_u serial)
     return radioId;
 }
 
+void HoymilesRadio::enqueCommand(CommandAbstract* cmd)
+{
+    _commandQueue.push(cmd);
+    Hoymiles.wakeupRadioTask();
+}
+
 bool HoymilesRadio::checkFragmentCrc(const fragment_t& fragment) const
 {
     const uint8_t crc = crc8(fragment.fragment, fragment.len - 1);
     return (crc == fragment.fragment[fragment.len - 1]);
 }
 
-void HoymilesRadio::sendRetransmitPacket(const uint8_t fragment_id)
+void HoymilesRadio::sendRetransmitPackets(const InverterAbstract& inv)
 {
-    CommandAbstract* cmd = _commandQueue.front().get();
+    CommandAbstract* cmd = _commandQueue.front();
+
+    // All missing fragments are requested back to back and received in the same rx period
+    const uint8_t count = inv.getRetransmitFragmentCount();
+    for (uint8_t i = 0; i < count; i++) {
+        CommandAbstract* requestCmd = cmd->getRequestFrameCommand(inv.getRetransmitFragment(i));
 
-    CommandAbstract* requestCmd = cmd->getRequestFrameCommand(fragment_id);
+        if (requestCmd != nullptr) {
+            // The answer contains only the requested fragment
+            _rxLearnLatency = false;
+            sendEsbPacket(*requestCmd);
+        }
+    }
 
-    if (requestCmd != nullptr) {
-        sendEsbPacket(*requestCmd);
+    if (count > 0 && cmd->getLatencyClass() < CommandLatencyClass_Max) {
+        _retransmitStatistics[cmd->getLatencyClass()].rounds++;
+        _retransmitStatistics[cmd->getLatencyClass()].fragments += count;
     }
 }
 
 void HoymilesRadio::sendLastPacketAgain()
 {
-    CommandAbstract* cmd = _commandQueue.front().get();
+    CommandAbstract* cmd = _commandQueue.front();
+    _rxLearnLatency = true;
     sendEsbPacket(*cmd);
 }
 
+void HoymilesRadio::handleReceivedFragment(InverterAbstract& inv, const fragment_t& fragment)
+{
+    inv.addRxFragment(fragment.fragment, fragment.len);
+
+    if (!_busyFlag || _rxComplete || isQueueEmpty()) {
+        return;
+    }
+
+    CommandAbstract* cmd = _commandQueue.front();
+    if (cmd->getTargetAddress() == inv.serial() && inv.isAllFragmentsReceived(cmd->getDataPayload()[0] | 0x80)) {
+        _rxComplete = true;
+        if (_rxLearnLatency) {
+            inv.ResponseLatency()->addSample(cmd->getLatencyClass(), _rxTimeout.elapsed());
+        }
+    }
+}
+
 void HoymilesRadio::handleReceivedPackage()
 {
-    if (_busyFlag && _rxTimeout.occured()) {
-        Hoymiles.getMessageOutput()->println("RX Period End");
-        std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterBySerial(_commandQueue.front().get()->getTargetAddress());
+    if (_busyFlag && (_rxComplete || _rxTimeout.occured())) {
+        _rxTiming.exchanges++;
+        _rxTiming.completedEarly += _rxComplete ? 1 : 0;
+        _rxTiming.totalElapsed += _rxTimeout.elapsed();
+        _rxTiming.totalTimeout += _rxTimeout.getTimeout();
+        _rxComplete = false;
+
+        HOY_LOG(RADIO, DEBUG, "RX Period End\r\n");
+        handleRxPeriodEnd();
+        InverterAbstract* inv = Hoymiles.findInverterBySerial(_commandQueue.front()->getTargetAddress());
 
         if (nullptr != inv) {
-            CommandAbstract* cmd = _commandQueue.front().get();
+            CommandAbstract* cmd = _commandQueue.front();
             uint8_t verifyResult = inv->verifyAllFragments(*cmd);
             if (verifyResult == FRAGMENT_ALL_MISSING_RESEND) {
-                Hoymiles.getMessageOutput()->println("Nothing received, resend whole request");
+                HOY_LOG(RADIO, INFO, "Nothing received, resend whole request\r\n");
                 sendLastPacketAgain();
 
             } else if (verifyResult == FRAGMENT_ALL_MISSING_TIMEOUT) {
-                Hoymiles.getMessageOutput()->println("Nothing received, resend count exeeded");
+                HOY_LOG(RADIO, WARN, "Nothing received, resend count exeeded\r\n");
                 _commandQueue.pop();
                 _busyFlag = false;
+                _commandResults.failed++;
 
             } else if (verifyResult == FRAGMENT_RETRANSMIT_TIMEOUT) {
-                Hoymiles.getMessageOutput()->println("Retransmit timeout");
+                HOY_LOG(RADIO, WARN, "Retransmit timeout\r\n");
                 _commandQueue.pop();
                 _busyFlag = false;
+                _commandResults.failed++;
 
             } else if (verifyResult == FRAGMENT_HANDLE_ERROR) {
-                Hoymiles.getMessageOutput()->println("Packet handling error");
+                HOY_LOG(RADIO, ERROR, "Packet handling error\r\n");
                 _commandQueue.pop();
                 _busyFlag = false;
+                _commandResults.failed++;
 
             } else if (verifyResult > 0) {
                 // Perform Retransmit
-                Hoymiles.getMessageOutput()->print("Request retransmit: ");
-                Hoymiles.getMessageOutput()->println(verifyResult);
-                sendRetransmitPacket(verifyResult);
+                HOY_LOG(RADIO, INFO, "Request retransmit:");
+                for (uint8_t i = 0; i < inv->getRetransmitFragmentCount(); i++) {
+                    HOY_LOG(RADIO, INFO, " %d", inv->getRetransmitFragment(i));
+                }
+                HOY_LOG(RADIO, INFO, "\r\n");
+                sendRetransmitPackets(*inv);
 
             } else {
                 // Successful received all packages
-                Hoymiles.getMessageOutput()->println("Success");
+                HOY_LOG(RADIO, DEBUG, "Success\r\n");
                 _commandQueue.pop();
                 _busyFlag = false;
+                _commandResults.succeeded++;
             }
         } else {
             // If inverter was not found, assume the command is invalid
-            Hoymiles.getMessageOutput()->println("RX: Invalid inverter found");
+            HOY_LOG(RADIO, WARN, "RX: Invalid inverter found\r\n");
             _commandQueue.pop();
             _busyFlag = false;
+            _commandResults.failed++;
         }
+
+        if (!_busyFlag) {
+            releaseReassemblyBuffer(inv);
+        }
+
+        publishStatistics();
     } else if (!_busyFlag) {
         // Currently in idle mode --> send packet if one is in the queue
         if (!isQueueEmpty()) {
-            CommandAbstract* cmd = _commandQueue.front().get();
+            CommandAbstract* cmd = _commandQueue.front();
 
-            auto inv = Hoymiles.getInverterBySerial(cmd->getTargetAddress());
+            InverterAbstract* inv = Hoymiles.findInverterBySerial(cmd->getTargetAddress());
             if (nullptr != inv) {
-                inv->clearRxFragmentBuffer();
+                // The answer is reassembled in a buffer of the radio until the command completes
+                _reassemblyLease = _reassemblyPool.lease();
+                if (nullptr == _reassemblyLease) {
+                    HOY_LOG(RADIO, ERROR, "TX: No reassembly buffer available\r\n");
+                    _commandQueue.pop();
+                    _commandResults.failed++;
+                    return;
+                }
+                inv->setRxFragmentBuffer(_reassemblyLease);
+
+                // Replace the static timeout by the one learned from the previous answers of this inverter
+                if (Hoymiles.getRxTimeoutMax() > 0 && cmd->getLatencyClass() < CommandLatencyClass_Max) {
+                    cmd->setTimeout(inv->ResponseLatency()->getTimeout(cmd->getLatencyClass(),
+                        Hoymiles.getRxTimeoutMin(), std::min(cmd->getTimeout(), Hoymiles.getRxTimeoutMax())));
+                }
+
+                _rxLearnLatency = true;
                 sendEsbPacket(*cmd);
             } else {
-                Hoymiles.getMessageOutput()->println("TX: Invalid inverter found");
+                HOY_LOG(RADIO, WARN, "TX: Invalid inverter found\r\n");
                 _commandQueue.pop();
             }
         }
     }
 }
 
-void HoymilesRadio::dumpBuf(const uint8_t buf[], const uint8_t len, const bool appendNewline)
+void HoymilesRadio::releaseReassemblyBuffer(InverterAbstract* inv)
 {
-    for (uint8_t i = 0; i < len; i++) {
-        Hoymiles.getMessageOutput()->printf("%02X ", buf[i]);
+    // The inverter may have been removed while the command was in flight
+    if (nullptr != inv) {
+        inv->setRxFragmentBuffer(nullptr);
     }
+    _reassemblyPool.release(_reassemblyLease);
+    _reassemblyLease = nullptr;
+}
+
+void HoymilesRadio::dumpBuf(const uint8_t buf[], const uint8_t len, const bool appendNewline)
+{
+    HOY_LOG_HEX(RADIO, DEBUG, buf, len);
     if (appendNewline) {
-        Hoymiles.getMessageOutput()->println("");
+        HOY_LOG(RADIO, DEBUG, "\r\n");
     }
 }
 
@@ -129,6 +210,77 @@ bool HoymilesRadio::isInitialized() const
     return _isInitialized;
 }
 
+uint32_t HoymilesRadio::getRxBufferOverflowCount() const
+{
+    return _rxBuffer.getOverflowCount();
+}
+
+uint32_t HoymilesRadio::getRxBufferHighWaterMark() const
+{
+    return _rxBuffer.getHighWaterMark();
+}
+
+uint8_t HoymilesRadio::getCommandPoolSize() const
+{
+    return _commandQueue.getPoolSize();
+}
+
+uint8_t HoymilesRadio::getCommandPoolUsed() const
+{
+    return _commandQueue.getPoolUsed();
+}
+
+uint8_t HoymilesRadio::getCommandPoolHighWaterMark() const
+{
+    return _commandQueue.getPoolHighWaterMark();
+}
+
+uint32_t HoymilesRadio::getCommandPoolExhaustedCount() const
+{
+    return _commandQueue.getPoolExhaustedCount();
+}
+
+uint32_t HoymilesRadio::getCommandCoalescedCount() const
+{
+    return _commandQueue.getCoalescedCount();
+}
+
+CommandWaitStatistics_t HoymilesRadio::getCommandWaitStatistics(const CommandPriority_t priority) const
+{
+    return _commandQueue.getWaitStatistics(priority);
+}
+
+RxTimingStatistics_t HoymilesRadio::getRxTimingStatistics() const
+{
+    return _rxTiming;
+}
+
+RetransmitStatistics_t HoymilesRadio::getRetransmitStatistics(const CommandLatencyClass_t latencyClass) const
+{
+    if (latencyClass >= CommandLatencyClass_Max) {
+        return {};
+    }
+    return _retransmitStatistics[latencyClass];
+}
+
+RadioStatistics_t HoymilesRadio::getStatisticsSnapshot() const
+{
+    RadioStatistics_t statistics;
+    _statisticsSnapshot.read(statistics);
+    return statistics;
+}
+
+void HoymilesRadio::publishStatistics()
+{
+    RadioStatistics_t statistics;
+    statistics.rxOverflow = _rxBuffer.getOverflowCount();
+    statistics.rxHighWaterMark = _rxBuffer.getHighWaterMark();
+    statistics.commands = _commandResults;
+    statistics.rxTiming = _rxTiming;
+    std::copy(std::begin(_retransmitStatistics), std::end(_retransmitStatistics), statistics.retransmit);
+    _statisticsSnapshot.publish(statistics);
+}
+
 bool HoymilesRadio::isIdle() const
 {
     return !_busyFlag;
@@ -1,14 +1,51 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "CommandQueue.h"
+#include "ReassemblyPool.h"
 #include "commands/CommandAbstract.h"
 #include "types.h"
-#include <ThreadSafeQueue.h>
+#include <SnapshotBuffer.h>
+#include <SpscRingBuffer.h>
 #include <TimeoutHelper.h>
+#include <atomic>
 #include <memory>
 
+// number of fragments hold in buffer (has to be a power of two)
+#define FRAGMENT_BUFFER_SIZE 32
+
+class InverterAbstract;
+
+struct RxTimingStatistics_t {
+    uint32_t exchanges; // evaluated transmissions
+    uint32_t completedEarly; // evaluated before the timeout because all fragments were received
+    uint64_t totalElapsed; // ms between transmission and evaluation, 32 bits overflow within days
+    uint64_t totalTimeout; // ms configured as timeout
+};
+
+struct CommandResultStatistics_t {
+    uint32_t succeeded; // commands completed with all fragments
+    uint32_t failed; // commands dropped after timeouts or errors
+};
+
+struct RetransmitStatistics_t {
+    uint32_t rounds; // rx periods used for retransmits
+    uint32_t fragments; // requested fragments, fragments - rounds is the amount of saved rx periods
+};
+
+// Consistent copy of the statistics for readers outside of the radio loop
+struct RadioStatistics_t {
+    uint32_t rxOverflow;
+    uint32_t rxHighWaterMark;
+    CommandResultStatistics_t commands;
+    RxTimingStatistics_t rxTiming;
+    RetransmitStatistics_t retransmit[CommandLatencyClass_Max];
+};
+
 class HoymilesRadio {
 public:
+    virtual void loop() = 0;
+
     serial_u DtuSerial() const;
     virtual void setDtuSerial(const uint64_t serial);
 
@@ -16,31 +53,73 @@ public:
     bool isQueueEmpty() const;
     bool isInitialized() const;
 
-    void enqueCommand(std::shared_ptr<CommandAbstract> cmd)
-    {
-        _commandQueue.push(cmd);
-    }
+    uint32_t getRxBufferOverflowCount() const;
+    uint32_t getRxBufferHighWaterMark() const;
+
+    // Wakes up the radio task (if running)
+    void enqueCommand(CommandAbstract* cmd);
 
+    // Drops the references to inv, called before the inverter is deleted
+    virtual void removeInverter(const InverterAbstract& /*inv*/) { }
+
+    // Returns nullptr if the command pool is exhausted
     template <typename T>
-    std::shared_ptr<T> prepareCommand()
+    T* prepareCommand()
     {
-        return std::make_shared<T>();
+        return _commandQueue.allocate<T>();
     }
 
+    uint8_t getCommandPoolSize() const;
+    uint8_t getCommandPoolUsed() const;
+    uint8_t getCommandPoolHighWaterMark() const;
+    uint32_t getCommandPoolExhaustedCount() const;
+    uint32_t getCommandCoalescedCount() const;
+    CommandWaitStatistics_t getCommandWaitStatistics(const CommandPriority_t priority) const;
+    RxTimingStatistics_t getRxTimingStatistics() const;
+    RetransmitStatistics_t getRetransmitStatistics(const CommandLatencyClass_t latencyClass) const;
+
+    // Lock free, can be called from any task. Updated at the end of every rx period
+    RadioStatistics_t getStatisticsSnapshot() const;
+
 protected:
     static serial_u convertSerialToRadioId(const serial_u serial);
     static void dumpBuf(const uint8_t buf[], const uint8_t len, const bool appendNewline = true);
 
     bool checkFragmentCrc(const fragment_t& fragment) const;
     virtual void sendEsbPacket(CommandAbstract& cmd) = 0;
-    void sendRetransmitPacket(const uint8_t fragment_id);
+    void sendRetransmitPackets(const InverterAbstract& inv);
     void sendLastPacketAgain();
     void handleReceivedPackage();
+    // Has to be called by the driver for every received fragment with a valid crc
+    void handleReceivedFragment(InverterAbstract& inv, const fragment_t& fragment);
+    // Called at the end of every rx period before the answer is evaluated
+    virtual void handleRxPeriodEnd() { }
 
     serial_u _dtuSerial;
-    ThreadSafeQueue<std::shared_ptr<CommandAbstract>> _commandQueue;
+    CommandQueue _commandQueue;
     bool _isInitialized = false;
-    bool _busyFlag = false;
+    // Written by the radio loop, read by isIdle() from any task
+    std::atomic<bool> _busyFlag { false };
+
+    // Filled by the radio driver (producer), processed in loop() (consumer)
+    SpscRingBuffer<fragment_t, FRAGMENT_BUFFER_SIZE> _rxBuffer;
 
     TimeoutHelper _rxTimeout;
+
+private:
+    // All fragments of the current command are received, no need to wait for the timeout
+    bool _rxComplete = false;
+    // The answer of the current transmission is a complete answer of the command
+    bool _rxLearnLatency = false;
+    CommandResultStatistics_t _commandResults = {};
+    RxTimingStatistics_t _rxTiming = {};
+    RetransmitStatistics_t _retransmitStatistics[CommandLatencyClass_Max] = {};
+
+    // Only the command in flight reassembles an answer, the buffer is leased to its inverter
+    ReassemblyPool _reassemblyPool;
+    ReassemblyBuffer_t* _reassemblyLease = nullptr;
+    void releaseReassemblyBuffer(InverterAbstract* inv);
+
+    void publishStatistics();
+    SnapshotBuffer<RadioStatistics_t> _statisticsSnapshot;
 };
@@ -6,9 +6,10 @@
 #include "Hoymiles.h"
 #include "crc.h"
 #include <FunctionalInterrupt.h>
+#include <algorithm>
 #include <frozen/map.h>
 
-constexpr CountryFrequencyDefinition_t make_value(FrequencyBand_t Band, uint32_t Freq_Legal_Min, uint32_t Freq_Legal_Max, uint32_t Freq_Default, uint32_t Freq_StartUp)
+constexpr CountryFrequencyDefinition_t make_value(FrequencyBand_t Band, uint32_t Freq_Legal_Min, uint32_t Freq_Legal_Max, uint32_t Freq_Default, uint32_t Freq_StartUp, int8_t PaLevel_Legal_Max)
 {
     // frequency can not be lower than actual initailized base freq + 250000
     uint32_t minFrequency = CMT2300A::getBaseFrequency(Band) + HoymilesRadio_CMT::getChannelWidth();
@@ -16,14 +17,15 @@ constexpr CountryFrequencyDefinition_t make_value(FrequencyBand_t Band, uint32_t
     // =923500, 0xFF does not work
     uint32_t maxFrequency = CMT2300A::getBaseFrequency(Band) + 0xFE * HoymilesRadio_CMT::getChannelWidth();
 
-    CountryFrequencyDefinition_t v = { Band, minFrequency, maxFrequency, Freq_Legal_Min, Freq_Legal_Max, Freq_Default, Freq_StartUp };
+    CountryFrequencyDefinition_t v = { Band, minFrequency, maxFrequency, Freq_Legal_Min, Freq_Legal_Max, Freq_Default, Freq_StartUp, PaLevel_Legal_Max };
     return v;
 }
 
 constexpr frozen::map<CountryModeId_t, CountryFrequencyDefinition_t, 3> countryDefinition = {
-    { CountryModeId_t::MODE_EU, make_value(FrequencyBand_t::BAND_860, 863e6, 870e6, 865e6, 868e6) },
-    { CountryModeId_t::MODE_US, make_value(FrequencyBand_t::BAND_900, 905e6, 925e6, 918e6, 915e6) },
-    { CountryModeId_t::MODE_BR, make_value(FrequencyBand_t::BAND_900, 915e6, 928e6, 918e6, 915e6) },
+    // EU: 25 mW ERP in the SRD band, US/BR: limited by the chip
+    { CountryModeId_t::MODE_EU, make_value(FrequencyBand_t::BAND_860, 863e6, 870e6, 865e6, 868e6, 14) },
+    { CountryModeId_t::MODE_US, make_value(FrequencyBand_t::BAND_900, 905e6, 925e6, 918e6, 915e6, CMT_PA_LEVEL_MAX) },
+    { CountryModeId_t::MODE_BR, make_value(FrequencyBand_t::BAND_900, 915e6, 928e6, 918e6, 915e6, CMT_PA_LEVEL_MAX) },
 };
 
 uint32_t HoymilesRadio_CMT::getFrequencyFromChannel(const uint8_t channel) const
@@ -34,16 +36,16 @@ uint32_t HoymilesRadio_CMT::getFrequencyFromChannel(const uint8_t channel) const
 uint8_t HoymilesRadio_CMT::getChannelFromFrequency(const uint32_t frequency) const
 {
     if ((frequency % getChannelWidth()) != 0) {
-        Hoymiles.getMessageOutput()->printf("%.3f MHz is not divisible by %d kHz!\r\n", frequency / 1000000.0, getChannelWidth());
+        HOY_LOG(RADIO, WARN, "%.3f MHz is not divisible by %d kHz!\r\n", frequency / 1000000.0, getChannelWidth());
         return 0xFF; // ERROR
     }
     if (frequency < getMinFrequency() || frequency > getMaxFrequency()) {
-        Hoymiles.getMessageOutput()->printf("%.2f MHz is out of Hoymiles/CMT range! (%.2f MHz - %.2f MHz)\r\n",
+        HOY_LOG(RADIO, WARN, "%.2f MHz is out of Hoymiles/CMT range! (%.2f MHz - %.2f MHz)\r\n",
             frequency / 1000000.0, getMinFrequency() / 1000000.0, getMaxFrequency() / 1000000.0);
         return 0xFF; // ERROR
     }
     if (frequency < countryDefinition.at(_countryMode).Freq_Legal_Min || frequency > countryDefinition.at(_countryMode).Freq_Legal_Max) {
-        Hoymiles.getMessageOutput()->printf("!!! caution: %.2f MHz is out of region legal range! (%d - %d MHz)\r\n",
+        HOY_LOG(RADIO, WARN, "!!! caution: %.2f MHz is out of region legal range! (%d - %d MHz)\r\n",
             frequency / 1000000.0,
             static_cast<uint32_t>(countryDefinition.at(_countryMode).Freq_Legal_Min / 1e6),
             static_cast<uint32_t>(countryDefinition.at(_countryMode).Freq_Legal_Max / 1e6));
@@ -65,6 +67,7 @@ std::vector<CountryFrequencyList_t> HoymilesRadio_CMT::getCountryFrequencyList()
         s.definition.Freq_Max = value.Freq_Max;
         s.definition.Freq_Legal_Max = value.Freq_Legal_Max;
         s.definition.Freq_Legal_Min = value.Freq_Legal_Min;
+        s.definition.PaLevel_Legal_Max = value.PaLevel_Legal_Max;
 
         v.push_back(s);
     }
@@ -78,7 +81,16 @@ bool HoymilesRadio_CMT::cmtSwitchDtuFreq(const uint32_t to_frequency)
         return false;
     }
 
+    if (toChannel == _currentChannel) {
+        _retuneStatistics.skipped++;
+        return true;
+    }
+
     _radio->setChannel(toChannel);
+    _currentChannel = toChannel;
+    _retuneStatistics.retunes++;
+    HOY_LOG(RADIO, INFO, "CMT: Retune to %.2f MHz (%u retunes, %u skipped)\r\n",
+        to_frequency / 1000000.0, _retuneStatistics.retunes, _retuneStatistics.skipped);
 
     return true;
 }
@@ -90,15 +102,17 @@ void HoymilesRadio_CMT::init(const int8_t pin_sdio, const int8_t pin_clk, const
     _radio.reset(new CMT2300A(pin_sdio, pin_clk, pin_cs, pin_fcs));
 
     _radio->begin();
+    _currentChannel = 0xFF;
+    _currentPaLevel = INT8_MIN;
 
     setCountryMode(CountryModeId_t::MODE_EU);
     cmtSwitchDtuFreq(_inverterTargetFrequency); // start dtu at work freqency, for fast Rx if inverter is already on and frequency switched
 
     if (!_radio->isChipConnected()) {
-        Hoymiles.getMessageOutput()->println("CMT: Connection error!!");
+        HOY_LOG(RADIO, ERROR, "CMT: Connection error!!\r\n");
         return;
     }
-    Hoymiles.getMessageOutput()->println("CMT: Connection successful");
+    HOY_LOG(RADIO, INFO, "CMT: Connection successful\r\n");
 
     if (pin_gpio2 >= 0) {
         attachInterrupt(digitalPinToInterrupt(pin_gpio2), std::bind(&HoymilesRadio_CMT::handleInt1, this), RISING);
@@ -126,23 +140,23 @@ void HoymilesRadio_CMT::loop()
     }
 
     if (_packetReceived) {
-        Hoymiles.getMessageOutput()->println("Interrupt received");
+        HOY_LOG(RADIO, VERBOSE, "Interrupt received\r\n");
         while (_radio->available()) {
-            if (!(_rxBuffer.size() > FRAGMENT_BUFFER_SIZE)) {
-                fragment_t f;
-                memset(f.fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
-                f.len = _radio->getDynamicPayloadSize();
-                f.channel = _radio->getChannel();
-                f.rssi = _radio->getRssiDBm();
-                f.wasReceived = false;
-                f.mainCmd = 0x00;
-                if (f.len > MAX_RF_PAYLOAD_SIZE) {
-                    f.len = MAX_RF_PAYLOAD_SIZE;
+            fragment_t* f = _rxBuffer.prepare();
+            if (f != nullptr) {
+                memset(f->fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
+                f->len = _radio->getDynamicPayloadSize();
+                f->channel = _currentChannel;
+                f->rssi = _radio->getRssiDBm();
+                f->wasReceived = false;
+                f->mainCmd = 0x00;
+                if (f->len > MAX_RF_PAYLOAD_SIZE) {
+                    f->len = MAX_RF_PAYLOAD_SIZE;
                 }
-                _radio->read(f.fragment, f.len);
-                _rxBuffer.push(f);
+                _radio->read(f->fragment, f->len);
+                _rxBuffer.commit();
             } else {
-                Hoymiles.getMessageOutput()->println("CMT: Buffer full");
+                HOY_LOG(RADIO, WARN, "CMT: Buffer full\r\n");
                 _radio->flush_rx();
             }
         }
@@ -151,32 +165,38 @@ void HoymilesRadio_CMT::loop()
 
     } else {
         // Perform package parsing only if no packages are received
-        if (!_rxBuffer.empty()) {
-            fragment_t f = _rxBuffer.back();
-            if (checkFragmentCrc(f)) {
+        const fragment_t* f = _rxBuffer.front();
+        if (f != nullptr) {
+            Hoymiles.getRfCapture().addRx(RF_CAPTURE_CMT, *f);
+
+            if (checkFragmentCrc(*f)) {
 
                 const serial_u dtuId = convertSerialToRadioId(_dtuSerial);
 
                 // The CMT RF module does not filter foreign packages by itself.
                 // Has to be done manually here.
-                if (memcmp(&f.fragment[5], &dtuId.b[1], 4) == 0) {
+                if (memcmp(&f->fragment[5], &dtuId.b[1], 4) == 0) {
 
-                    std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterByFragment(f);
+                    InverterAbstract* inv = Hoymiles.findInverterByFragment(*f);
 
                     if (nullptr != inv) {
                         // Save packet in inverter rx buffer
-                        Hoymiles.getMessageOutput()->printf("RX %.2f MHz --> ", getFrequencyFromChannel(f.channel) / 1000000.0);
-                        dumpBuf(f.fragment, f.len, false);
-                        Hoymiles.getMessageOutput()->printf("| %d dBm\r\n", f.rssi);
-
-                        inv->addRxFragment(f.fragment, f.len);
+                        HOY_LOG(RADIO, DEBUG, "RX %.2f MHz --> ", getFrequencyFromChannel(f->channel) / 1000000.0);
+                        dumpBuf(f->fragment, f->len, false);
+                        HOY_LOG(RADIO, DEBUG, "| %d dBm\r\n", f->rssi);
+
+                        if (inv == _txInverter) {
+                            _rxRssiSum += f->rssi;
+                            _rxFragments++;
+                        }
+                        handleReceivedFragment(*inv, *f);
                     } else {
-                        Hoymiles.getMessageOutput()->println("Inverter Not found!");
+                        HOY_LOG(RADIO, WARN, "Inverter Not found!\r\n");
                     }
                 }
 
             } else {
-                Hoymiles.getMessageOutput()->println("Frame kaputt"); // ;-)
+                HOY_LOG(RADIO, WARN, "Frame kaputt\r\n"); // ;-)
             }
 
             // Remove paket from buffer even it was corrupted
@@ -189,14 +209,68 @@ void HoymilesRadio_CMT::loop()
 
 void HoymilesRadio_CMT::setPALevel(const int8_t paLevel)
 {
+    if (paLevel < CMT_PA_LEVEL_MIN || paLevel > CMT_PA_LEVEL_MAX) {
+        HOY_LOG(RADIO, ERROR, "CMT TX power %d dBm is not defined! (min: %d dBm, max: %d dBm)\r\n", paLevel, CMT_PA_LEVEL_MIN, CMT_PA_LEVEL_MAX);
+        return;
+    }
+
+    _paLevel = paLevel;
+    if (paLevel > countryDefinition.at(_countryMode).PaLevel_Legal_Max) {
+        HOY_LOG(RADIO, WARN, "!!! caution: CMT TX power %d dBm is above the region legal limit of %d dBm\r\n",
+            paLevel, countryDefinition.at(_countryMode).PaLevel_Legal_Max);
+    }
+
     if (!_isInitialized) {
         return;
     }
 
+    applyPALevel(paLevel);
+    HOY_LOG(RADIO, INFO, "CMT TX power set to %d dBm\r\n", paLevel);
+}
+
+int8_t HoymilesRadio_CMT::getPALevel() const
+{
+    return _paLevel;
+}
+
+void HoymilesRadio_CMT::setPALevelAdaptive(const bool adaptive)
+{
+    _paLevelAdaptive = adaptive;
+}
+
+bool HoymilesRadio_CMT::isPALevelAdaptive() const
+{
+    return _paLevelAdaptive;
+}
+
+int8_t HoymilesRadio_CMT::getPALevel(InverterAbstract& inv) const
+{
+    if (!_paLevelAdaptive) {
+        return _paLevel;
+    }
+
+    // The controller never exceeds the legal limit, even if a higher level is configured
+    const int8_t maxLevel = std::min(_paLevel, countryDefinition.at(_countryMode).PaLevel_Legal_Max);
+    return inv.TxPower()->getLevel(CMT_PA_LEVEL_MIN, maxLevel);
+}
+
+void HoymilesRadio_CMT::removeInverter(const InverterAbstract& inv)
+{
+    // The rx period ends without a result for the transmit power
+    if (_txInverter == &inv) {
+        _txInverter = nullptr;
+    }
+}
+
+void HoymilesRadio_CMT::applyPALevel(const int8_t paLevel)
+{
+    if (paLevel == _currentPaLevel) {
+        return;
+    }
+
     if (_radio->setPALevel(paLevel)) {
-        Hoymiles.getMessageOutput()->printf("CMT TX power set to %d dBm\r\n", paLevel);
-    } else {
-        Hoymiles.getMessageOutput()->printf("CMT TX power %d dBm is not defined! (min: -10 dBm, max: 20 dBm)\r\n", paLevel);
+        _currentPaLevel = paLevel;
+        _retuneStatistics.paLevelWrites++;
     }
 }
 
@@ -244,6 +318,15 @@ void HoymilesRadio_CMT::setCountryMode(const CountryModeId_t mode)
         return;
     }
     _radio->setFrequencyBand(countryDefinition.at(mode).Band);
+
+    // Changing the band loads the default register values
+    _currentChannel = 0xFF;
+    _currentPaLevel = INT8_MIN;
+}
+
+CmtRetuneStatistics_t HoymilesRadio_CMT::getRetuneStatistics() const
+{
+    return _retuneStatistics;
 }
 
 uint32_t HoymilesRadio_CMT::getInvBootFrequency() const
@@ -260,6 +343,7 @@ void ARDUINO_ISR_ATTR HoymilesRadio_CMT::handleInt1()
 void ARDUINO_ISR_ATTR HoymilesRadio_CMT::handleInt2()
 {
     _packetReceived = true;
+    Hoymiles.wakeupRadioTaskFromIsr();
 }
 
 void HoymilesRadio_CMT::sendEsbPacket(CommandAbstract& cmd)
@@ -274,15 +358,43 @@ void HoymilesRadio_CMT::sendEsbPacket(CommandAbstract& cmd)
         cmtSwitchDtuFreq(getInvBootFrequency());
     }
 
-    Hoymiles.getMessageOutput()->printf("TX %s %.2f MHz --> ",
-        cmd.getCommandName().c_str(), getFrequencyFromChannel(_radio->getChannel()) / 1000000.0);
-    cmd.dumpDataPayload(Hoymiles.getMessageOutput());
+    _txInverter = Hoymiles.findInverterBySerial(cmd.getTargetAddress());
+    applyPALevel(_txInverter != nullptr ? getPALevel(*_txInverter) : _paLevel);
+
+    HOY_LOG(RADIO, DEBUG, "TX %s %.2f MHz %d dBm --> ",
+        cmd.getCommandName().c_str(), getFrequencyFromChannel(_currentChannel) / 1000000.0, _currentPaLevel);
+    dumpBuf(cmd.getDataPayload(), cmd.getDataSize());
 
     if (!_radio->write(cmd.getDataPayload(), cmd.getDataSize())) {
-        Hoymiles.getMessageOutput()->println("TX SPI Timeout");
+        HOY_LOG(RADIO, ERROR, "TX SPI Timeout\r\n");
     }
+    Hoymiles.getRfCapture().addTx(RF_CAPTURE_CMT, _currentChannel, cmd.getDataPayload(), cmd.getDataSize());
     cmtSwitchDtuFreq(_inverterTargetFrequency);
     _radio->startListening();
     _busyFlag = true;
     _rxTimeout.set(cmd.getTimeout());
 }
+
+void HoymilesRadio_CMT::handleRxPeriodEnd()
+{
+    if (_txInverter == nullptr) {
+        return;
+    }
+
+    if (_paLevelAdaptive) {
+        const int8_t maxLevel = std::min(_paLevel, countryDefinition.at(_countryMode).PaLevel_Legal_Max);
+        const int8_t rssi = _rxFragments > 0 ? _rxRssiSum / _rxFragments : 0;
+        const int8_t before = getPALevel(*_txInverter);
+
+        _txInverter->TxPower()->addResult(_rxFragments > 0, rssi, std::max(maxLevel - CMT_PA_LEVEL_MIN, 0));
+
+        if (getPALevel(*_txInverter) != before) {
+            HOY_LOG(RADIO, INFO, "CMT TX power for %s set to %d dBm\r\n",
+                _txInverter->serialString().c_str(), getPALevel(*_txInverter));
+        }
+    }
+
+    _txInverter = nullptr;
+    _rxRssiSum = 0;
+    _rxFragments = 0;
+}
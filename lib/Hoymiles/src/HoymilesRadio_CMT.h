@@ -7,22 +7,20 @@
 #include <Arduino.h>
 #include <cmt2300wrapper.h>
 #include <memory>
-#include <queue>
 #include <vector>
 
-// number of fragments hold in buffer
-#define FRAGMENT_BUFFER_SIZE 30
-
 #ifndef HOYMILES_CMT_WORK_FREQ
 #define HOYMILES_CMT_WORK_FREQ 865000000
 #endif
 
-enum CountryModeId_t {
-    MODE_EU,
-    MODE_US,
-    MODE_BR,
-    CountryModeId_Max
-};
+// range of the CMT2300A transmit power (dBm)
+#define CMT_PA_LEVEL_MIN -10
+#define CMT_PA_LEVEL_MAX 20
+
+// adjust the transmit power per inverter by default
+#ifndef HOYMILES_CMT_PA_ADAPTIVE
+#define HOYMILES_CMT_PA_ADAPTIVE true
+#endif
 
 struct CountryFrequencyDefinition_t {
     FrequencyBand_t Band;
@@ -32,6 +30,7 @@ struct CountryFrequencyDefinition_t {
     uint32_t Freq_Legal_Max;
     uint32_t Freq_Default;
     uint32_t Freq_StartUp;
+    int8_t PaLevel_Legal_Max;
 };
 
 struct CountryFrequencyList_t {
@@ -39,11 +38,23 @@ struct CountryFrequencyList_t {
     CountryFrequencyDefinition_t definition;
 };
 
+struct CmtRetuneStatistics_t {
+    uint32_t retunes; // frequency changes written to the chip
+    uint32_t skipped; // frequency changes skipped because the chip was already tuned
+    uint32_t paLevelWrites; // transmit power changes written to the chip
+};
+
 class HoymilesRadio_CMT : public HoymilesRadio {
 public:
     void init(const int8_t pin_sdio, const int8_t pin_clk, const int8_t pin_cs, const int8_t pin_fcs, const int8_t pin_gpio2, const int8_t pin_gpio3);
     void loop();
     void setPALevel(const int8_t paLevel);
+    int8_t getPALevel() const;
+    // Lower the transmit power per inverter as long as the answers are strong enough
+    void setPALevelAdaptive(const bool adaptive);
+    bool isPALevelAdaptive() const;
+    // Transmit power used for inv within the configured and the legal limit
+    int8_t getPALevel(InverterAbstract& inv) const;
     void setInverterTargetFrequency(const uint32_t frequency);
     uint32_t getInverterTargetFrequency() const;
 
@@ -66,11 +77,17 @@ public:
 
     std::vector<CountryFrequencyList_t> getCountryFrequencyList() const;
 
+    CmtRetuneStatistics_t getRetuneStatistics() const;
+
+    void removeInverter(const InverterAbstract& inv);
+
 private:
     void ARDUINO_ISR_ATTR handleInt1();
     void ARDUINO_ISR_ATTR handleInt2();
 
     void sendEsbPacket(CommandAbstract& cmd);
+    void handleRxPeriodEnd();
+    void applyPALevel(const int8_t paLevel);
 
     std::unique_ptr<CMT2300A> _radio;
 
@@ -80,12 +97,25 @@ private:
     bool _gpio2_configured = false;
     bool _gpio3_configured = false;
 
-    std::queue<fragment_t> _rxBuffer;
     TimeoutHelper _txTimeout;
 
     uint32_t _inverterTargetFrequency = HOYMILES_CMT_WORK_FREQ;
 
     bool cmtSwitchDtuFreq(const uint32_t to_frequency);
 
-    CountryModeId_t _countryMode;
+    CountryModeId_t _countryMode = CountryModeId_t::MODE_EU;
+
+    // Register values written to the chip, avoids redundant SPI transfers
+    uint8_t _currentChannel = 0xFF;
+    int8_t _currentPaLevel = INT8_MIN;
+
+    int8_t _paLevel = 0;
+    bool _paLevelAdaptive = HOYMILES_CMT_PA_ADAPTIVE;
+
+    // Answers of the current rx period
+    InverterAbstract* _txInverter = nullptr;
+    int16_t _rxRssiSum = 0;
+    uint8_t _rxFragments = 0;
+
+    CmtRetuneStatistics_t _retuneStatistics = {};
 };
@@ -24,10 +24,10 @@ void HoymilesRadio_NRF::init(SPIClass* initialisedSpiBus, const uint8_t pinCE, c
     _radio->setRetries(0, 0);
     _radio->maskIRQ(true, true, false); // enable only receiving interrupts
     if (!_radio->isChipConnected()) {
-        Hoymiles.getMessageOutput()->println("NRF: Connection error!!");
+        HOY_LOG(RADIO, ERROR, "NRF: Connection error!!\r\n");
         return;
     }
-    Hoymiles.getMessageOutput()->println("NRF: Connection successful");
+    HOY_LOG(RADIO, INFO, "NRF: Connection successful\r\n");
 
     attachInterrupt(digitalPinToInterrupt(pinIRQ), std::bind(&HoymilesRadio_NRF::handleIntr, this), FALLING);
 
@@ -48,20 +48,20 @@ void HoymilesRadio_NRF::loop()
     }
 
     if (_packetReceived) {
-        Hoymiles.getMessageOutput()->println("Interrupt received");
+        HOY_LOG(RADIO, VERBOSE, "Interrupt received\r\n");
         while (_radio->available()) {
-            if (!(_rxBuffer.size() > FRAGMENT_BUFFER_SIZE)) {
-                fragment_t f;
-                memset(f.fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
-                f.len = _radio->getDynamicPayloadSize();
-                f.channel = _radio->getChannel();
-                f.rssi = _radio->testRPD() ? -30 : -80;
-                if (f.len > MAX_RF_PAYLOAD_SIZE)
-                    f.len = MAX_RF_PAYLOAD_SIZE;
-                _radio->read(f.fragment, f.len);
-                _rxBuffer.push(f);
+            fragment_t* f = _rxBuffer.prepare();
+            if (f != nullptr) {
+                memset(f->fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
+                f->len = _radio->getDynamicPayloadSize();
+                f->channel = _radio->getChannel();
+                f->rssi = _radio->testRPD() ? -30 : -80;
+                if (f->len > MAX_RF_PAYLOAD_SIZE)
+                    f->len = MAX_RF_PAYLOAD_SIZE;
+                _radio->read(f->fragment, f->len);
+                _rxBuffer.commit();
             } else {
-                Hoymiles.getMessageOutput()->println("NRF: Buffer full");
+                HOY_LOG(RADIO, WARN, "NRF: Buffer full\r\n");
                 _radio->flush_rx();
             }
         }
@@ -69,24 +69,27 @@ void HoymilesRadio_NRF::loop()
 
     } else {
         // Perform package parsing only if no packages are received
-        if (!_rxBuffer.empty()) {
-            fragment_t f = _rxBuffer.back();
-            if (checkFragmentCrc(f)) {
-                std::shared_ptr<InverterAbstract> inv = Hoymiles.getInverterByFragment(f);
+        const fragment_t* f = _rxBuffer.front();
+        if (f != nullptr) {
+            Hoymiles.getRfCapture().addRx(RF_CAPTURE_NRF, *f);
+
+            if (checkFragmentCrc(*f)) {
+                InverterAbstract* inv = Hoymiles.findInverterByFragment(*f);
 
                 if (nullptr != inv) {
                     // Save packet in inverter rx buffer
-                    Hoymiles.getMessageOutput()->printf("RX Channel: %d --> ", f.channel);
-                    dumpBuf(f.fragment, f.len, false);
-                    Hoymiles.getMessageOutput()->printf("| %d dBm\r\n", f.rssi);
+                    HOY_LOG(RADIO, DEBUG, "RX Channel: %d --> ", f->channel);
+                    dumpBuf(f->fragment, f->len, false);
+                    HOY_LOG(RADIO, DEBUG, "| %d dBm\r\n", f->rssi);
 
-                    inv->addRxFragment(f.fragment, f.len);
+                    _channelHopping.addRxFragment(*inv, *f);
+                    handleReceivedFragment(*inv, *f);
                 } else {
-                    Hoymiles.getMessageOutput()->println("Inverter Not found!");
+                    HOY_LOG(RADIO, WARN, "Inverter Not found!\r\n");
                 }
 
             } else {
-                Hoymiles.getMessageOutput()->println("Frame kaputt");
+                HOY_LOG(RADIO, WARN, "Frame kaputt\r\n");
             }
 
             // Remove paket from buffer even it was corrupted
@@ -146,26 +149,23 @@ void HoymilesRadio_NRF::openWritingPipe(const serial_u serial)
 void ARDUINO_ISR_ATTR HoymilesRadio_NRF::handleIntr()
 {
     _packetReceived = true;
+    Hoymiles.wakeupRadioTaskFromIsr();
 }
 
-uint8_t HoymilesRadio_NRF::getRxNxtChannel()
+const ChannelHopping& HoymilesRadio_NRF::getChannelHopping() const
 {
-    if (++_rxChIdx >= sizeof(_rxChLst))
-        _rxChIdx = 0;
-    return _rxChLst[_rxChIdx];
+    return _channelHopping;
 }
 
-uint8_t HoymilesRadio_NRF::getTxNxtChannel()
+void HoymilesRadio_NRF::removeInverter(const InverterAbstract& inv)
 {
-    if (++_txChIdx >= sizeof(_txChLst))
-        _txChIdx = 0;
-    return _txChLst[_txChIdx];
+    _channelHopping.removeInverter(inv);
 }
 
 void HoymilesRadio_NRF::switchRxCh()
 {
     _radio->stopListening();
-    _radio->setChannel(getRxNxtChannel());
+    _radio->setChannel(_channelHopping.getRxChannel());
     _radio->startListening();
 }
 
@@ -176,22 +176,28 @@ void HoymilesRadio_NRF::sendEsbPacket(CommandAbstract& cmd)
     cmd.setRouterAddress(DtuSerial().u64);
 
     _radio->stopListening();
-    _radio->setChannel(getTxNxtChannel());
+    _radio->setChannel(_channelHopping.getTxChannel(Hoymiles.findInverterBySerial(cmd.getTargetAddress())));
 
     serial_u s;
     s.u64 = cmd.getTargetAddress();
     openWritingPipe(s);
     _radio->setRetries(3, 15);
 
-    Hoymiles.getMessageOutput()->printf("TX %s Channel: %d --> ",
+    HOY_LOG(RADIO, DEBUG, "TX %s Channel: %d --> ",
         cmd.getCommandName().c_str(), _radio->getChannel());
-    cmd.dumpDataPayload(Hoymiles.getMessageOutput());
+    dumpBuf(cmd.getDataPayload(), cmd.getDataSize());
     _radio->write(cmd.getDataPayload(), cmd.getDataSize());
+    Hoymiles.getRfCapture().addTx(RF_CAPTURE_NRF, _radio->getChannel(), cmd.getDataPayload(), cmd.getDataSize());
 
     _radio->setRetries(0, 0);
     openReadingPipe();
-    _radio->setChannel(getRxNxtChannel());
+    _radio->setChannel(_channelHopping.getRxChannel());
     _radio->startListening();
     _busyFlag = true;
     _rxTimeout.set(cmd.getTimeout());
 }
+
+void HoymilesRadio_NRF::handleRxPeriodEnd()
+{
+    _channelHopping.finishRxPeriod();
+}
@@ -1,15 +1,12 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 
+#include "ChannelHopping.h"
 #include "HoymilesRadio.h"
 #include "commands/CommandAbstract.h"
 #include <RF24.h>
 #include <memory>
 #include <nRF24L01.h>
-#include <queue>
-
-// number of fragments hold in buffer
-#define FRAGMENT_BUFFER_SIZE 30
 
 class HoymilesRadio_NRF : public HoymilesRadio {
 public:
@@ -22,25 +19,23 @@ public:
     bool isConnected() const;
     bool isPVariant() const;
 
+    const ChannelHopping& getChannelHopping() const;
+
+    void removeInverter(const InverterAbstract& inv);
+
 private:
     void ARDUINO_ISR_ATTR handleIntr();
-    uint8_t getRxNxtChannel();
-    uint8_t getTxNxtChannel();
     void switchRxCh();
     void openReadingPipe();
     void openWritingPipe(const serial_u serial);
 
     void sendEsbPacket(CommandAbstract& cmd);
+    void handleRxPeriodEnd();
 
     std::unique_ptr<SPIClass> _spiPtr;
     std::unique_ptr<RF24> _radio;
-    uint8_t _rxChLst[5] = { 3, 23, 40, 61, 75 };
-    uint8_t _rxChIdx = 0;
-
-    uint8_t _txChLst[5] = { 3, 23, 40, 61, 75 };
-    uint8_t _txChIdx = 0;
+    ChannelHopping _channelHopping;
 
     volatile bool _packetReceived = false;
 
-    std::queue<fragment_t> _rxBuffer;
 };
\ No newline at end of file
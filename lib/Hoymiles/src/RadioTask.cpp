@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "RadioTask.h"
+
+bool RadioTask::start(std::function<bool()> loop, const BaseType_t core)
+{
+    if (isRunning()) {
+        return false;
+    }
+
+    _loop = loop;
+    _stopRequested = false;
+
+    TaskHandle_t handle = nullptr;
+    // The handle has to be valid before the first notification arrives
+    if (xTaskCreatePinnedToCore(taskFunction, "hoymiles", RADIO_TASK_STACK_SIZE, this, RADIO_TASK_PRIORITY, &handle, core) != pdPASS) {
+        return false;
+    }
+    _handle = handle;
+    return true;
+}
+
+void RadioTask::stop()
+{
+    if (!isRunning()) {
+        return;
+    }
+
+    _stopRequested = true;
+    notify();
+    while (isRunning()) {
+        delay(1);
+    }
+}
+
+bool RadioTask::isRunning() const
+{
+    return _handle.load() != nullptr;
+}
+
+void RadioTask::notify()
+{
+    const TaskHandle_t handle = _handle.load();
+    if (handle != nullptr) {
+        xTaskNotifyGive(handle);
+    }
+}
+
+void ARDUINO_ISR_ATTR RadioTask::notifyFromIsr()
+{
+    const TaskHandle_t handle = _handle.load();
+    if (handle != nullptr) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(handle, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
+}
+
+RadioTaskStatistics_t RadioTask::getStatistics() const
+{
+    RadioTaskStatistics_t statistics;
+    statistics.iterations = _iterations.load(std::memory_order_relaxed);
+    statistics.wakeups = _wakeups.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void RadioTask::taskFunction(void* param)
+{
+    static_cast<RadioTask*>(param)->run();
+}
+
+void RadioTask::run()
+{
+    while (!_stopRequested) {
+        const bool busy = _loop();
+        _iterations.fetch_add(1, std::memory_order_relaxed);
+
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(busy ? RADIO_TASK_BUSY_WAIT : RADIO_TASK_IDLE_WAIT)) > 0) {
+            _wakeups.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    _handle = nullptr;
+    vTaskDelete(nullptr);
+}
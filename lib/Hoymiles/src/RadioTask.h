@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+// stack of the radio task (bytes)
+#ifndef RADIO_TASK_STACK_SIZE
+#define RADIO_TASK_STACK_SIZE 4096
+#endif
+// above the Arduino loop task, below the network stack
+#ifndef RADIO_TASK_PRIORITY
+#define RADIO_TASK_PRIORITY 2
+#endif
+// longest sleep (ms) while a command is in flight, rx timeouts and channel hopping are polled
+#ifndef RADIO_TASK_BUSY_WAIT
+#define RADIO_TASK_BUSY_WAIT 1
+#endif
+// longest sleep (ms) while all radios are idle, the poll scheduler still has to run
+#ifndef RADIO_TASK_IDLE_WAIT
+#define RADIO_TASK_IDLE_WAIT 20
+#endif
+
+struct RadioTaskStatistics_t {
+    uint32_t iterations; // calls of the loop function
+    uint32_t wakeups; // sleeps ended early by a notification
+};
+
+/*
+ * Runs a loop function in its own FreeRTOS task instead of the cooperative
+ * main loop. The task sleeps between two iterations until it is notified by
+ * an interrupt or a new command, or until the wait time has elapsed.
+ * The native build provides the used FreeRTOS functions on top of std::thread.
+ */
+class RadioTask {
+public:
+    // loop: returns true while work is in flight. core: tskNO_AFFINITY or the core to pin the task to
+    bool start(std::function<bool()> loop, const BaseType_t core);
+    // Blocks until the current iteration is finished
+    void stop();
+    bool isRunning() const;
+
+    void notify();
+    void ARDUINO_ISR_ATTR notifyFromIsr();
+
+    RadioTaskStatistics_t getStatistics() const;
+
+private:
+    static void taskFunction(void* param);
+    void run();
+
+    std::function<bool()> _loop;
+    std::atomic<TaskHandle_t> _handle { nullptr };
+    std::atomic<bool> _stopRequested { false };
+
+    std::atomic<uint32_t> _iterations { 0 };
+    std::atomic<uint32_t> _wakeups { 0 };
+};
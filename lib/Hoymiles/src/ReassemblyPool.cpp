@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "ReassemblyPool.h"
+#include <cstring>
+
+ReassemblyBuffer_t* ReassemblyPool::lease()
+{
+    for (uint8_t i = 0; i < REASSEMBLY_POOL_SIZE; i++) {
+        if (!_leased[i]) {
+            _leased[i] = true;
+            memset(&_buffers[i], 0, sizeof(_buffers[i]));
+            return &_buffers[i];
+        }
+    }
+    return nullptr;
+}
+
+void ReassemblyPool::release(ReassemblyBuffer_t* buffer)
+{
+    for (uint8_t i = 0; i < REASSEMBLY_POOL_SIZE; i++) {
+        if (buffer == &_buffers[i]) {
+            _leased[i] = false;
+            return;
+        }
+    }
+}
+
+uint8_t ReassemblyPool::getLeasedCount() const
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < REASSEMBLY_POOL_SIZE; i++) {
+        count += _leased[i];
+    }
+    return count;
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+
+#define MAX_RF_FRAGMENT_COUNT 13
+
+// reassembly buffers per radio, only the command in flight needs one
+#ifndef REASSEMBLY_POOL_SIZE
+#define REASSEMBLY_POOL_SIZE 1
+#endif
+
+// Fragments of the response to the command in flight
+struct ReassemblyBuffer_t {
+    fragment_t fragments[MAX_RF_FRAGMENT_COUNT];
+    uint8_t maxPacketId; // fragment with the 0x80 flag, 0 until received
+    uint8_t lastPacketId; // highest fragment id received
+    uint8_t retransmitCnt; // retransmits requested for this response
+    uint8_t retransmitIds[MAX_RF_FRAGMENT_COUNT];
+    uint8_t retransmitCount;
+};
+
+class ReassemblyPool {
+public:
+    // Returns a cleared buffer or nullptr if all buffers are leased
+    ReassemblyBuffer_t* lease();
+    void release(ReassemblyBuffer_t* buffer);
+
+    uint8_t getLeasedCount() const;
+
+private:
+    ReassemblyBuffer_t _buffers[REASSEMBLY_POOL_SIZE];
+    bool _leased[REASSEMBLY_POOL_SIZE] = {};
+};
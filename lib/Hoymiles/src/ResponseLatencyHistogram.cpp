@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "ResponseLatencyHistogram.h"
+#include <algorithm>
+
+static constexpr uint32_t bucketLimits[RESPONSE_LATENCY_BUCKETS] = {
+    10, 20, 30, 40, 50, 75, 100, 150, 200, 300, 400, 500, 750, 1000, 2000, UINT32_MAX
+};
+
+void ResponseLatencyHistogram::addSample(const CommandLatencyClass_t latencyClass, const uint32_t latency)
+{
+    if (latencyClass >= CommandLatencyClass_Max) {
+        return;
+    }
+
+    uint8_t bucket = 0;
+    while (latency > bucketLimits[bucket]) {
+        bucket++;
+    }
+
+    uint16_t* buckets = _buckets[latencyClass];
+    buckets[bucket]++;
+
+    if (++_samples[latencyClass] >= RESPONSE_LATENCY_MAX_SAMPLES) {
+        _samples[latencyClass] = 0;
+        for (uint8_t i = 0; i < RESPONSE_LATENCY_BUCKETS; i++) {
+            buckets[i] /= 2;
+            _samples[latencyClass] += buckets[i];
+        }
+    }
+}
+
+void ResponseLatencyHistogram::clear()
+{
+    std::fill(&_buckets[0][0], &_buckets[0][0] + sizeof(_buckets) / sizeof(_buckets[0][0]), 0);
+    std::fill(_samples, _samples + CommandLatencyClass_Max, 0);
+}
+
+uint32_t ResponseLatencyHistogram::getTimeout(const CommandLatencyClass_t latencyClass, const uint32_t minTimeout, const uint32_t maxTimeout) const
+{
+    if (latencyClass >= CommandLatencyClass_Max || _samples[latencyClass] < RESPONSE_LATENCY_MIN_SAMPLES) {
+        return maxTimeout;
+    }
+
+    const uint32_t percentile = getPercentile(latencyClass, RESPONSE_TIMEOUT_PERCENTILE);
+    if (percentile == UINT32_MAX) {
+        return maxTimeout;
+    }
+
+    const uint32_t timeout = percentile * RESPONSE_TIMEOUT_MARGIN / 100;
+    return std::min(std::max(timeout, minTimeout), maxTimeout);
+}
+
+uint32_t ResponseLatencyHistogram::getPercentile(const CommandLatencyClass_t latencyClass, const uint8_t percentile) const
+{
+    if (latencyClass >= CommandLatencyClass_Max || _samples[latencyClass] == 0) {
+        return UINT32_MAX;
+    }
+
+    const uint32_t threshold = (static_cast<uint32_t>(_samples[latencyClass]) * percentile + 99) / 100;
+    uint32_t count = 0;
+    for (uint8_t i = 0; i < RESPONSE_LATENCY_BUCKETS; i++) {
+        count += _buckets[latencyClass][i];
+        if (count >= threshold) {
+            return bucketLimits[i];
+        }
+    }
+    return UINT32_MAX;
+}
+
+uint16_t ResponseLatencyHistogram::getSampleCount(const CommandLatencyClass_t latencyClass) const
+{
+    return latencyClass < CommandLatencyClass_Max ? _samples[latencyClass] : 0;
+}
+
+uint16_t ResponseLatencyHistogram::getBucketCount(const CommandLatencyClass_t latencyClass, const uint8_t bucket) const
+{
+    if (latencyClass >= CommandLatencyClass_Max || bucket >= RESPONSE_LATENCY_BUCKETS) {
+        return 0;
+    }
+    return _buckets[latencyClass][bucket];
+}
+
+uint32_t ResponseLatencyHistogram::getBucketLimit(const uint8_t bucket)
+{
+    return bucket < RESPONSE_LATENCY_BUCKETS ? bucketLimits[bucket] : UINT32_MAX;
+}
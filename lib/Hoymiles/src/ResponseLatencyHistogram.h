@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "commands/CommandAbstract.h"
+#include <cstdint>
+
+#define RESPONSE_LATENCY_BUCKETS 16
+
+// default bounds (ms) of the learned timeouts, see HoymilesClass::setRxTimeoutBounds
+#ifndef RESPONSE_TIMEOUT_MIN
+#define RESPONSE_TIMEOUT_MIN 150
+#endif
+#ifndef RESPONSE_TIMEOUT_MAX
+#define RESPONSE_TIMEOUT_MAX 2000
+#endif
+
+// percentile of the learned latencies used to derive the timeout
+#ifndef RESPONSE_TIMEOUT_PERCENTILE
+#define RESPONSE_TIMEOUT_PERCENTILE 98
+#endif
+// timeout = percentile * margin (in percent)
+#ifndef RESPONSE_TIMEOUT_MARGIN
+#define RESPONSE_TIMEOUT_MARGIN 150
+#endif
+// samples per latency class required before the learned timeout is used
+#ifndef RESPONSE_LATENCY_MIN_SAMPLES
+#define RESPONSE_LATENCY_MIN_SAMPLES 20
+#endif
+// all buckets are halved when a class reaches this amount of samples, older samples fade out
+#ifndef RESPONSE_LATENCY_MAX_SAMPLES
+#define RESPONSE_LATENCY_MAX_SAMPLES 1000
+#endif
+
+/*
+ * Histogram of the time between sending a command and receiving its complete
+ * answer, per latency class of one inverter. Used to replace the static
+ * command timeout by a learned one.
+ */
+class ResponseLatencyHistogram {
+public:
+    void addSample(const CommandLatencyClass_t latencyClass, const uint32_t latency);
+    void clear();
+
+    // Returns the learned timeout within minTimeout and maxTimeout or
+    // maxTimeout if not enough samples are available
+    uint32_t getTimeout(const CommandLatencyClass_t latencyClass, const uint32_t minTimeout, const uint32_t maxTimeout) const;
+
+    // Upper limit of the bucket which contains the percentile, UINT32_MAX if it is the overflow bucket
+    uint32_t getPercentile(const CommandLatencyClass_t latencyClass, const uint8_t percentile) const;
+
+    uint16_t getSampleCount(const CommandLatencyClass_t latencyClass) const;
+    uint16_t getBucketCount(const CommandLatencyClass_t latencyClass, const uint8_t bucket) const;
+
+    // Upper limit (ms) of the bucket, UINT32_MAX for the last one
+    static uint32_t getBucketLimit(const uint8_t bucket);
+
+private:
+    uint16_t _buckets[CommandLatencyClass_Max][RESPONSE_LATENCY_BUCKETS] = {};
+    uint16_t _samples[CommandLatencyClass_Max] = {};
+};
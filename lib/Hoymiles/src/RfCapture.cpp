@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "RfCapture.h"
+#include <Arduino.h>
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+bool RfCapture::begin(const uint32_t size)
+{
+    end();
+
+    // A power of two keeps the free running positions valid after their overflow
+    uint32_t bufferSize = 1;
+    while (bufferSize <= size / 2) {
+        bufferSize <<= 1;
+    }
+    if (bufferSize < sizeof(RfCaptureRecord_t) + MAX_RF_PAYLOAD_SIZE) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _buffer.reset(new (std::nothrow) uint8_t[bufferSize]);
+    if (_buffer == nullptr) {
+        return false;
+    }
+    _size = bufferSize;
+    _head = _tail = 0;
+    _records = _overwritten = 0;
+    _enabled = true;
+    return true;
+}
+
+void RfCapture::end()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _enabled = false;
+    _buffer.reset();
+    _size = 0;
+    _head = _tail = 0;
+    _records = 0;
+}
+
+bool RfCapture::isEnabled() const
+{
+    return _enabled;
+}
+
+void RfCapture::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tail = _head;
+    _records = _overwritten = 0;
+}
+
+void RfCapture::addTx(const RfCaptureRadio_t radio, const uint8_t channel, const uint8_t data[], const uint8_t len)
+{
+    if (!_enabled) {
+        return;
+    }
+
+    RfCaptureRecord_t record;
+    record.micros = micros();
+    record.flags = RF_CAPTURE_FLAG_TX | (radio << RF_CAPTURE_RADIO_SHIFT);
+    record.channel = channel;
+    record.rssi = 0;
+    record.len = len;
+    add(record, data);
+}
+
+void RfCapture::addRx(const RfCaptureRadio_t radio, const fragment_t& fragment)
+{
+    if (!_enabled) {
+        return;
+    }
+
+    RfCaptureRecord_t record;
+    record.micros = micros();
+    record.flags = radio << RF_CAPTURE_RADIO_SHIFT;
+    record.channel = fragment.channel;
+    record.rssi = fragment.rssi;
+    record.len = fragment.len;
+    add(record, fragment.fragment);
+}
+
+void RfCapture::add(const RfCaptureRecord_t& record, const uint8_t data[])
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const uint32_t recordSize = sizeof(RfCaptureRecord_t) + record.len;
+    if (_buffer == nullptr || recordSize > _size) {
+        return;
+    }
+
+    // Drop the oldest records until the new one fits
+    while (_head + recordSize - _tail > _size) {
+        RfCaptureRecord_t oldest;
+        copyOut(_tail, &oldest, sizeof(oldest));
+        _tail += sizeof(RfCaptureRecord_t) + oldest.len;
+        _records--;
+        _overwritten++;
+    }
+
+    copyIn(_head, &record, sizeof(record));
+    copyIn(_head + sizeof(record), data, record.len);
+    _head += recordSize;
+    _records++;
+}
+
+uint32_t RfCapture::getStartPosition() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _tail;
+}
+
+uint32_t RfCapture::getEndPosition() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _head;
+}
+
+size_t RfCapture::read(uint32_t& position, const uint32_t end, uint8_t buffer[], const size_t maxLen) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_buffer == nullptr) {
+        return 0;
+    }
+
+    if (static_cast<int32_t>(position - _tail) < 0) {
+        position = _tail;
+    }
+
+    size_t written = 0;
+    while (position != _head && static_cast<int32_t>(end - position) > 0) {
+        RfCaptureRecord_t record;
+        copyOut(position, &record, sizeof(record));
+        const size_t recordSize = sizeof(record) + record.len;
+        if (written + recordSize > maxLen) {
+            break;
+        }
+
+        copyOut(position, &buffer[written], recordSize);
+        written += recordSize;
+        position += recordSize;
+    }
+    return written;
+}
+
+size_t RfCapture::writeHeader(uint8_t buffer[], const size_t maxLen, const uint64_t serials[], const uint8_t count)
+{
+    const size_t len = sizeof(RfCaptureHeader_t) + count * sizeof(uint64_t);
+    if (len > maxLen) {
+        return 0;
+    }
+
+    RfCaptureHeader_t header;
+    memcpy(header.magic, RF_CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = RF_CAPTURE_VERSION;
+    header.inverterCount = count;
+    header.reserved = 0;
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(&buffer[sizeof(header)], serials, count * sizeof(uint64_t));
+    return len;
+}
+
+RfCaptureStatistics_t RfCapture::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    RfCaptureStatistics_t statistics;
+    statistics.size = _size;
+    statistics.used = _head - _tail;
+    statistics.records = _records;
+    statistics.overwritten = _overwritten;
+    return statistics;
+}
+
+void RfCapture::copyIn(const uint32_t position, const void* data, const size_t len)
+{
+    const uint32_t offset = position & (_size - 1);
+    const size_t first = std::min<size_t>(len, _size - offset);
+    memcpy(&_buffer[offset], data, first);
+    memcpy(&_buffer[0], static_cast<const uint8_t*>(data) + first, len - first);
+}
+
+void RfCapture::copyOut(const uint32_t position, void* data, const size_t len) const
+{
+    const uint32_t offset = position & (_size - 1);
+    const size_t first = std::min<size_t>(len, _size - offset);
+    memcpy(data, &_buffer[offset], first);
+    memcpy(static_cast<uint8_t*>(data) + first, &_buffer[0], len - first);
+}
@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#define RF_CAPTURE_MAGIC "HMRF"
+#define RF_CAPTURE_VERSION 1
+
+#define RF_CAPTURE_FLAG_TX 0x01
+#define RF_CAPTURE_RADIO_SHIFT 1
+
+enum RfCaptureRadio_t : uint8_t {
+    RF_CAPTURE_NRF,
+    RF_CAPTURE_CMT,
+    RF_CAPTURE_SIM,
+};
+
+/*
+ * Capture file format (little endian):
+ *   RfCaptureHeader_t
+ *   inverterCount * uint64_t serial of the configured inverters
+ *   records: RfCaptureRecord_t followed by len bytes of the packet
+ */
+struct RfCaptureHeader_t {
+    char magic[4];
+    uint8_t version;
+    uint8_t inverterCount;
+    uint16_t reserved;
+};
+
+struct RfCaptureRecord_t {
+    uint32_t micros; // time of the transmission or of processing the received fragment
+    uint8_t flags; // RF_CAPTURE_FLAG_TX | radio << RF_CAPTURE_RADIO_SHIFT
+    uint8_t channel; // NRF: RF channel, CMT: channel index (see HoymilesRadio_CMT::getFrequencyFromChannel)
+    int8_t rssi; // dBm, 0 for transmitted packets
+    uint8_t len;
+};
+
+static_assert(sizeof(RfCaptureHeader_t) == 8, "Unexpected padding");
+static_assert(sizeof(RfCaptureRecord_t) == 8, "Unexpected padding");
+
+struct RfCaptureStatistics_t {
+    uint32_t size; // bytes
+    uint32_t used; // bytes
+    uint32_t records; // records in the buffer
+    uint32_t overwritten; // oldest records dropped to make room for new ones
+};
+
+/*
+ * Ring buffer of every transmitted command and received fragment of all radios.
+ * The oldest records are overwritten. Records are added by the radio loop and
+ * read (e.g. by the web server) from any task.
+ */
+class RfCapture {
+public:
+    // Allocates the buffer (size is rounded down to a power of two) and starts capturing
+    bool begin(const uint32_t size);
+    // Stops capturing and frees the buffer
+    void end();
+    bool isEnabled() const;
+    void clear();
+
+    void addTx(const RfCaptureRadio_t radio, const uint8_t channel, const uint8_t data[], const uint8_t len);
+    void addRx(const RfCaptureRadio_t radio, const fragment_t& fragment);
+
+    // Positions are free running byte offsets
+    uint32_t getStartPosition() const;
+    uint32_t getEndPosition() const;
+
+    // Copies the complete records between position and end which fit into buffer and advances position.
+    // Records which have been overwritten in the meantime are skipped. Returns 0 at the end
+    // and if the next record does not fit into buffer.
+    size_t read(uint32_t& position, const uint32_t end, uint8_t buffer[], const size_t maxLen) const;
+
+    // Returns the length of the file header or 0 if it does not fit
+    static size_t writeHeader(uint8_t buffer[], const size_t maxLen, const uint64_t serials[], const uint8_t count);
+
+    RfCaptureStatistics_t getStatistics() const;
+
+private:
+    void add(const RfCaptureRecord_t& record, const uint8_t data[]);
+    void copyIn(const uint32_t position, const void* data, const size_t len);
+    void copyOut(const uint32_t position, void* data, const size_t len) const;
+
+    mutable std::mutex _mutex;
+    std::unique_ptr<uint8_t[]> _buffer;
+    uint32_t _size = 0;
+    uint32_t _head = 0; // position of the next record
+    uint32_t _tail = 0; // position of the oldest record
+    uint32_t _records = 0;
+    uint32_t _overwritten = 0;
+
+    // Checked without lock by the radios
+    std::atomic<bool> _enabled { false };
+};
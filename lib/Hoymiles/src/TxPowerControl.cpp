@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "TxPowerControl.h"
+#include <algorithm>
+
+void TxPowerControl::addResult(const bool answered, const int8_t rssi, const uint8_t maxAttenuation)
+{
+    uint8_t attenuation = std::min(_attenuation, maxAttenuation);
+
+    if (!answered) {
+        // A lost request costs a complete rx period, react fast
+        _goodAnswers = 0;
+        attenuation = attenuation > TX_POWER_STEP_UP_LOST ? attenuation - TX_POWER_STEP_UP_LOST : 0;
+
+    } else if (rssi < TX_POWER_RSSI_TARGET) {
+        _goodAnswers = 0;
+        attenuation = attenuation > 0 ? attenuation - 1 : 0;
+
+    } else if (rssi >= TX_POWER_RSSI_TARGET + TX_POWER_RSSI_MARGIN) {
+        if (++_goodAnswers >= TX_POWER_STEP_DOWN_AFTER) {
+            _goodAnswers = 0;
+            attenuation = std::min<uint8_t>(attenuation + 1, maxAttenuation);
+        }
+
+    } else {
+        _goodAnswers = 0;
+    }
+
+    if (attenuation != _attenuation) {
+        _attenuation = attenuation;
+        _changeCount++;
+    }
+}
+
+void TxPowerControl::reset()
+{
+    _attenuation = 0;
+    _goodAnswers = 0;
+}
+
+int8_t TxPowerControl::getLevel(const int8_t minLevel, const int8_t maxLevel) const
+{
+    return std::max<int>(maxLevel - _attenuation, minLevel);
+}
+
+uint8_t TxPowerControl::getAttenuation() const
+{
+    return _attenuation;
+}
+
+uint32_t TxPowerControl::getChangeCount() const
+{
+    return _changeCount;
+}
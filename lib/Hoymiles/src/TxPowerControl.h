@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+// answers weaker than this (dBm) increase the transmit power
+#ifndef TX_POWER_RSSI_TARGET
+#define TX_POWER_RSSI_TARGET -80
+#endif
+// the transmit power is only lowered while the answers are this much (dB) above the target
+#ifndef TX_POWER_RSSI_MARGIN
+#define TX_POWER_RSSI_MARGIN 6
+#endif
+// consecutive good answers before the transmit power is lowered by 1 dB
+#ifndef TX_POWER_STEP_DOWN_AFTER
+#define TX_POWER_STEP_DOWN_AFTER 10
+#endif
+// increase (dB) after a transmission which was not answered at all
+#ifndef TX_POWER_STEP_UP_LOST
+#define TX_POWER_STEP_UP_LOST 3
+#endif
+
+/*
+ * Transmit power of one inverter as attenuation below the maximum allowed
+ * level. The path loss is assumed to be symmetric, the rssi of the answers
+ * shows how much the transmit power can be lowered without losing requests.
+ */
+class TxPowerControl {
+public:
+    // maxAttenuation: difference between the highest and the lowest possible level (dB)
+    void addResult(const bool answered, const int8_t rssi, const uint8_t maxAttenuation);
+    void reset();
+
+    // Returns the level within minLevel and maxLevel (dBm)
+    int8_t getLevel(const int8_t minLevel, const int8_t maxLevel) const;
+    uint8_t getAttenuation() const;
+    uint32_t getChangeCount() const;
+
+private:
+    uint8_t _attenuation = 0;
+    uint8_t _goodAnswers = 0;
+    uint32_t _changeCount = 0;
+};
@@ -47,6 +47,12 @@ String ActivePowerControlCommand::getCommandName() const
     return "ActivePowerControl";
 }
 
+uint16_t ActivePowerControlCommand::getCoalesceKey() const
+{
+    // Only the last limit is relevant
+    return (_payload[0] << 8) | 0x0b;
+}
+
 void ActivePowerControlCommand::setActivePowerLimit(const float limit, const PowerLimitControlType type)
 {
     const uint16_t l = limit * 10;
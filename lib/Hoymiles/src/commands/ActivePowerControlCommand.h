@@ -19,6 +19,8 @@ public:
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id);
     virtual void gotTimeout(InverterAbstract& inverter);
 
+    virtual uint16_t getCoalesceKey() const;
+
     void setActivePowerLimit(const float limit, const PowerLimitControlType type = RelativNonPersistent);
     float getLimit() const;
     PowerLimitControlType getType();
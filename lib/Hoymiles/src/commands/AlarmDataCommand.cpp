@@ -60,4 +60,14 @@ bool AlarmDataCommand::handleResponse(InverterAbstract& inverter, const fragment
 void AlarmDataCommand::gotTimeout(InverterAbstract& inverter)
 {
     inverter.EventLog()->setLastAlarmRequestSuccess(CMD_NOK);
-}
\ No newline at end of file
+}
+
+CommandPriority_t AlarmDataCommand::getPriority() const
+{
+    return PRIO_REALTIME;
+}
+
+CommandLatencyClass_t AlarmDataCommand::getLatencyClass() const
+{
+    return LATENCY_ALARM;
+}
@@ -11,4 +11,7 @@ public:
 
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id);
     virtual void gotTimeout(InverterAbstract& inverter);
+
+    virtual CommandPriority_t getPriority() const;
+    virtual CommandLatencyClass_t getLatencyClass() const;
 };
\ No newline at end of file
@@ -77,3 +77,14 @@ uint8_t ChannelChangeCommand::getMaxResendCount()
     // This command will never retrieve an answer. Therefor it's not required to repeat it
     return 0;
 }
+
+uint16_t ChannelChangeCommand::getCoalesceKey() const
+{
+    return _payload[0] << 8;
+}
+
+CommandPriority_t ChannelChangeCommand::getPriority() const
+{
+    // Has to be sent before the data requests if the inverter is not reachable
+    return PRIO_CONTROL;
+}
@@ -2,7 +2,6 @@
 #pragma once
 
 #include "CommandAbstract.h"
-#include "../HoymilesRadio_CMT.h"
 
 class ChannelChangeCommand : public CommandAbstract {
 public:
@@ -18,4 +17,8 @@ public:
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id);
 
     virtual uint8_t getMaxResendCount();
+
+    virtual uint16_t getCoalesceKey() const;
+
+    virtual CommandPriority_t getPriority() const;
 };
@@ -112,6 +112,21 @@ CommandAbstract* CommandAbstract::getRequestFrameCommand(const uint8_t frame_no)
     return nullptr;
 }
 
+uint16_t CommandAbstract::getCoalesceKey() const
+{
+    return 0;
+}
+
+CommandPriority_t CommandAbstract::getPriority() const
+{
+    return PRIO_METADATA;
+}
+
+CommandLatencyClass_t CommandAbstract::getLatencyClass() const
+{
+    return CommandLatencyClass_Max;
+}
+
 void CommandAbstract::convertSerialToPacketId(uint8_t buffer[], const uint64_t serial)
 {
     serial_u s;
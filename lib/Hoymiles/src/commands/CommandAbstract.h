@@ -9,6 +9,24 @@
 #define MAX_RESEND_COUNT 4 // Used if all packages are missing
 #define MAX_RETRANSMIT_COUNT 5 // Used to send the retransmit package
 
+// Queued commands are sent in this order
+enum CommandPriority_t {
+    PRIO_CONTROL, // Changes the inverter state (limit, power, channel)
+    PRIO_REALTIME, // Realtime data and alarms
+    PRIO_METADATA, // Slow changing data like device info or grid profile
+    CommandPriority_Max
+};
+
+// Commands grouped by their expected answer. The response latency is learned per group and inverter.
+enum CommandLatencyClass_t {
+    LATENCY_REALTIME, // Realtime data
+    LATENCY_ALARM, // Alarm log
+    LATENCY_DEVINFO, // Device info
+    LATENCY_CONFIG, // System config and grid profile
+    LATENCY_CONTROL, // Single fragment answer of DevControl and ParaSet
+    CommandLatencyClass_Max // Not learned (no or partial answer)
+};
+
 class InverterAbstract;
 
 class CommandAbstract {
@@ -38,6 +56,14 @@ public:
 
     virtual CommandAbstract* getRequestFrameCommand(const uint8_t frame_no);
 
+    // Queued commands with the same target and the same key are replaced by the newer one.
+    // 0 means the command is always appended to the queue.
+    virtual uint16_t getCoalesceKey() const;
+
+    virtual CommandPriority_t getPriority() const;
+
+    virtual CommandLatencyClass_t getLatencyClass() const;
+
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id) = 0;
     virtual void gotTimeout(InverterAbstract& inverter);
 
@@ -58,4 +84,10 @@ protected:
 
 private:
     static void convertSerialToPacketId(uint8_t buffer[], const uint64_t serial);
+
+    // Managed by CommandQueue
+    friend class CommandQueue;
+    CommandAbstract* _next = nullptr;
+    int8_t _poolSlot = -1;
+    uint32_t _queueTime = 0;
 };
\ No newline at end of file
@@ -39,6 +39,11 @@ void DevControlCommand::udpateCRC(const uint8_t len)
     _payload[10 + len + 1] = (uint8_t)(crc);
 }
 
+CommandPriority_t DevControlCommand::getPriority() const
+{
+    return PRIO_CONTROL;
+}
+
 bool DevControlCommand::handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id)
 {
     for (uint8_t i = 0; i < max_fragment_id; i++) {
@@ -48,4 +53,9 @@ bool DevControlCommand::handleResponse(InverterAbstract& inverter, const fragmen
     }
 
     return true;
+}
+
+CommandLatencyClass_t DevControlCommand::getLatencyClass() const
+{
+    return LATENCY_CONTROL;
 }
\ No newline at end of file
@@ -9,6 +9,9 @@ public:
 
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id);
 
+    virtual CommandPriority_t getPriority() const;
+    virtual CommandLatencyClass_t getLatencyClass() const;
+
 protected:
     void udpateCRC(const uint8_t len);
 };
\ No newline at end of file
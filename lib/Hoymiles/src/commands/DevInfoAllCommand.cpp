@@ -52,4 +52,9 @@ bool DevInfoAllCommand::handleResponse(InverterAbstract& inverter, const fragmen
     inverter.DevInfo()->endAppendFragment();
     inverter.DevInfo()->setLastUpdateAll(millis());
     return true;
+}
+
+CommandLatencyClass_t DevInfoAllCommand::getLatencyClass() const
+{
+    return LATENCY_DEVINFO;
 }
\ No newline at end of file
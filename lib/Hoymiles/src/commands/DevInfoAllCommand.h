@@ -10,4 +10,6 @@ public:
     virtual String getCommandName() const;
 
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id);
+
+    virtual CommandLatencyClass_t getLatencyClass() const;
 };
\ No newline at end of file
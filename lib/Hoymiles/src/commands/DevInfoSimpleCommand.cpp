@@ -52,4 +52,9 @@ bool DevInfoSimpleCommand::handleResponse(InverterAbstract& inverter, const frag
     inverter.DevInfo()->endAppendFragment();
     inverter.DevInfo()->setLastUpdateSimple(millis());
     return true;
+}
+
+CommandLatencyClass_t DevInfoSimpleCommand::getLatencyClass() const
+{
+    return LATENCY_DEVINFO;
 }
\ No newline at end of file
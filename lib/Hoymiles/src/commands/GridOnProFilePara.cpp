@@ -53,4 +53,9 @@ bool GridOnProFilePara::handleResponse(InverterAbstract& inverter, const fragmen
     inverter.GridProfile()->endAppendFragment();
     inverter.GridProfile()->setLastUpdate(millis());
     return true;
+}
+
+CommandLatencyClass_t GridOnProFilePara::getLatencyClass() const
+{
+    return LATENCY_CONFIG;
 }
\ No newline at end of file
@@ -85,6 +85,12 @@ CommandAbstract* MultiDataCommand::getRequestFrameCommand(const uint8_t frame_no
     return &_cmdRequestFrame;
 }
 
+uint16_t MultiDataCommand::getCoalesceKey() const
+{
+    // Requests of the same data type return the same data
+    return (_payload[0] << 8) | getDataType();
+}
+
 bool MultiDataCommand::handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id)
 {
     // All fragments are available --> Check CRC
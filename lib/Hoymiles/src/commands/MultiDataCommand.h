@@ -14,6 +14,8 @@ public:
 
     CommandAbstract* getRequestFrameCommand(const uint8_t frame_no);
 
+    virtual uint16_t getCoalesceKey() const;
+
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id);
 
 protected:
@@ -8,4 +8,14 @@ ParaSetCommand::ParaSetCommand(const uint64_t target_address, const uint64_t rou
     : CommandAbstract(target_address, router_address)
 {
     _payload[0] = 0x52;
-}
\ No newline at end of file
+}
+
+CommandPriority_t ParaSetCommand::getPriority() const
+{
+    return PRIO_CONTROL;
+}
+
+CommandLatencyClass_t ParaSetCommand::getLatencyClass() const
+{
+    return LATENCY_CONTROL;
+}
@@ -6,4 +6,7 @@
 class ParaSetCommand : public CommandAbstract {
 public:
     explicit ParaSetCommand(const uint64_t target_address = 0, const uint64_t router_address = 0);
+
+    virtual CommandPriority_t getPriority() const;
+    virtual CommandLatencyClass_t getLatencyClass() const;
 };
\ No newline at end of file
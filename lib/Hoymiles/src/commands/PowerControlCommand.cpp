@@ -60,6 +60,12 @@ void PowerControlCommand::gotTimeout(InverterAbstract& inverter)
     inverter.PowerCommand()->setLastPowerCommandSuccess(CMD_NOK);
 }
 
+uint16_t PowerControlCommand::getCoalesceKey() const
+{
+    // Turn on, turn off and restart replace each other, only the last one is relevant
+    return (_payload[0] << 8) | 0x00;
+}
+
 void PowerControlCommand::setPowerOn(const bool state)
 {
     if (state) {
@@ -12,6 +12,8 @@ public:
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id);
     virtual void gotTimeout(InverterAbstract& inverter);
 
+    virtual uint16_t getCoalesceKey() const;
+
     void setPowerOn(const bool state);
     void setRestart();
 };
\ No newline at end of file
@@ -48,7 +48,7 @@ bool RealTimeRunDataCommand::handleResponse(InverterAbstract& inverter, const fr
     const uint8_t fragmentsSize = getTotalFragmentSize(fragment, max_fragment_id);
     const uint8_t expectedSize = inverter.Statistics()->getExpectedByteCount();
     if (fragmentsSize < expectedSize) {
-        Hoymiles.getMessageOutput()->printf("ERROR in %s: Received fragment size: %d, min expected size: %d\r\n",
+        HOY_LOG(INVERTER, ERROR, "ERROR in %s: Received fragment size: %d, min expected size: %d\r\n",
             getCommandName().c_str(), fragmentsSize, expectedSize);
 
         return false;
@@ -71,4 +71,14 @@ bool RealTimeRunDataCommand::handleResponse(InverterAbstract& inverter, const fr
 void RealTimeRunDataCommand::gotTimeout(InverterAbstract& inverter)
 {
     inverter.Statistics()->incrementRxFailureCount();
-}
\ No newline at end of file
+}
+
+CommandPriority_t RealTimeRunDataCommand::getPriority() const
+{
+    return PRIO_REALTIME;
+}
+
+CommandLatencyClass_t RealTimeRunDataCommand::getLatencyClass() const
+{
+    return LATENCY_REALTIME;
+}
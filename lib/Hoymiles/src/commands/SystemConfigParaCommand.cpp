@@ -48,7 +48,7 @@ bool SystemConfigParaCommand::handleResponse(InverterAbstract& inverter, const f
     const uint8_t fragmentsSize = getTotalFragmentSize(fragment, max_fragment_id);
     const uint8_t expectedSize = inverter.SystemConfigPara()->getExpectedByteCount();
     if (fragmentsSize < expectedSize) {
-        Hoymiles.getMessageOutput()->printf("ERROR in %s: Received fragment size: %d, min expected size: %d\r\n",
+        HOY_LOG(INVERTER, ERROR, "ERROR in %s: Received fragment size: %d, min expected size: %d\r\n",
             getCommandName().c_str(), fragmentsSize, expectedSize);
 
         return false;
@@ -71,4 +71,9 @@ bool SystemConfigParaCommand::handleResponse(InverterAbstract& inverter, const f
 void SystemConfigParaCommand::gotTimeout(InverterAbstract& inverter)
 {
     inverter.SystemConfigPara()->setLastLimitRequestSuccess(CMD_NOK);
+}
+
+CommandLatencyClass_t SystemConfigParaCommand::getLatencyClass() const
+{
+    return LATENCY_CONFIG;
 }
\ No newline at end of file
@@ -11,4 +11,6 @@ public:
 
     virtual bool handleResponse(InverterAbstract& inverter, const fragment_t fragment[], const uint8_t max_fragment_id);
     virtual void gotTimeout(InverterAbstract& inverter);
+
+    virtual CommandLatencyClass_t getLatencyClass() const;
 };
\ No newline at end of file
@@ -3,8 +3,64 @@
  * Copyright (C) 2022 Thomas Basler and others
  */
 #include "crc.h"
+#include <array>
 
-uint8_t crc8(const uint8_t buf[], const uint8_t len)
+// All tables are generated at compile time and end up in flash (rodata)
+namespace {
+
+constexpr std::array<uint8_t, 256> makeCrc8Table()
+{
+    std::array<uint8_t, 256> table {};
+    for (uint16_t i = 0; i < 256; i++) {
+        uint8_t crc = i;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc << 1) ^ ((crc & 0x80) ? CRC8_POLY : 0x00);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+// Reflected (LSB first) polynom. table[k][i] contains the crc of byte i followed by k zero bytes
+constexpr std::array<std::array<uint16_t, 256>, 4> makeCrc16ModbusTable()
+{
+    std::array<std::array<uint16_t, 256>, 4> table {};
+    for (uint16_t i = 0; i < 256; i++) {
+        uint16_t crc = i;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x0001) ? ((crc >> 1) ^ CRC16_MODBUS_POLYNOM) : (crc >> 1);
+        }
+        table[0][i] = crc;
+    }
+    for (uint8_t k = 1; k < 4; k++) {
+        for (uint16_t i = 0; i < 256; i++) {
+            table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xff];
+        }
+    }
+    return table;
+}
+
+// Normal (MSB first) polynom
+constexpr std::array<uint16_t, 256> makeCrc16Nrf24Table()
+{
+    std::array<uint16_t, 256> table {};
+    for (uint16_t i = 0; i < 256; i++) {
+        uint16_t crc = i << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ CRC16_NRF24_POLYNOM) : (crc << 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr auto crc8Table = makeCrc8Table();
+constexpr auto crc16ModbusTable = makeCrc16ModbusTable();
+constexpr auto crc16Nrf24Table = makeCrc16Nrf24Table();
+
+}
+
+uint8_t crc8_bitwise(const uint8_t buf[], const uint8_t len)
 {
     uint8_t crc = CRC8_INIT;
     for (uint8_t i = 0; i < len; i++) {
@@ -16,7 +72,16 @@ uint8_t crc8(const uint8_t buf[], const uint8_t len)
     return crc;
 }
 
-uint16_t crc16(const uint8_t buf[], const uint8_t len, const uint16_t start)
+uint8_t crc8_table(const uint8_t buf[], const uint8_t len)
+{
+    uint8_t crc = CRC8_INIT;
+    for (uint8_t i = 0; i < len; i++) {
+        crc = crc8Table[crc ^ buf[i]];
+    }
+    return crc;
+}
+
+uint16_t crc16_bitwise(const uint8_t buf[], const uint8_t len, const uint16_t start)
 {
     uint16_t crc = start;
     uint8_t shift = 0;
@@ -27,13 +92,41 @@ uint16_t crc16(const uint8_t buf[], const uint8_t len, const uint16_t start)
             shift = (crc & 0x0001);
             crc = crc >> 1;
             if (shift != 0)
-                crc = crc ^ 0xA001;
+                crc = crc ^ CRC16_MODBUS_POLYNOM;
         }
     }
     return crc;
 }
 
-uint16_t crc16nrf24(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit, const uint16_t crcIn)
+uint16_t crc16_table(const uint8_t buf[], const uint8_t len, const uint16_t start)
+{
+    const auto& table = crc16ModbusTable[0];
+    uint16_t crc = start;
+
+    for (uint8_t i = 0; i < len; i++) {
+        crc = (crc >> 8) ^ table[(crc ^ buf[i]) & 0xff];
+    }
+    return crc;
+}
+
+uint16_t crc16_slice4(const uint8_t buf[], const uint8_t len, const uint16_t start)
+{
+    const auto& table = crc16ModbusTable;
+    uint16_t crc = start;
+    uint8_t i = 0;
+
+    // Only the first two of the four bytes are influenced by the previous crc
+    for (; len - i >= 4; i += 4) {
+        crc ^= buf[i] | (buf[i + 1] << 8);
+        crc = table[3][crc & 0xff] ^ table[2][crc >> 8] ^ table[1][buf[i + 2]] ^ table[0][buf[i + 3]];
+    }
+    for (; i < len; i++) {
+        crc = (crc >> 8) ^ table[0][(crc ^ buf[i]) & 0xff];
+    }
+    return crc;
+}
+
+uint16_t crc16nrf24_bitwise(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit, const uint16_t crcIn)
 {
     uint16_t crc = crcIn;
     uint8_t idx, val = buf[(startBit >> 3)];
@@ -47,4 +140,54 @@ uint16_t crc16nrf24(const uint8_t buf[], const uint16_t lenBits, const uint16_t
     }
 
     return crc;
-}
\ No newline at end of file
+}
+
+uint16_t crc16nrf24_table(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit, const uint16_t crcIn)
+{
+    uint16_t crc = crcIn;
+    uint16_t bit = startBit;
+
+    // Bits until the next byte boundary, whole bytes using the table, remaining bits
+    for (; (bit & 0x07) && bit < lenBits; bit++) {
+        crc ^= 0x8000 & (buf[bit >> 3] << (8 + (bit & 0x07)));
+        crc = (crc & 0x8000) ? ((crc << 1) ^ CRC16_NRF24_POLYNOM) : (crc << 1);
+    }
+    for (; lenBits - bit >= 8; bit += 8) {
+        crc = (crc << 8) ^ crc16Nrf24Table[(crc >> 8) ^ buf[bit >> 3]];
+    }
+    for (; bit < lenBits; bit++) {
+        crc ^= 0x8000 & (buf[bit >> 3] << (8 + (bit & 0x07)));
+        crc = (crc & 0x8000) ? ((crc << 1) ^ CRC16_NRF24_POLYNOM) : (crc << 1);
+    }
+
+    return crc;
+}
+
+uint8_t crc8(const uint8_t buf[], const uint8_t len)
+{
+#if HOY_CRC_IMPLEMENTATION == HOY_CRC_BITWISE
+    return crc8_bitwise(buf, len);
+#else
+    return crc8_table(buf, len);
+#endif
+}
+
+uint16_t crc16(const uint8_t buf[], const uint8_t len, const uint16_t start)
+{
+#if HOY_CRC_IMPLEMENTATION == HOY_CRC_BITWISE
+    return crc16_bitwise(buf, len, start);
+#elif HOY_CRC_IMPLEMENTATION == HOY_CRC_SLICE4
+    return crc16_slice4(buf, len, start);
+#else
+    return crc16_table(buf, len, start);
+#endif
+}
+
+uint16_t crc16nrf24(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit, const uint16_t crcIn)
+{
+#if HOY_CRC_IMPLEMENTATION == HOY_CRC_BITWISE
+    return crc16nrf24_bitwise(buf, lenBits, startBit, crcIn);
+#else
+    return crc16nrf24_table(buf, lenBits, startBit, crcIn);
+#endif
+}
@@ -9,6 +9,26 @@
 #define CRC16_MODBUS_POLYNOM 0xA001
 #define CRC16_NRF24_POLYNOM 0x1021
 
+// Implementation used by crc8(), crc16() and crc16nrf24()
+#define HOY_CRC_BITWISE 0 // No tables, one bit per iteration
+#define HOY_CRC_TABLE 1 // 256 entry lookup table per polynom, one byte per iteration
+#define HOY_CRC_SLICE4 2 // Like HOY_CRC_TABLE, crc16() additionally processes 4 bytes per iteration (2kB table)
+
+#ifndef HOY_CRC_IMPLEMENTATION
+#define HOY_CRC_IMPLEMENTATION HOY_CRC_TABLE
+#endif
+
 uint8_t crc8(const uint8_t buf[], const uint8_t len);
 uint16_t crc16(const uint8_t buf[], const uint8_t len, const uint16_t start = 0xffff);
 uint16_t crc16nrf24(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit = 0, const uint16_t crcIn = 0xffff);
+
+// The individual implementations are always available, e.g. for verification and benchmarking
+uint8_t crc8_bitwise(const uint8_t buf[], const uint8_t len);
+uint8_t crc8_table(const uint8_t buf[], const uint8_t len);
+
+uint16_t crc16_bitwise(const uint8_t buf[], const uint8_t len, const uint16_t start = 0xffff);
+uint16_t crc16_table(const uint8_t buf[], const uint8_t len, const uint16_t start = 0xffff);
+uint16_t crc16_slice4(const uint8_t buf[], const uint8_t len, const uint16_t start = 0xffff);
+
+uint16_t crc16nrf24_bitwise(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit = 0, const uint16_t crcIn = 0xffff);
+uint16_t crc16nrf24_table(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit = 0, const uint16_t crcIn = 0xffff);
@@ -19,6 +19,9 @@ bool HMS_Abstract::sendChangeChannelRequest()
     }
 
     auto cmdChannel = _radio->prepareCommand<ChannelChangeCommand>();
+    if (cmdChannel == nullptr) {
+        return false;
+    }
     cmdChannel->setCountryMode(Hoymiles.getRadioCmt()->getCountryMode());
     cmdChannel->setChannel(Hoymiles.getRadioCmt()->getChannelFromFrequency(Hoymiles.getRadioCmt()->getInverterTargetFrequency()));
     cmdChannel->setTargetAddress(serial());
@@ -21,6 +21,9 @@ bool HMT_Abstract::sendChangeChannelRequest()
     }
 
     auto cmdChannel = _radio->prepareCommand<ChannelChangeCommand>();
+    if (cmdChannel == nullptr) {
+        return false;
+    }
     cmdChannel->setCountryMode(Hoymiles.getRadioCmt()->getCountryMode());
     cmdChannel->setChannel(Hoymiles.getRadioCmt()->getChannelFromFrequency(Hoymiles.getRadioCmt()->getInverterTargetFrequency()));
     cmdChannel->setTargetAddress(serial());
@@ -31,6 +31,9 @@ bool HM_Abstract::sendStatsRequest()
     time(&now);
 
     auto cmd = _radio->prepareCommand<RealTimeRunDataCommand>();
+    if (cmd == nullptr) {
+        return false;
+    }
     cmd->setTime(now);
     cmd->setTargetAddress(serial());
     _radio->enqueCommand(cmd);
@@ -57,12 +60,16 @@ bool HM_Abstract::sendAlarmLogRequest(const bool force)
         }
     }
 
+    auto cmd = _radio->prepareCommand<AlarmDataCommand>();
+    if (cmd == nullptr) {
+        return false;
+    }
+
     _lastAlarmLogCnt = (uint8_t)Statistics()->getChannelFieldValue(TYPE_INV, CH0, FLD_EVT_LOG);
 
     time_t now;
     time(&now);
 
-    auto cmd = _radio->prepareCommand<AlarmDataCommand>();
     cmd->setTime(now);
     cmd->setTargetAddress(serial());
     EventLog()->setLastAlarmRequestSuccess(CMD_PENDING);
@@ -86,11 +93,17 @@ bool HM_Abstract::sendDevInfoRequest()
     time(&now);
 
     auto cmdAll = _radio->prepareCommand<DevInfoAllCommand>();
+    if (cmdAll == nullptr) {
+        return false;
+    }
     cmdAll->setTime(now);
     cmdAll->setTargetAddress(serial());
     _radio->enqueCommand(cmdAll);
 
     auto cmdSimple = _radio->prepareCommand<DevInfoSimpleCommand>();
+    if (cmdSimple == nullptr) {
+        return false;
+    }
     cmdSimple->setTime(now);
     cmdSimple->setTargetAddress(serial());
     _radio->enqueCommand(cmdSimple);
@@ -113,6 +126,9 @@ bool HM_Abstract::sendSystemConfigParaRequest()
     time(&now);
 
     auto cmd = _radio->prepareCommand<SystemConfigParaCommand>();
+    if (cmd == nullptr) {
+        return false;
+    }
     cmd->setTime(now);
     cmd->setTargetAddress(serial());
     SystemConfigPara()->setLastLimitRequestSuccess(CMD_PENDING);
@@ -135,6 +151,11 @@ bool HM_Abstract::sendActivePowerControlRequest(float limit, const PowerLimitCon
     _activePowerControlType = type;
 
     auto cmd = _radio->prepareCommand<ActivePowerControlCommand>();
+    if (cmd == nullptr) {
+        // Will be resent during the next poll cycle
+        SystemConfigPara()->setLastLimitCommandSuccess(CMD_NOK);
+        return false;
+    }
     cmd->setActivePowerLimit(limit, type);
     cmd->setTargetAddress(serial());
     SystemConfigPara()->setLastLimitCommandSuccess(CMD_PENDING);
@@ -161,6 +182,11 @@ bool HM_Abstract::sendPowerControlRequest(const bool turnOn)
     }
 
     auto cmd = _radio->prepareCommand<PowerControlCommand>();
+    if (cmd == nullptr) {
+        // Will be resent during the next poll cycle
+        PowerCommand()->setLastPowerCommandSuccess(CMD_NOK);
+        return false;
+    }
     cmd->setPowerOn(turnOn);
     cmd->setTargetAddress(serial());
     PowerCommand()->setLastPowerCommandSuccess(CMD_PENDING);
@@ -178,6 +204,11 @@ bool HM_Abstract::sendRestartControlRequest()
     _powerState = 2;
 
     auto cmd = _radio->prepareCommand<PowerControlCommand>();
+    if (cmd == nullptr) {
+        // Will be resent during the next poll cycle
+        PowerCommand()->setLastPowerCommandSuccess(CMD_NOK);
+        return false;
+    }
     cmd->setRestart();
     cmd->setTargetAddress(serial());
     PowerCommand()->setLastPowerCommandSuccess(CMD_PENDING);
@@ -220,6 +251,9 @@ bool HM_Abstract::sendGridOnProFileParaRequest()
     time(&now);
 
     auto cmd = _radio->prepareCommand<GridOnProFilePara>();
+    if (cmd == nullptr) {
+        return false;
+    }
     cmd->setTime(now);
     cmd->setTargetAddress(serial());
     _radio->enqueCommand(cmd);
@@ -5,6 +5,7 @@
 #include "InverterAbstract.h"
 #include "../Hoymiles.h"
 #include "crc.h"
+#include <algorithm>
 #include <cstring>
 
 InverterAbstract::InverterAbstract(HoymilesRadio* radio, const uint64_t serial)
@@ -32,7 +33,7 @@ void InverterAbstract::init()
     // Not possible in constructor --> virtual function
     // Not possible in verifyAllFragments --> Because no data if nothing is ever received
     // It has to be executed because otherwise the getChannelCount method in stats always returns 0
-    _statisticsParser.get()->setByteAssignment(getByteAssignment(), getByteAssignmentSize());
+    _statisticsParser.get()->setByteAssignment(getByteAssignment(), getByteAssignmentSize(), getByteAssignmentIndex());
 }
 
 uint64_t InverterAbstract::serial() const
@@ -137,6 +138,26 @@ HoymilesRadio* InverterAbstract::getRadio()
     return _radio;
 }
 
+AdaptivePollInterval* InverterAbstract::PollInterval()
+{
+    return &_pollInterval;
+}
+
+ResponseLatencyHistogram* InverterAbstract::ResponseLatency()
+{
+    return &_responseLatency;
+}
+
+ChannelQualityTable* InverterAbstract::ChannelQuality()
+{
+    return &_channelQuality;
+}
+
+TxPowerControl* InverterAbstract::TxPower()
+{
+    return &_txPower;
+}
+
 AlarmLogParser* InverterAbstract::EventLog()
 {
     return _alarmLogParser.get();
@@ -167,23 +188,33 @@ SystemConfigParaParser* InverterAbstract::SystemConfigPara()
     return _systemConfigParaParser.get();
 }
 
+void InverterAbstract::setRxFragmentBuffer(ReassemblyBuffer_t* buffer)
+{
+    _rxFragments = buffer;
+    clearRxFragmentBuffer();
+}
+
 void InverterAbstract::clearRxFragmentBuffer()
 {
-    memset(_rxFragmentBuffer, 0, MAX_RF_FRAGMENT_COUNT * sizeof(fragment_t));
-    _rxFragmentMaxPacketId = 0;
-    _rxFragmentLastPacketId = 0;
-    _rxFragmentRetransmitCnt = 0;
+    if (_rxFragments != nullptr) {
+        memset(_rxFragments, 0, sizeof(ReassemblyBuffer_t));
+    }
 }
 
 void InverterAbstract::addRxFragment(const uint8_t fragment[], const uint8_t len)
 {
+    if (_rxFragments == nullptr) {
+        // Late fragment of a completed command
+        return;
+    }
+
     if (len < 11) {
-        Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) fragment too short\r\n", __FILE__, __LINE__);
+        HOY_LOG(INVERTER, ERROR, "FATAL: (%s, %d) fragment too short\r\n", __FILE__, __LINE__);
         return;
     }
 
     if (len - 11 > MAX_RF_PAYLOAD_SIZE) {
-        Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) fragment too large\r\n", __FILE__, __LINE__);
+        HOY_LOG(INVERTER, ERROR, "FATAL: (%s, %d) fragment too large\r\n", __FILE__, __LINE__);
         return;
     }
 
@@ -193,36 +224,62 @@ void InverterAbstract::addRxFragment(const uint8_t fragment[], const uint8_t len
     const uint8_t fragmentId = fragmentCount & 0b01111111; // fragmentId is 1 based
 
     if (fragmentId == 0) {
-        Hoymiles.getMessageOutput()->println("ERROR: fragment id zero received and ignored");
+        HOY_LOG(INVERTER, ERROR, "ERROR: fragment id zero received and ignored\r\n");
         return;
     }
 
     if (fragmentId >= MAX_RF_FRAGMENT_COUNT) {
-        Hoymiles.getMessageOutput()->printf("ERROR: fragment id %d is too large for buffer and ignored\r\n", fragmentId);
+        HOY_LOG(INVERTER, ERROR, "ERROR: fragment id %d is too large for buffer and ignored\r\n", fragmentId);
         return;
     }
 
-    memcpy(_rxFragmentBuffer[fragmentId - 1].fragment, &fragment[10], len - 11);
-    _rxFragmentBuffer[fragmentId - 1].len = len - 11;
-    _rxFragmentBuffer[fragmentId - 1].mainCmd = fragment[0];
-    _rxFragmentBuffer[fragmentId - 1].wasReceived = true;
+    ReassemblyBuffer_t& rx = *_rxFragments;
+    memcpy(rx.fragments[fragmentId - 1].fragment, &fragment[10], len - 11);
+    rx.fragments[fragmentId - 1].len = len - 11;
+    rx.fragments[fragmentId - 1].mainCmd = fragment[0];
+    rx.fragments[fragmentId - 1].wasReceived = true;
 
-    if (fragmentId > _rxFragmentLastPacketId) {
-        _rxFragmentLastPacketId = fragmentId;
+    if (fragmentId > rx.lastPacketId) {
+        rx.lastPacketId = fragmentId;
     }
 
     // 0b10000000 == 0x80
     if ((fragmentCount & 0b10000000) == 0b10000000) {
-        _rxFragmentMaxPacketId = fragmentId;
+        rx.maxPacketId = fragmentId;
+    }
+}
+
+bool InverterAbstract::isAllFragmentsReceived(const uint8_t mainCmd) const
+{
+    if (_rxFragments == nullptr || _rxFragments->maxPacketId == 0) {
+        return false;
     }
+
+    for (uint8_t i = 0; i < _rxFragments->maxPacketId; i++) {
+        if (!_rxFragments->fragments[i].wasReceived || _rxFragments->fragments[i].mainCmd != mainCmd) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint8_t InverterAbstract::getRetransmitFragmentCount() const
+{
+    return _rxFragments != nullptr ? _rxFragments->retransmitCount : 0;
 }
 
-// Returns Zero on Success or the Fragment ID for retransmit or error code
+uint8_t InverterAbstract::getRetransmitFragment(const uint8_t index) const
+{
+    return index < getRetransmitFragmentCount() ? _rxFragments->retransmitIds[index] : 0;
+}
+
+// Returns Zero on Success or the first Fragment ID for retransmit or error code.
+// All Fragment IDs to retransmit are available by getRetransmitFragment.
 uint8_t InverterAbstract::verifyAllFragments(CommandAbstract& cmd)
 {
     // All missing
-    if (_rxFragmentLastPacketId == 0) {
-        Hoymiles.getMessageOutput()->println("All missing");
+    if (_rxFragments == nullptr || _rxFragments->lastPacketId == 0) {
+        HOY_LOG(INVERTER, DEBUG, "All missing\r\n");
         if (cmd.getSendCount() <= cmd.getMaxResendCount()) {
             return FRAGMENT_ALL_MISSING_RESEND;
         } else {
@@ -231,31 +288,42 @@ uint8_t InverterAbstract::verifyAllFragments(CommandAbstract& cmd)
         }
     }
 
+    ReassemblyBuffer_t& rx = *_rxFragments;
+
+    // Collect all missing fragments, they are requested at once
+    rx.retransmitCount = 0;
+
+    // Middle fragment is missing
+    const uint8_t lastKnownId = rx.maxPacketId > 0 ? rx.maxPacketId : rx.lastPacketId;
+    for (uint8_t i = 0; i < lastKnownId - 1; i++) {
+        if (!rx.fragments[i].wasReceived) {
+            if (rx.retransmitCount == 0) {
+                HOY_LOG(INVERTER, DEBUG, "Middle missing\r\n");
+            }
+            rx.retransmitIds[rx.retransmitCount++] = i + 1;
+        }
+    }
+
     // Last fragment is missing (the one with 0x80)
-    if (_rxFragmentMaxPacketId == 0) {
-        Hoymiles.getMessageOutput()->println("Last missing");
-        if (_rxFragmentRetransmitCnt++ < cmd.getMaxRetransmitCount()) {
-            return _rxFragmentLastPacketId + 1;
-        } else {
+    if (rx.maxPacketId == 0) {
+        HOY_LOG(INVERTER, DEBUG, "Last missing\r\n");
+        rx.retransmitIds[rx.retransmitCount++] = rx.lastPacketId + 1;
+    }
+
+    if (rx.retransmitCount > 0) {
+        // The retransmit budget is shared by all fragments of the response
+        if (rx.retransmitCnt >= cmd.getMaxRetransmitCount()) {
+            rx.retransmitCount = 0;
             cmd.gotTimeout(*this);
             return FRAGMENT_RETRANSMIT_TIMEOUT;
         }
-    }
 
-    // Middle fragment is missing
-    for (uint8_t i = 0; i < _rxFragmentMaxPacketId - 1; i++) {
-        if (!_rxFragmentBuffer[i].wasReceived) {
-            Hoymiles.getMessageOutput()->println("Middle missing");
-            if (_rxFragmentRetransmitCnt++ < cmd.getMaxRetransmitCount()) {
-                return i + 1;
-            } else {
-                cmd.gotTimeout(*this);
-                return FRAGMENT_RETRANSMIT_TIMEOUT;
-            }
-        }
+        rx.retransmitCount = std::min<uint8_t>(rx.retransmitCount, cmd.getMaxRetransmitCount() - rx.retransmitCnt);
+        rx.retransmitCnt += rx.retransmitCount;
+        return rx.retransmitIds[0];
     }
 
-    if (!cmd.handleResponse(*this, _rxFragmentBuffer, _rxFragmentMaxPacketId)) {
+    if (!cmd.handleResponse(*this, rx.fragments, rx.maxPacketId)) {
         cmd.gotTimeout(*this);
         return FRAGMENT_HANDLE_ERROR;
     }
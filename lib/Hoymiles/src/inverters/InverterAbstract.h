@@ -8,7 +8,12 @@
 #include "../parser/PowerCommandParser.h"
 #include "../parser/StatisticsParser.h"
 #include "../parser/SystemConfigParaParser.h"
+#include "AdaptivePollInterval.h"
+#include "ChannelQualityTable.h"
 #include "HoymilesRadio.h"
+#include "ReassemblyPool.h"
+#include "ResponseLatencyHistogram.h"
+#include "TxPowerControl.h"
 #include "types.h"
 #include <Arduino.h>
 #include <cstdint>
@@ -24,8 +29,6 @@ enum {
     FRAGMENT_OK = 0
 };
 
-#define MAX_RF_FRAGMENT_COUNT 13
-
 class CommandAbstract;
 
 class InverterAbstract {
@@ -39,6 +42,7 @@ public:
     virtual String typeName() const = 0;
     virtual const byteAssign_t* getByteAssignment() const = 0;
     virtual uint8_t getByteAssignmentSize() const = 0;
+    virtual const byteAssignIndex_t* getByteAssignmentIndex() const = 0;
 
     bool isProducing();
     bool isReachable();
@@ -58,9 +62,15 @@ public:
     void setZeroYieldDayOnMidnight(const bool enabled);
     bool getZeroYieldDayOnMidnight() const;
 
+    // Attaches the buffer leased for the command in flight and clears it, nullptr detaches
+    void setRxFragmentBuffer(ReassemblyBuffer_t* buffer);
     void clearRxFragmentBuffer();
     void addRxFragment(const uint8_t fragment[], const uint8_t len);
+    // True if the last fragment and all fragments before were received as answer of mainCmd
+    bool isAllFragmentsReceived(const uint8_t mainCmd) const;
     uint8_t verifyAllFragments(CommandAbstract& cmd);
+    uint8_t getRetransmitFragmentCount() const;
+    uint8_t getRetransmitFragment(const uint8_t index) const;
 
     virtual bool sendStatsRequest() = 0;
     virtual bool sendAlarmLogRequest(const bool force = false) = 0;
@@ -76,6 +86,11 @@ public:
 
     HoymilesRadio* getRadio();
 
+    AdaptivePollInterval* PollInterval();
+    ResponseLatencyHistogram* ResponseLatency();
+    ChannelQualityTable* ChannelQuality();
+    TxPowerControl* TxPower();
+
     AlarmLogParser* EventLog();
     DevInfoParser* DevInfo();
     GridProfileParser* GridProfile();
@@ -90,10 +105,7 @@ private:
     serial_u _serial;
     String _serialString;
     char _name[MAX_NAME_LENGTH] = "";
-    fragment_t _rxFragmentBuffer[MAX_RF_FRAGMENT_COUNT];
-    uint8_t _rxFragmentMaxPacketId = 0;
-    uint8_t _rxFragmentLastPacketId = 0;
-    uint8_t _rxFragmentRetransmitCnt = 0;
+    ReassemblyBuffer_t* _rxFragments = nullptr;
 
     bool _enablePolling = true;
     bool _enableCommands = true;
@@ -103,6 +115,11 @@ private:
     bool _zeroValuesIfUnreachable = false;
     bool _zeroYieldDayOnMidnight = false;
 
+    AdaptivePollInterval _pollInterval;
+    ResponseLatencyHistogram _responseLatency;
+    ChannelQualityTable _channelQuality;
+    TxPowerControl _txPower;
+
     std::unique_ptr<AlarmLogParser> _alarmLogParser;
     std::unique_ptr<DevInfoParser> _devInfoParser;
     std::unique_ptr<GridProfileParser> _gridProfileParser;
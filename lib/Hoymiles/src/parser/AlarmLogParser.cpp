@@ -185,7 +185,7 @@ void AlarmLogParser::clearBuffer()
 void AlarmLogParser::appendFragment(const uint8_t offset, const uint8_t* payload, const uint8_t len)
 {
     if (offset + len > ALARM_LOG_PAYLOAD_SIZE) {
-        Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) stats packet too large for buffer (%d > %d)\r\n", __FILE__, __LINE__, offset + len, ALARM_LOG_PAYLOAD_SIZE);
+        HOY_LOG(PARSER, ERROR, "FATAL: (%s, %d) stats packet too large for buffer (%d > %d)\r\n", __FILE__, __LINE__, offset + len, ALARM_LOG_PAYLOAD_SIZE);
         return;
     }
     memcpy(&_payloadAlarmLog[offset], payload, len);
@@ -215,6 +215,11 @@ void AlarmLogParser::setMessageType(const AlarmMessageType_t type)
     _messageType = type;
 }
 
+AlarmMessageType_t AlarmLogParser::getMessageType() const
+{
+    return _messageType;
+}
+
 void AlarmLogParser::getLogEntry(const uint8_t entryId, AlarmLogEntry_t& entry, const AlarmMessageLocale_t locale)
 {
     const uint8_t entryStartOffset = 2 + entryId * ALARM_LOG_ENTRY_SIZE;
@@ -244,30 +249,38 @@ void AlarmLogParser::getLogEntry(const uint8_t entryId, AlarmLogEntry_t& entry,
         entry.EndTime += (endTimeOffset + timezoneOffset);
     }
 
-    switch (locale) {
-    case AlarmMessageLocale_t::DE:
-        entry.Message = "Unbekannt";
-        break;
-    case AlarmMessageLocale_t::FR:
-        entry.Message = "Inconnu";
-        break;
-    default:
-        entry.Message = "Unknown";
-    }
+    entry.Message = getMessageText(entry.MessageId, _messageType, locale);
+}
 
+const char* AlarmLogParser::getMessageText(const uint16_t messageId, const AlarmMessageType_t type, const AlarmMessageLocale_t locale)
+{
+    const AlarmMessage_t* found = nullptr;
     for (auto& msg : _alarmMessages) {
-        if (msg.MessageId == entry.MessageId) {
-            if (msg.InverterType == _messageType) {
-                entry.Message = getLocaleMessage(&msg, locale);
+        if (msg.MessageId == messageId) {
+            if (msg.InverterType == type) {
+                found = &msg;
                 break;
             } else if (msg.InverterType == AlarmMessageType_t::ALL) {
-                entry.Message = getLocaleMessage(&msg, locale);
+                found = &msg;
             }
         }
     }
+
+    if (found != nullptr) {
+        return getLocaleMessage(found, locale);
+    }
+
+    switch (locale) {
+    case AlarmMessageLocale_t::DE:
+        return "Unbekannt";
+    case AlarmMessageLocale_t::FR:
+        return "Inconnu";
+    default:
+        return "Unknown";
+    }
 }
 
-String AlarmLogParser::getLocaleMessage(const AlarmMessage_t* msg, const AlarmMessageLocale_t locale) const
+const char* AlarmLogParser::getLocaleMessage(const AlarmMessage_t* msg, const AlarmMessageLocale_t locale)
 {
     if (locale == AlarmMessageLocale_t::DE) {
         return msg->Message_de[0] != '\0' ? msg->Message_de : msg->Message_en;
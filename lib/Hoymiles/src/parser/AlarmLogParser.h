@@ -12,7 +12,7 @@
 
 struct AlarmLogEntry_t {
     uint16_t MessageId;
-    String Message;
+    const char* Message; // Points into the static message table
     time_t StartTime;
     time_t EndTime;
 };
@@ -49,10 +49,13 @@ public:
     LastCommandSuccess getLastAlarmRequestSuccess() const;
 
     void setMessageType(const AlarmMessageType_t type);
+    AlarmMessageType_t getMessageType() const;
+
+    static const char* getMessageText(const uint16_t messageId, const AlarmMessageType_t type, const AlarmMessageLocale_t locale = AlarmMessageLocale_t::EN);
 
 private:
     static int getTimezoneOffset();
-    String getLocaleMessage(const AlarmMessage_t* msg, const AlarmMessageLocale_t locale) const;
+    static const char* getLocaleMessage(const AlarmMessage_t* msg, const AlarmMessageLocale_t locale);
 
     uint8_t _payloadAlarmLog[ALARM_LOG_PAYLOAD_SIZE];
     uint8_t _alarmLogLength = 0;
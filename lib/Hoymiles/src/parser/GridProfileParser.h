@@ -2,6 +2,7 @@
 #pragma once
 #include "Parser.h"
 #include <list>
+#include <vector>
 
 #define GRID_PROFILE_SIZE 141
 #define PROFILE_TYPE_COUNT 10
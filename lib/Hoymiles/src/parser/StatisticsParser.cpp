@@ -4,16 +4,17 @@
  */
 #include "StatisticsParser.h"
 #include "../Hoymiles.h"
+#include <algorithm>
 
-static float calcTotalYieldTotal(StatisticsParser* iv, uint8_t arg0);
-static float calcTotalYieldDay(StatisticsParser* iv, uint8_t arg0);
-static float calcChUdc(StatisticsParser* iv, uint8_t arg0);
-static float calcTotalPowerDc(StatisticsParser* iv, uint8_t arg0);
-static float calcTotalEffiency(StatisticsParser* iv, uint8_t arg0);
-static float calcChIrradiation(StatisticsParser* iv, uint8_t arg0);
-static float calcTotalCurrentAc(StatisticsParser* iv, uint8_t arg0);
+static float calcTotalYieldTotal(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0);
+static float calcTotalYieldDay(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0);
+static float calcChUdc(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0);
+static float calcTotalPowerDc(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0);
+static float calcTotalEffiency(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0);
+static float calcChIrradiation(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0);
+static float calcTotalCurrentAc(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0);
 
-using func_t = float(StatisticsParser*, uint8_t);
+using func_t = float(const StatisticsParser*, const StatisticsValues_t&, uint8_t);
 
 struct calcFunc_t {
     uint8_t funcId; // unique id
@@ -52,6 +53,12 @@ const FieldId_t runtimeFields[] = {
     FLD_IAC_3,
 };
 
+static const std::array<ChannelType_t, CHANNEL_TYPE_CNT> channelTypeList = {
+    TYPE_AC,
+    TYPE_DC,
+    TYPE_INV
+};
+
 const FieldId_t dailyProductionFields[] = {
     FLD_YD,
 };
@@ -62,10 +69,13 @@ StatisticsParser::StatisticsParser()
     clearBuffer();
 }
 
-void StatisticsParser::setByteAssignment(const byteAssign_t* byteAssignment, const uint8_t size)
+void StatisticsParser::setByteAssignment(const byteAssign_t* byteAssignment, const uint8_t size, const byteAssignIndex_t* index)
 {
     _byteAssignment = byteAssignment;
     _byteAssignmentSize = size;
+    _byteAssignmentIndex = index;
+
+    _values.resize(size);
 
     for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
         if (_byteAssignment[i].div == CMD_CALC) {
@@ -89,7 +99,7 @@ void StatisticsParser::clearBuffer()
 void StatisticsParser::appendFragment(const uint8_t offset, const uint8_t* payload, const uint8_t len)
 {
     if (offset + len > STATISTIC_PACKET_SIZE) {
-        Hoymiles.getMessageOutput()->printf("FATAL: (%s, %d) stats packet too large for buffer\r\n", __FILE__, __LINE__);
+        HOY_LOG(PARSER, ERROR, "FATAL: (%s, %d) stats packet too large for buffer\r\n", __FILE__, __LINE__);
         return;
     }
     memcpy(&_payloadStatistic[offset], payload, len);
@@ -99,6 +109,7 @@ void StatisticsParser::appendFragment(const uint8_t offset, const uint8_t* paylo
 void StatisticsParser::endAppendFragment()
 {
     Parser::endAppendFragment();
+    decodeValues();
 
     if (!_enableYieldDayCorrection) {
         resetYieldDayCorrection();
@@ -109,7 +120,7 @@ void StatisticsParser::endAppendFragment()
         // check if current yield day is smaller then last cached yield day
         if (getChannelFieldValue(TYPE_DC, c, FLD_YD) < _lastYieldDay[static_cast<uint8_t>(c)]) {
             // currently all values are zero --> Add last known values to offset
-            Hoymiles.getMessageOutput()->printf("Yield Day reset detected!\r\n");
+            HOY_LOG(PARSER, INFO, "Yield Day reset detected!\r\n");
 
             setChannelFieldOffset(TYPE_DC, c, FLD_YD, _lastYieldDay[static_cast<uint8_t>(c)]);
 
@@ -122,67 +133,95 @@ void StatisticsParser::endAppendFragment()
 
 const byteAssign_t* StatisticsParser::getAssignmentByChannelField(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
 {
-    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
-        if (_byteAssignment[i].type == type && _byteAssignment[i].ch == channel && _byteAssignment[i].fieldId == fieldId) {
-            return &_byteAssignment[i];
-        }
+    if (_byteAssignmentIndex == nullptr || type >= CHANNEL_TYPE_CNT || channel >= CH_CNT || fieldId >= FIELD_CNT) {
+        return nullptr;
     }
-    return nullptr;
+
+    const uint8_t pos = _byteAssignmentIndex->pos[type][channel][fieldId];
+    return pos != BYTE_ASSIGN_NONE ? &_byteAssignment[pos] : nullptr;
 }
 
-fieldSettings_t* StatisticsParser::getSettingByChannelField(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId)
+float StatisticsParser::getChannelFieldValue(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
 {
-    for (auto& i : _fieldSettings) {
-        if (i.type == type && i.ch == channel && i.fieldId == fieldId) {
-            return &i;
-        }
+    const byteAssign_t* pos = getAssignmentByChannelField(type, channel, fieldId);
+    if (pos == nullptr) {
+        return 0;
     }
-    return nullptr;
+
+    return _values.readElement(pos - _byteAssignment);
 }
 
-float StatisticsParser::getChannelFieldValue(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId)
+float StatisticsParser::getChannelFieldValue(const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
 {
     const byteAssign_t* pos = getAssignmentByChannelField(type, channel, fieldId);
     if (pos == nullptr) {
         return 0;
     }
 
-    uint8_t ptr = pos->start;
-    const uint8_t end = ptr + pos->num;
-    const uint16_t div = pos->div;
+    return values.values[pos - _byteAssignment];
+}
+
+void StatisticsParser::getValues(StatisticsValues_t& values) const
+{
+    values.generation = _values.read(values.values);
+}
+
+uint32_t StatisticsParser::getGeneration() const
+{
+    return _values.getVersion();
+}
+
+void StatisticsParser::decodeValues()
+{
+    // Decoded in a back buffer and published at once, readers never wait for the decoder
+    StatisticsValues_t values;
+
+    HOY_SEMAPHORE_TAKE();
+
+    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
+        const byteAssign_t& pos = _byteAssignment[i];
+        if (CMD_CALC == pos.div) {
+            continue;
+        }
 
-    if (CMD_CALC != div) {
-        // Value is a static value
         uint32_t val = 0;
-        HOY_SEMAPHORE_TAKE();
-        do {
+        for (uint8_t ptr = pos.start; ptr < pos.start + pos.num; ptr++) {
             val <<= 8;
             val |= _payloadStatistic[ptr];
-        } while (++ptr != end);
-        HOY_SEMAPHORE_GIVE();
+        }
 
         float result;
-        if (pos->isSigned && pos->num == 2) {
+        if (pos.isSigned && pos.num == 2) {
             result = static_cast<float>(static_cast<int16_t>(val));
-        } else if (pos->isSigned && pos->num == 4) {
+        } else if (pos.isSigned && pos.num == 4) {
             result = static_cast<float>(static_cast<int32_t>(val));
         } else {
             result = static_cast<float>(val);
         }
 
-        result /= static_cast<float>(div);
+        result /= static_cast<float>(pos.div);
+        values.values[i] = result;
+    }
 
-        const fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
-        if (setting != nullptr && _statisticLength > 0) {
-            result += setting->offset;
+    if (_statisticLength > 0) {
+        for (auto& o : _fieldOffsets) {
+            if (CMD_CALC != _byteAssignment[o.pos].div) {
+                values.values[o.pos] += o.offset;
+            }
         }
-        return result;
-    } else {
-        // Value has to be calculated
-        return calcFunctions[pos->start].func(this, pos->num);
     }
 
-    return 0;
+    // The calculation functions only read fields decoded above
+    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
+        if (CMD_CALC == _byteAssignment[i].div) {
+            values.values[i] = calcFunctions[_byteAssignment[i].start].func(this, values, _byteAssignment[i].num);
+        }
+    }
+
+    // Writers are serialized by the semaphore, the snapshot allows only one
+    _values.publish(values.values);
+
+    HOY_SEMAPHORE_GIVE();
 }
 
 bool StatisticsParser::setChannelFieldValue(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, float value)
@@ -192,6 +231,18 @@ bool StatisticsParser::setChannelFieldValue(const ChannelType_t type, const Chan
         return false;
     }
 
+    HOY_SEMAPHORE_TAKE();
+    const bool written = writeFieldValue(pos, value);
+    HOY_SEMAPHORE_GIVE();
+
+    if (written) {
+        decodeValues();
+    }
+    return written;
+}
+
+bool StatisticsParser::writeFieldValue(const byteAssign_t* pos, float value)
+{
     uint8_t ptr = pos->start + pos->num - 1;
     const uint8_t end = pos->start;
     const uint16_t div = pos->div;
@@ -200,10 +251,7 @@ bool StatisticsParser::setChannelFieldValue(const ChannelType_t type, const Chan
         return false;
     }
 
-    const fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
-    if (setting != nullptr) {
-        value -= setting->offset;
-    }
+    value -= getFieldOffset(pos - _byteAssignment);
     value *= static_cast<float>(div);
 
     uint32_t val = 0;
@@ -215,12 +263,10 @@ bool StatisticsParser::setChannelFieldValue(const ChannelType_t type, const Chan
         val = static_cast<uint32_t>(value);
     }
 
-    HOY_SEMAPHORE_TAKE();
     do {
         _payloadStatistic[ptr] = val;
         val >>= 8;
     } while (--ptr >= end);
-    HOY_SEMAPHORE_GIVE();
 
     return true;
 }
@@ -232,6 +278,13 @@ String StatisticsParser::getChannelFieldValueString(const ChannelType_t type, co
         static_cast<unsigned int>(getChannelFieldDigits(type, channel, fieldId)));
 }
 
+String StatisticsParser::getChannelFieldValueString(const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
+{
+    return String(
+        getChannelFieldValue(values, type, channel, fieldId),
+        static_cast<unsigned int>(getChannelFieldDigits(type, channel, fieldId)));
+}
+
 bool StatisticsParser::hasChannelFieldValue(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
 {
     const byteAssign_t* pos = getAssignmentByChannelField(type, channel, fieldId);
@@ -258,30 +311,56 @@ uint8_t StatisticsParser::getChannelFieldDigits(const ChannelType_t type, const
 
 float StatisticsParser::getChannelFieldOffset(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId)
 {
-    const fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
-    if (setting != nullptr) {
-        return setting->offset;
+    const byteAssign_t* pos = getAssignmentByChannelField(type, channel, fieldId);
+    if (pos == nullptr) {
+        return 0;
     }
-    return 0;
+
+    HOY_SEMAPHORE_TAKE();
+    const float offset = getFieldOffset(pos - _byteAssignment);
+    HOY_SEMAPHORE_GIVE();
+    return offset;
 }
 
 void StatisticsParser::setChannelFieldOffset(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, const float offset)
 {
-    fieldSettings_t* setting = getSettingByChannelField(type, channel, fieldId);
-    if (setting != nullptr) {
-        setting->offset = offset;
-    } else {
-        _fieldSettings.push_back({ type, channel, fieldId, offset });
+    const byteAssign_t* pos = getAssignmentByChannelField(type, channel, fieldId);
+    if (pos == nullptr) {
+        return;
+    }
+
+    HOY_SEMAPHORE_TAKE();
+    auto it = std::find_if(_fieldOffsets.begin(), _fieldOffsets.end(),
+        [&](const fieldOffset_t& o) { return o.pos == pos - _byteAssignment; });
+
+    const bool changed = it != _fieldOffsets.end() ? it->offset != offset : offset != 0;
+    if (it != _fieldOffsets.end() && offset == 0) {
+        _fieldOffsets.erase(it);
+    } else if (it != _fieldOffsets.end()) {
+        it->offset = offset;
+    } else if (offset != 0) {
+        _fieldOffsets.push_back({ static_cast<uint8_t>(pos - _byteAssignment), offset });
+    }
+    HOY_SEMAPHORE_GIVE();
+
+    if (changed) {
+        decodeValues();
+    }
+}
+
+float StatisticsParser::getFieldOffset(const uint8_t pos) const
+{
+    for (auto& o : _fieldOffsets) {
+        if (o.pos == pos) {
+            return o.offset;
+        }
     }
+    return 0;
 }
 
-std::list<ChannelType_t> StatisticsParser::getChannelTypes() const
+const std::array<ChannelType_t, CHANNEL_TYPE_CNT>& StatisticsParser::getChannelTypes() const
 {
-    return {
-        TYPE_AC,
-        TYPE_DC,
-        TYPE_INV
-    };
+    return channelTypeList;
 }
 
 const char* StatisticsParser::getChannelTypeName(const ChannelType_t type) const
@@ -289,16 +368,12 @@ const char* StatisticsParser::getChannelTypeName(const ChannelType_t type) const
     return channelsTypes[type];
 }
 
-std::list<ChannelNum_t> StatisticsParser::getChannelsByType(const ChannelType_t type) const
+ChannelList StatisticsParser::getChannelsByType(const ChannelType_t type) const
 {
-    std::list<ChannelNum_t> l;
-    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
-        if (_byteAssignment[i].type == type) {
-            l.push_back(_byteAssignment[i].ch);
-        }
+    if (_byteAssignmentIndex == nullptr || type >= CHANNEL_TYPE_CNT) {
+        return ChannelList();
     }
-    l.unique();
-    return l;
+    return ChannelList(_byteAssignmentIndex->channels[type]);
 }
 
 uint16_t StatisticsParser::getStringMaxPower(const uint8_t channel) const
@@ -308,8 +383,10 @@ uint16_t StatisticsParser::getStringMaxPower(const uint8_t channel) const
 
 void StatisticsParser::setStringMaxPower(const uint8_t channel, const uint16_t power)
 {
-    if (channel < sizeof(_stringMaxPower) / sizeof(_stringMaxPower[0])) {
+    if (channel < sizeof(_stringMaxPower) / sizeof(_stringMaxPower[0]) && _stringMaxPower[channel] != power) {
         _stringMaxPower[channel] = power;
+        // Irradiation depends on the string power
+        decodeValues();
     }
 }
 
@@ -330,12 +407,12 @@ uint32_t StatisticsParser::getRxFailureCount() const
 
 void StatisticsParser::zeroRuntimeData()
 {
-    zeroFields(runtimeFields);
+    zeroFields(runtimeFields, sizeof(runtimeFields) / sizeof(runtimeFields[0]));
 }
 
 void StatisticsParser::zeroDailyData()
 {
-    zeroFields(dailyProductionFields);
+    zeroFields(dailyProductionFields, sizeof(dailyProductionFields) / sizeof(dailyProductionFields[0]));
 }
 
 void StatisticsParser::setLastUpdate(const uint32_t lastUpdate)
@@ -364,18 +441,18 @@ void StatisticsParser::setYieldDayCorrection(const bool enabled)
     _enableYieldDayCorrection = enabled;
 }
 
-void StatisticsParser::zeroFields(const FieldId_t* fields)
+void StatisticsParser::zeroFields(const FieldId_t* fields, const uint8_t count)
 {
-    // Loop all channels
-    for (auto& t : getChannelTypes()) {
-        for (auto& c : getChannelsByType(t)) {
-            for (uint8_t i = 0; i < (sizeof(runtimeFields) / sizeof(runtimeFields[0])); i++) {
-                if (hasChannelFieldValue(t, c, fields[i])) {
-                    setChannelFieldValue(t, c, fields[i], 0);
-                }
-            }
+    HOY_SEMAPHORE_TAKE();
+    // Loop all fields of all channels
+    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
+        if (std::find(fields, fields + count, _byteAssignment[i].fieldId) != fields + count) {
+            writeFieldValue(&_byteAssignment[i], 0);
         }
     }
+    HOY_SEMAPHORE_GIVE();
+
+    decodeValues();
     setLastUpdateFromInternal(millis());
 }
 
@@ -388,49 +465,49 @@ void StatisticsParser::resetYieldDayCorrection()
     }
 }
 
-static float calcTotalYieldTotal(StatisticsParser* iv, uint8_t arg0)
+static float calcTotalYieldTotal(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0)
 {
     float yield = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_DC)) {
-        yield += iv->getChannelFieldValue(TYPE_DC, channel, FLD_YT);
+        yield += iv->getChannelFieldValue(values, TYPE_DC, channel, FLD_YT);
     }
     return yield;
 }
 
-static float calcTotalYieldDay(StatisticsParser* iv, uint8_t arg0)
+static float calcTotalYieldDay(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0)
 {
     float yield = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_DC)) {
-        yield += iv->getChannelFieldValue(TYPE_DC, channel, FLD_YD);
+        yield += iv->getChannelFieldValue(values, TYPE_DC, channel, FLD_YD);
     }
     return yield;
 }
 
 // arg0 = channel of source
-static float calcChUdc(StatisticsParser* iv, uint8_t arg0)
+static float calcChUdc(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0)
 {
-    return iv->getChannelFieldValue(TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_UDC);
+    return iv->getChannelFieldValue(values, TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_UDC);
 }
 
-static float calcTotalPowerDc(StatisticsParser* iv, uint8_t arg0)
+static float calcTotalPowerDc(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0)
 {
     float dcPower = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_DC)) {
-        dcPower += iv->getChannelFieldValue(TYPE_DC, channel, FLD_PDC);
+        dcPower += iv->getChannelFieldValue(values, TYPE_DC, channel, FLD_PDC);
     }
     return dcPower;
 }
 
-static float calcTotalEffiency(StatisticsParser* iv, uint8_t arg0)
+static float calcTotalEffiency(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0)
 {
     float acPower = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_AC)) {
-        acPower += iv->getChannelFieldValue(TYPE_AC, channel, FLD_PAC);
+        acPower += iv->getChannelFieldValue(values, TYPE_AC, channel, FLD_PAC);
     }
 
     float dcPower = 0;
     for (auto& channel : iv->getChannelsByType(TYPE_DC)) {
-        dcPower += iv->getChannelFieldValue(TYPE_DC, channel, FLD_PDC);
+        dcPower += iv->getChannelFieldValue(values, TYPE_DC, channel, FLD_PDC);
     }
 
     if (dcPower > 0) {
@@ -440,20 +517,20 @@ static float calcTotalEffiency(StatisticsParser* iv, uint8_t arg0)
 }
 
 // arg0 = channel
-static float calcChIrradiation(StatisticsParser* iv, uint8_t arg0)
+static float calcChIrradiation(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0)
 {
     if (nullptr != iv) {
         if (iv->getStringMaxPower(arg0) > 0)
-            return iv->getChannelFieldValue(TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_PDC) / iv->getStringMaxPower(arg0) * 100.0f;
+            return iv->getChannelFieldValue(values, TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_PDC) / iv->getStringMaxPower(arg0) * 100.0f;
     }
     return 0.0;
 }
 
-static float calcTotalCurrentAc(StatisticsParser* iv, uint8_t arg0)
+static float calcTotalCurrentAc(const StatisticsParser* iv, const StatisticsValues_t& values, uint8_t arg0)
 {
     float acCurrent = 0;
-    acCurrent += iv->getChannelFieldValue(TYPE_AC, CH0, FLD_IAC_1);
-    acCurrent += iv->getChannelFieldValue(TYPE_AC, CH0, FLD_IAC_2);
-    acCurrent += iv->getChannelFieldValue(TYPE_AC, CH0, FLD_IAC_3);
+    acCurrent += iv->getChannelFieldValue(values, TYPE_AC, CH0, FLD_IAC_1);
+    acCurrent += iv->getChannelFieldValue(values, TYPE_AC, CH0, FLD_IAC_2);
+    acCurrent += iv->getChannelFieldValue(values, TYPE_AC, CH0, FLD_IAC_3);
     return acCurrent;
 }
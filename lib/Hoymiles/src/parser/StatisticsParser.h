@@ -1,8 +1,10 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
 #include "Parser.h"
+#include <SnapshotArray.h>
+#include <array>
 #include <cstdint>
-#include <list>
+#include <vector>
 
 #define STATISTIC_PACKET_SIZE (7 * 16)
 
@@ -95,12 +97,90 @@ typedef struct {
     uint8_t digits; // number of valid digits after the decimal point
 } byteAssign_t;
 
+#define CHANNEL_TYPE_CNT (TYPE_INV + 1)
+#define FIELD_CNT (FLD_IAC_3 + 1)
+
+// most byte assignments of one inverter model
+#define BYTE_ASSIGN_MAX_COUNT 64
+// type, channel and field without byte assignment
+#define BYTE_ASSIGN_NONE 0xff
+
+// Position of every type, channel and field in the byte assignment of an inverter model
 typedef struct {
-    ChannelType_t type;
-    ChannelNum_t ch; // channel 0 - 5
-    FieldId_t fieldId; // field id
-    float offset; // offset (positive/negative) to be applied on the fetched value
-} fieldSettings_t;
+    uint8_t pos[CHANNEL_TYPE_CNT][CH_CNT][FIELD_CNT];
+    uint8_t channels[CHANNEL_TYPE_CNT]; // bit mask of the channels per type
+} byteAssignIndex_t;
+
+// Channels of one type in ascending order, enumerated from a bit mask without allocation
+class ChannelList {
+public:
+    class Iterator {
+    public:
+        explicit Iterator(const uint8_t mask)
+            : _mask(mask)
+            , _channel(first(mask))
+        {
+        }
+        const ChannelNum_t& operator*() const { return _channel; }
+        Iterator& operator++()
+        {
+            _mask &= _mask - 1;
+            _channel = first(_mask);
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return _mask != other._mask; }
+
+    private:
+        static ChannelNum_t first(const uint8_t mask) { return static_cast<ChannelNum_t>(mask != 0 ? __builtin_ctz(mask) : CH_CNT); }
+
+        uint8_t _mask;
+        ChannelNum_t _channel;
+    };
+
+    explicit ChannelList(const uint8_t mask = 0)
+        : _mask(mask)
+    {
+    }
+    Iterator begin() const { return Iterator(_mask); }
+    Iterator end() const { return Iterator(0); }
+    uint8_t size() const { return __builtin_popcount(_mask); }
+    bool contains(const ChannelNum_t channel) const { return channel < CH_CNT && (_mask & (1 << channel)); }
+
+private:
+    uint8_t _mask;
+};
+
+// Builds the index of a byte assignment at compile time, the first entry of a field wins
+template <size_t N>
+constexpr byteAssignIndex_t buildByteAssignIndex(const byteAssign_t (&byteAssignment)[N])
+{
+    static_assert(N <= BYTE_ASSIGN_MAX_COUNT, "Too many byte assignments");
+
+    byteAssignIndex_t index = {};
+    for (auto& type : index.pos) {
+        for (auto& channel : type) {
+            for (auto& field : channel) {
+                field = BYTE_ASSIGN_NONE;
+            }
+        }
+    }
+    for (size_t i = N; i-- > 0;) {
+        index.pos[byteAssignment[i].type][byteAssignment[i].ch][byteAssignment[i].fieldId] = i;
+        index.channels[byteAssignment[i].type] |= 1 << byteAssignment[i].ch;
+    }
+    return index;
+}
+
+typedef struct {
+    uint8_t pos; // in the byte assignment
+    float offset;
+} fieldOffset_t;
+
+// All values of one frame, copied out by StatisticsParser::getValues
+typedef struct {
+    float values[BYTE_ASSIGN_MAX_COUNT]; // by position in the byte assignment, only the entries of the model are set
+    uint32_t generation; // incremented every time the values are decoded
+} StatisticsValues_t;
 
 class StatisticsParser : public Parser {
 public:
@@ -109,16 +189,20 @@ public:
     void appendFragment(const uint8_t offset, const uint8_t* payload, const uint8_t len);
     void endAppendFragment();
 
-    void setByteAssignment(const byteAssign_t* byteAssignment, const uint8_t size);
+    void setByteAssignment(const byteAssign_t* byteAssignment, const uint8_t size, const byteAssignIndex_t* index);
 
     // Returns 1 based amount of expected bytes of statistic data
     uint8_t getExpectedByteCount();
 
     const byteAssign_t* getAssignmentByChannelField(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const;
-    fieldSettings_t* getSettingByChannelField(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId);
 
-    float getChannelFieldValue(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId);
+    // Returns the value decoded when the frame was received. Lock free, never blocks the writer
+    float getChannelFieldValue(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const;
+    // Consistent copy of all values of one frame, lock free
+    void getValues(StatisticsValues_t& values) const;
+    float getChannelFieldValue(const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const;
     String getChannelFieldValueString(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId);
+    String getChannelFieldValueString(const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const;
     bool hasChannelFieldValue(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const;
     const char* getChannelFieldUnit(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const;
     const char* getChannelFieldName(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const;
@@ -129,9 +213,9 @@ public:
     float getChannelFieldOffset(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId);
     void setChannelFieldOffset(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, const float offset);
 
-    std::list<ChannelType_t> getChannelTypes() const;
+    const std::array<ChannelType_t, CHANNEL_TYPE_CNT>& getChannelTypes() const;
     const char* getChannelTypeName(const ChannelType_t type) const;
-    std::list<ChannelNum_t> getChannelsByType(const ChannelType_t type) const;
+    ChannelList getChannelsByType(const ChannelType_t type) const;
 
     uint16_t getStringMaxPower(const uint8_t channel) const;
     void setStringMaxPower(const uint8_t channel, const uint16_t power);
@@ -153,17 +237,32 @@ public:
 
     bool getYieldDayCorrection() const;
     void setYieldDayCorrection(const bool enabled);
+
+    // Generation of the published values
+    uint32_t getGeneration() const;
+
 private:
-    void zeroFields(const FieldId_t* fields);
+    // Zeroes all given fields of all channels with a single decode
+    void zeroFields(const FieldId_t* fields, const uint8_t count);
+    // Patches the payload without decoding it, has to be called with the semaphore taken
+    bool writeFieldValue(const byteAssign_t* pos, float value);
+    // Decodes all fields (including the calculated ones) from the payload and publishes them
+    void decodeValues();
+    // Has to be called with the semaphore taken
+    float getFieldOffset(const uint8_t pos) const;
 
     uint8_t _payloadStatistic[STATISTIC_PACKET_SIZE] = {};
     uint8_t _statisticLength = 0;
-    uint16_t _stringMaxPower[CH_CNT];
+    uint16_t _stringMaxPower[CH_CNT] = {};
 
-    const byteAssign_t* _byteAssignment;
-    uint8_t _byteAssignmentSize;
+    const byteAssign_t* _byteAssignment = nullptr;
+    uint8_t _byteAssignmentSize = 0;
+    const byteAssignIndex_t* _byteAssignmentIndex = nullptr;
     uint8_t _expectedByteCount = 0;
-    std::list<fieldSettings_t> _fieldSettings;
+    // offset (positive/negative) to be applied on the fetched value, only fields with an offset are listed
+    std::vector<fieldOffset_t> _fieldOffsets;
+    // Published by decodeValues, read without the semaphore. Sized by the byte assignment of the model.
+    SnapshotArray<float> _values;
 
     uint32_t _rxFailureCount = 0;
     uint32_t _lastUpdateFromInternal = 0;
@@ -8,6 +8,13 @@ union serial_u {
     uint8_t b[8];
 };
 
+enum CountryModeId_t {
+    MODE_EU,
+    MODE_US,
+    MODE_BR,
+    CountryModeId_Max
+};
+
 // maximum buffer length of packet received / sent to RF24 module
 #define MAX_RF_PAYLOAD_SIZE 32
 
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Fixed capacity byte ring buffer for any number of producers and exactly one consumer.
+// Data is stored in N slots of S bytes. A write reserves all slots it needs at once, so the
+// bytes of one write are never interleaved with other writes. Producers never wait for each
+// other or for the consumer: if the buffer is full the write is dropped and counted.
+// The consumer stops at a slot which has been reserved but not yet filled.
+template <size_t S, size_t N>
+class MpscRingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Slot count has to be a power of two");
+    static_assert(S >= 1 && S <= 255, "Slot size has to fit into uint8_t");
+
+public:
+    MpscRingBuffer()
+    {
+        for (size_t i = 0; i < N; i++) {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    MpscRingBuffer(const MpscRingBuffer<S, N>&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer<S, N>&) = delete;
+
+    static constexpr size_t capacity()
+    {
+        return S * N;
+    }
+
+    // Producer: returns false if the data did not fit and has been dropped
+    bool write(const uint8_t data[], const size_t len)
+    {
+        if (len == 0) {
+            return true;
+        }
+
+        const uint32_t count = (len + S - 1) / S;
+        if (count > N) {
+            _droppedBytes.fetch_add(len, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Reserve count slots. The consumer frees the slots in order, so the reservation
+        // is free if its last slot is free.
+        uint32_t position = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint32_t last = position + count - 1;
+            const uint32_t sequence = _slots[last & (N - 1)].sequence.load(std::memory_order_acquire);
+            const int32_t diff = static_cast<int32_t>(sequence - last);
+            if (diff == 0) {
+                if (_head.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                _droppedBytes.fetch_add(len, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = _head.load(std::memory_order_relaxed);
+            }
+        }
+
+        size_t offset = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            Slot_t& slot = _slots[(position + i) & (N - 1)];
+            const size_t chunk = len - offset < S ? len - offset : S;
+            memcpy(slot.data, &data[offset], chunk);
+            slot.len = chunk;
+            offset += chunk;
+            slot.sequence.store(position + i + 1, std::memory_order_release);
+        }
+
+        const uint32_t used = position + count - _tail.load(std::memory_order_acquire);
+        uint32_t highWaterMark = _highWaterMark.load(std::memory_order_relaxed);
+        while (used > highWaterMark && !_highWaterMark.compare_exchange_weak(highWaterMark, used, std::memory_order_relaxed)) { }
+        return true;
+    }
+
+    // Consumer: copies the bytes of the filled slots in order into buffer, returns the number of bytes.
+    // A slot is only copied completely.
+    size_t read(uint8_t buffer[], const size_t maxLen)
+    {
+        size_t written = 0;
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot_t& slot = _slots[tail & (N - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != tail + 1 || written + slot.len > maxLen) {
+                break;
+            }
+            memcpy(&buffer[written], slot.data, slot.len);
+            written += slot.len;
+            slot.sequence.store(tail + N, std::memory_order_release);
+            tail++;
+        }
+        _tail.store(tail, std::memory_order_release);
+        return written;
+    }
+
+    // Free bytes, only a snapshot. A write can need more because every write starts a new slot.
+    size_t available() const
+    {
+        const uint32_t used = _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+        return used < N ? (N - used) * S : 0;
+    }
+
+    bool empty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    // Bytes which have been rejected because the buffer was full
+    uint32_t getDroppedBytes() const
+    {
+        return _droppedBytes.load(std::memory_order_relaxed);
+    }
+
+    // Maximum number of slots which have been in use at the same time
+    uint32_t getHighWaterMark() const
+    {
+        return _highWaterMark.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot_t {
+        // position + 1 when filled, position + N when free for the next round
+        std::atomic<uint32_t> sequence;
+        uint8_t len;
+        uint8_t data[S];
+    };
+
+    Slot_t _slots[N];
+
+    // Free running positions, _head is shared by the producers, _tail is only written by the consumer
+    std::atomic<uint32_t> _head { 0 };
+    std::atomic<uint32_t> _tail { 0 };
+
+    std::atomic<uint32_t> _droppedBytes { 0 };
+    std::atomic<uint32_t> _highWaterMark { 0 };
+};
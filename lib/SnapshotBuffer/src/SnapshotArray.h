@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Same latch as SnapshotBuffer for an array of word sized elements whose
+// length is only known at runtime. The memory is taken by resize(), which
+// has to be called before any reader accesses the array.
+template <typename M>
+class SnapshotArray {
+    static_assert(sizeof(M) == sizeof(uint32_t) && std::is_trivially_copyable<M>::value, "Elements have to be one word");
+
+public:
+    SnapshotArray() = default;
+    SnapshotArray(const SnapshotArray<M>&) = delete;
+    SnapshotArray& operator=(const SnapshotArray<M>&) = delete;
+
+    // Not thread safe, zeroes both copies
+    void resize(const size_t size)
+    {
+        _words.reset(size > 0 ? new std::atomic<uint32_t>[2 * size] : nullptr);
+        _size = size;
+        for (size_t i = 0; i < 2 * size; i++) {
+            _words[i].store(0, std::memory_order_relaxed);
+        }
+        _sequence.store(0, std::memory_order_release);
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    // Writer, publishes size() elements
+    void publish(const M* elements)
+    {
+        const uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+
+        // Readers use the copy selected by the lowest bit of the sequence
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        store(sequence & 1, elements);
+
+        _sequence.store(sequence + 2, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        store((sequence + 1) & 1, elements);
+    }
+
+    // Reader: copies size() elements of the latest or the previous publication, returns its version
+    uint32_t read(M* elements) const
+    {
+        uint32_t before;
+        do {
+            before = _sequence.load(std::memory_order_acquire);
+            const std::atomic<uint32_t>* copy = &_words[(before & 1) * _size];
+            for (size_t i = 0; i < _size; i++) {
+                const uint32_t word = copy[i].load(std::memory_order_relaxed);
+                memcpy(&elements[i], &word, sizeof(M));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (_sequence.load(std::memory_order_relaxed) != before);
+
+        return before / 2;
+    }
+
+    // Reader of a single element, belongs to the publication before or during the read
+    M readElement(const size_t index) const
+    {
+        const uint32_t sequence = _sequence.load(std::memory_order_acquire);
+        const uint32_t word = _words[(sequence & 1) * _size + index].load(std::memory_order_relaxed);
+        M element;
+        memcpy(&element, &word, sizeof(M));
+        return element;
+    }
+
+    // Number of publications since resize()
+    uint32_t getVersion() const
+    {
+        return _sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    void store(const uint32_t copy, const M* elements)
+    {
+        std::atomic<uint32_t>* words = &_words[copy * _size];
+        for (size_t i = 0; i < _size; i++) {
+            uint32_t word;
+            memcpy(&word, &elements[i], sizeof(M));
+            words[i].store(word, std::memory_order_relaxed);
+        }
+    }
+
+    std::unique_ptr<std::atomic<uint32_t>[]> _words;
+    size_t _size = 0;
+    std::atomic<uint32_t> _sequence { 0 };
+};
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Sequence lock for exactly one writer and any number of readers, with two
+// copies of the value (latch). The writer never blocks. It updates one copy
+// while the readers are directed to the other one, therefore a reader never
+// waits for a preempted writer. A reader retries only if the writer advanced
+// to the copy being read, i.e. made progress, and never sees a torn value.
+// The value is stored as atomic words so that the copy itself is race free.
+template <typename T>
+class SnapshotBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "Value has to be trivially copyable");
+
+public:
+    SnapshotBuffer()
+    {
+        publish(T {});
+    }
+    SnapshotBuffer(const SnapshotBuffer<T>&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer<T>&) = delete;
+
+    // Writer
+    void publish(const T& value)
+    {
+        uint32_t words[WORDS] = {};
+        memcpy(words, &value, sizeof(T));
+
+        const uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+
+        // Readers use the copy selected by the lowest bit of the sequence
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        store(sequence & 1, words);
+
+        _sequence.store(sequence + 2, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        store((sequence + 1) & 1, words);
+    }
+
+    // Reader: returns a consistent copy of the latest or the previous value
+    void read(T& value) const
+    {
+        uint32_t words[WORDS];
+        uint32_t before;
+        do {
+            before = _sequence.load(std::memory_order_acquire);
+            const std::atomic<uint32_t>* copy = _words[before & 1];
+            for (size_t i = 0; i < WORDS; i++) {
+                words[i] = copy[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (_sequence.load(std::memory_order_relaxed) != before);
+
+        memcpy(&value, words, sizeof(T));
+    }
+
+    // Reader of a single word sized member at the given byte offset of T, e.g. one
+    // element of an array. A single word is never torn and needs no retry, it
+    // belongs to the value published before or during the read.
+    template <typename M>
+    M readWord(const size_t offset) const
+    {
+        static_assert(sizeof(M) == sizeof(uint32_t) && std::is_trivially_copyable<M>::value, "Member has to be one word");
+
+        const uint32_t sequence = _sequence.load(std::memory_order_acquire);
+        const uint32_t word = _words[sequence & 1][offset / sizeof(uint32_t)].load(std::memory_order_relaxed);
+        M member;
+        memcpy(&member, &word, sizeof(M));
+        return member;
+    }
+
+    // Number of published values including the initial default value
+    uint32_t getVersion() const
+    {
+        return _sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    void store(const uint32_t copy, const uint32_t* words)
+    {
+        for (size_t i = 0; i < WORDS; i++) {
+            _words[copy][i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint32_t> _sequence { 0 };
+    std::atomic<uint32_t> _words[2][WORDS];
+};
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed capacity, allocation free ring buffer for exactly one producer and one consumer.
+// The producer methods do not block and can be called from an interrupt context
+// while the consumer is running in a task (and vice versa).
+template <typename T, size_t N>
+class SpscRingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Capacity has to be a power of two");
+
+public:
+    SpscRingBuffer() = default;
+    SpscRingBuffer(const SpscRingBuffer<T, N>&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer<T, N>&) = delete;
+
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+    // Producer: returns the next free slot to be filled in place or nullptr if the buffer is full.
+    // The slot becomes visible to the consumer by calling commit().
+    T* prepare()
+    {
+        const uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N) {
+            _overflowCount.store(_overflowCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &_buffer[head & (N - 1)];
+    }
+
+    void commit()
+    {
+        const uint32_t head = _head.load(std::memory_order_relaxed) + 1;
+        _head.store(head, std::memory_order_release);
+
+        const uint32_t used = head - _tail.load(std::memory_order_acquire);
+        if (used > _highWaterMark.load(std::memory_order_relaxed)) {
+            _highWaterMark.store(used, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T& item)
+    {
+        T* slot = prepare();
+        if (slot == nullptr) {
+            return false;
+        }
+        *slot = item;
+        commit();
+        return true;
+    }
+
+    // Consumer: returns the oldest element or nullptr if the buffer is empty.
+    // The element stays valid until pop() is called.
+    T* front()
+    {
+        const uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (_head.load(std::memory_order_acquire) == tail) {
+            return nullptr;
+        }
+        return &_buffer[tail & (N - 1)];
+    }
+
+    void pop()
+    {
+        const uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (_head.load(std::memory_order_acquire) != tail) {
+            _tail.store(tail + 1, std::memory_order_release);
+        }
+    }
+
+    bool pop(T& item)
+    {
+        const T* slot = front();
+        if (slot == nullptr) {
+            return false;
+        }
+        item = *slot;
+        pop();
+        return true;
+    }
+
+    // Can be called from both sides, the result is only a snapshot
+    size_t size() const
+    {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    // Number of elements which have been rejected because the buffer was full
+    uint32_t getOverflowCount() const
+    {
+        return _overflowCount.load(std::memory_order_relaxed);
+    }
+
+    // Maximum number of elements which have been in the buffer at the same time
+    uint32_t getHighWaterMark() const
+    {
+        return _highWaterMark.load(std::memory_order_relaxed);
+    }
+
+private:
+    T _buffer[N];
+
+    // Free running indices, only written by the producer (_head) or the consumer (_tail)
+    std::atomic<uint32_t> _head { 0 };
+    std::atomic<uint32_t> _tail { 0 };
+
+    // Only written by the producer
+    std::atomic<uint32_t> _overflowCount { 0 };
+    std::atomic<uint32_t> _highWaterMark { 0 };
+};
@@ -30,4 +30,14 @@ void TimeoutHelper::reset()
 bool TimeoutHelper::occured() const
 {
     return millis() > (startMillis + timeout);
+}
+
+uint32_t TimeoutHelper::getTimeout() const
+{
+    return timeout;
+}
+
+uint32_t TimeoutHelper::elapsed() const
+{
+    return millis() - startMillis;
 }
\ No newline at end of file
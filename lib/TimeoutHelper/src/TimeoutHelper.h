@@ -10,6 +10,8 @@ public:
     void extend(const uint32_t ms);
     void reset();
     bool occured() const;
+    uint32_t getTimeout() const;
+    uint32_t elapsed() const;
 
 private:
     uint32_t startMillis;
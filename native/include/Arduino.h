@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+/*
+ * Minimal host stand-in for the Arduino core. Only the subset used by
+ * lib/Hoymiles is provided. Time is taken from HostClock which can be
+ * switched to a virtual clock to run simulations faster than real time.
+ */
+
+#include "FreeRTOS.h"
+#include "HardwareSerial.h"
+#include "Print.h"
+#include "Stream.h"
+#include "WString.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#define ARDUINO_ISR_ATTR
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+using std::max;
+using std::min;
+
+unsigned long millis();
+unsigned long micros();
+void delay(const uint32_t ms);
+void yield();
+
+bool getLocalTime(struct tm* info, const uint32_t ms = 5000);
+
+inline int digitalPinToInterrupt(const int pin)
+{
+    return pin;
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+/*
+ * Controls the host implementation of the CMT2300A wrapper. Counts the SPI
+ * register accesses done by HoymilesRadio_CMT and lets a responder answer
+ * the transmitted packets.
+ */
+namespace CmtHost {
+struct Statistics_t {
+    uint32_t channelWrites;
+    uint32_t channelWritesRedundant; // value was already set
+    uint32_t channelReads;
+    uint32_t paLevelWrites;
+    uint32_t paLevelWritesRedundant;
+    uint32_t packetsSent;
+};
+
+// Called for every written packet with the current channel and transmit power
+using Responder = std::function<void(const uint8_t buf[], const uint8_t len, const uint8_t channel, const int8_t paLevel)>;
+
+// The chip is reported as not connected by default, HoymilesRadio_CMT stays uninitialized then
+void setConnected(const bool connected);
+void setResponder(Responder responder);
+// Queues a received packet, it is available with the next rxFifoAvailable()/available()
+void injectPacket(const uint8_t buf[], const uint8_t len, const int8_t rssi);
+
+Statistics_t getStatistics();
+void resetStatistics();
+int8_t getPALevel();
+}
@@ -0,0 +1,53 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+/*
+ * Host stand-in for the FreeRTOS semaphore API used by the Hoymiles parsers.
+ * A binary semaphore is used (like xSemaphoreCreateMutex on the ESP32) so that
+ * giving an already available semaphore is harmless.
+ *
+ * Tasks (used by RadioTask) run as std::thread. Priority, stack size and core
+ * are ignored, one tick is one millisecond of real time (also if HostClock is
+ * virtual).
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#define pdPASS 1
+#define pdFAIL 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xffffffffUL
+#define tskNO_AFFINITY 0x7fffffff
+#define pdMS_TO_TICKS(ms) static_cast<TickType_t>(ms)
+#define portYIELD_FROM_ISR(...)
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+struct HostSemaphore {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool available = true;
+};
+
+typedef HostSemaphore* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, const TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+
+struct HostTask;
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, const uint32_t stackDepth,
+    void* parameter, UBaseType_t priority, TaskHandle_t* createdTask, const BaseType_t core);
+// Only the calling task can be deleted (task == nullptr)
+void vTaskDelete(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(const BaseType_t clearCountOnExit, const TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
@@ -0,0 +1,11 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+/*
+ * There is no interrupt controller on the host. The handler is stored but
+ * never triggered; radios depending on it stay silent.
+ */
+void attachInterrupt(const uint8_t pin, std::function<void(void)> intRoutine, const int mode);
@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "Stream.h"
+
+/*
+ * Writes everything to stdout of the host process.
+ */
+class HardwareSerial : public Stream {
+public:
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int availableForWrite() override { return 4096; }
+};
+
+extern HardwareSerial Serial;
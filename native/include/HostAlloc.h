@@ -0,0 +1,15 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Counts all heap allocations done through operator new of the host program.
+ * Used to verify that code paths do not allocate in steady state.
+ */
+namespace HostAlloc {
+uint64_t getAllocationCount();
+uint64_t getAllocatedBytes();
+// Bytes currently allocated (usable size of the blocks)
+uint64_t getLiveBytes();
+}
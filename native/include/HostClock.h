@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Time base for millis() and micros() on the host.
+ * In real time mode the monotonic clock of the host is used. In virtual
+ * mode time only moves when advance() is called which allows simulations
+ * to run faster than real time and to be fully deterministic.
+ */
+class HostClockClass {
+public:
+    void setVirtual(const bool enabled);
+    bool isVirtual() const;
+
+    void advanceMicros(const uint64_t us);
+
+    uint64_t getMicros() const;
+
+private:
+    bool _virtual = false;
+    uint64_t _virtualMicros = 0;
+};
+
+extern HostClockClass HostClock;
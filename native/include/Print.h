@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "WString.h"
+#include <cstddef>
+#include <cstdint>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+/*
+ * Host stand-in for the Arduino Print class.
+ */
+class Print {
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str);
+
+    // Bytes which can be written without blocking
+    virtual int availableForWrite() { return 0; }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t print(const String& str);
+    size_t print(const char* str);
+    size_t print(const char c);
+    size_t print(const unsigned char value, const int base = DEC);
+    size_t print(const int value, const int base = DEC);
+    size_t print(const unsigned int value, const int base = DEC);
+    size_t print(const long value, const int base = DEC);
+    size_t print(const unsigned long value, const int base = DEC);
+    size_t print(const long long value, const int base = DEC);
+    size_t print(const unsigned long long value, const int base = DEC);
+    size_t print(const double value, const int digits = 2);
+
+    size_t println();
+    size_t println(const String& str);
+    size_t println(const char* str);
+    size_t println(const char c);
+    size_t println(const unsigned char value, const int base = DEC);
+    size_t println(const int value, const int base = DEC);
+    size_t println(const unsigned int value, const int base = DEC);
+    size_t println(const long value, const int base = DEC);
+    size_t println(const unsigned long value, const int base = DEC);
+    size_t println(const long long value, const int base = DEC);
+    size_t println(const unsigned long long value, const int base = DEC);
+    size_t println(const double value, const int digits = 2);
+
+private:
+    size_t printNumber(unsigned long long value, const int base, const bool negative);
+};
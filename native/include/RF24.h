@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+/*
+ * Host stand-in for the nRF24 RF24 library. It reports no connected chip so
+ * HoymilesRadio_NRF never becomes initialized on the host. Traffic is
+ * simulated one layer above by HoymilesRadio_Sim.
+ */
+
+#include "Arduino.h"
+#include "SPI.h"
+#include <cstdint>
+
+typedef enum {
+    RF24_PA_MIN = 0,
+    RF24_PA_LOW,
+    RF24_PA_HIGH,
+    RF24_PA_MAX,
+    RF24_PA_ERROR
+} rf24_pa_dbm_e;
+
+typedef enum {
+    RF24_1MBPS = 0,
+    RF24_2MBPS,
+    RF24_250KBPS
+} rf24_datarate_e;
+
+typedef enum {
+    RF24_CRC_DISABLED = 0,
+    RF24_CRC_8,
+    RF24_CRC_16
+} rf24_crclength_e;
+
+class RF24 {
+public:
+    RF24(const uint16_t /*cePin*/, const uint16_t /*csPin*/, const uint32_t /*spiSpeed*/ = 10000000)
+    {
+    }
+
+    bool begin(SPIClass* /*spiBus*/) { return false; }
+    bool isChipConnected() { return false; }
+    bool isPVariant() { return false; }
+
+    bool setDataRate(const rf24_datarate_e /*speed*/) { return true; }
+    void enableDynamicPayloads() { }
+    void setCRCLength(const rf24_crclength_e /*length*/) { }
+    void setAddressWidth(const uint8_t /*width*/) { }
+    void setRetries(const uint8_t /*delay*/, const uint8_t /*count*/) { }
+    void maskIRQ(const bool /*tx*/, const bool /*fail*/, const bool /*rx*/) { }
+    void setPALevel(const uint8_t /*level*/, const bool /*lnaEnable*/ = true) { }
+
+    void openReadingPipe(const uint8_t /*number*/, const uint64_t /*address*/) { }
+    void openWritingPipe(const uint64_t /*address*/) { }
+    void startListening() { }
+    void stopListening() { }
+
+    void setChannel(const uint8_t channel) { _channel = channel; }
+    uint8_t getChannel() { return _channel; }
+
+    bool available() { return false; }
+    uint8_t getDynamicPayloadSize() { return 0; }
+    bool testRPD() { return false; }
+    void read(void* /*buf*/, const uint8_t /*len*/) { }
+    bool write(const void* /*buf*/, const uint8_t /*len*/) { return false; }
+    uint8_t flush_rx() { return 0; }
+
+private:
+    uint8_t _channel = 0;
+};
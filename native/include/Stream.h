@@ -0,0 +1,7 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "Print.h"
+
+class Stream : public Print {
+};
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/*
+ * Host stand-in for the Arduino String class backed by std::string.
+ */
+class String {
+public:
+    String() = default;
+    String(const char* str);
+    String(const std::string& str);
+    explicit String(const char c);
+    explicit String(const int value, const unsigned char base = 10);
+    explicit String(const unsigned int value, const unsigned char base = 10);
+    explicit String(const long value, const unsigned char base = 10);
+    explicit String(const unsigned long value, const unsigned char base = 10);
+    explicit String(const float value, const unsigned int decimalPlaces = 2);
+    explicit String(const double value, const unsigned int decimalPlaces = 2);
+
+    const char* c_str() const { return _str.c_str(); }
+    unsigned int length() const { return _str.length(); }
+
+    String& operator+=(const String& rhs);
+    String& operator+=(const char* rhs);
+    String& operator+=(const char c);
+
+    bool operator==(const String& rhs) const { return _str == rhs._str; }
+    bool operator==(const char* rhs) const { return _str == rhs; }
+    bool operator!=(const String& rhs) const { return _str != rhs._str; }
+
+    friend String operator+(const String& lhs, const String& rhs);
+
+private:
+    std::string _str;
+};
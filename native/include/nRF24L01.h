@@ -0,0 +1,4 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+// Register definitions are not required by the host stand-in of RF24.
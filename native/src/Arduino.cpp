@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "Arduino.h"
+#include "FunctionalInterrupt.h"
+#include "HostClock.h"
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+
+unsigned long millis()
+{
+    return static_cast<unsigned long>(HostClock.getMicros() / 1000);
+}
+
+unsigned long micros()
+{
+    return static_cast<unsigned long>(HostClock.getMicros());
+}
+
+void delay(const uint32_t ms)
+{
+    if (HostClock.isVirtual()) {
+        HostClock.advanceMicros(static_cast<uint64_t>(ms) * 1000);
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+bool getLocalTime(struct tm* info, const uint32_t /*ms*/)
+{
+    const time_t now = time(nullptr);
+    localtime_r(&now, info);
+    return true;
+}
+
+void attachInterrupt(const uint8_t /*pin*/, std::function<void(void)> /*intRoutine*/, const int /*mode*/)
+{
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new HostSemaphore();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, const TickType_t /*ticks*/)
+{
+    std::unique_lock<std::mutex> lock(semaphore->mutex);
+    semaphore->cv.wait(lock, [semaphore] { return semaphore->available; });
+    semaphore->available = false;
+    return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore)
+{
+    {
+        std::lock_guard<std::mutex> lock(semaphore->mutex);
+        if (semaphore->available) {
+            return pdFAIL;
+        }
+        semaphore->available = true;
+    }
+    semaphore->cv.notify_one();
+    return pdPASS;
+}
+
+// Never freed: a notification racing with the end of the task stays harmless
+struct HostTask {
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint32_t notifications = 0;
+};
+
+static thread_local HostTask* currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* /*name*/, const uint32_t /*stackDepth*/,
+    void* parameter, UBaseType_t /*priority*/, TaskHandle_t* createdTask, const BaseType_t /*core*/)
+{
+    HostTask* task = new HostTask();
+    if (createdTask != nullptr) {
+        *createdTask = task;
+    }
+
+    std::thread([task, function, parameter] {
+        currentTask = task;
+        function(parameter);
+    }).detach();
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t /*task*/)
+{
+    // The thread ends when the task function returns
+}
+
+uint32_t ulTaskNotifyTake(const BaseType_t clearCountOnExit, const TickType_t ticks)
+{
+    HostTask* task = currentTask;
+    std::unique_lock<std::mutex> lock(task->mutex);
+    const auto ready = [task] { return task->notifications > 0; };
+    if (ticks == portMAX_DELAY) {
+        task->cv.wait(lock, ready);
+    } else if (!task->cv.wait_for(lock, std::chrono::milliseconds(ticks), ready)) {
+        return 0;
+    }
+
+    const uint32_t notifications = task->notifications;
+    task->notifications = clearCountOnExit ? 0 : notifications - 1;
+    return notifications;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notifications++;
+    }
+    task->cv.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken)
+{
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken != nullptr) {
+        *higherPriorityTaskWoken = pdTRUE;
+    }
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, stdout);
+}
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "Benchmark.h"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+BenchmarkArgs::BenchmarkArgs(const int argc, char* argv[])
+    : _args(argv, argv + argc)
+{
+}
+
+BenchmarkArgs::BenchmarkArgs(const char* options)
+{
+    append(options);
+}
+
+BenchmarkArgs BenchmarkArgs::with(const char* options) const
+{
+    BenchmarkArgs args = *this;
+    args.append(options);
+    return args;
+}
+
+void BenchmarkArgs::append(const char* options)
+{
+    const char* word = options;
+    while (*word != '\0') {
+        const char* end = strchr(word, ' ');
+        if (end == nullptr) {
+            end = word + strlen(word);
+        }
+        if (end > word) {
+            _args.emplace_back(word, end);
+        }
+        word = *end == ' ' ? end + 1 : end;
+    }
+}
+
+const char* BenchmarkArgs::find(const char* key) const
+{
+    for (size_t i = _args.size(); i-- > 0;) {
+        if (_args[i] != key) {
+            continue;
+        }
+        if (i + 1 < _args.size() && _args[i + 1].compare(0, 2, "--") != 0) {
+            return _args[i + 1].c_str();
+        }
+        return "";
+    }
+    return nullptr;
+}
+
+bool BenchmarkArgs::has(const char* key) const
+{
+    return find(key) != nullptr;
+}
+
+const char* BenchmarkArgs::getString(const char* key, const char* defaultValue) const
+{
+    const char* value = find(key);
+    return (value != nullptr && *value != '\0') ? value : defaultValue;
+}
+
+uint32_t BenchmarkArgs::getUint(const char* key, const uint32_t defaultValue) const
+{
+    const char* value = find(key);
+    return (value != nullptr && *value != '\0') ? strtoul(value, nullptr, 0) : defaultValue;
+}
+
+float BenchmarkArgs::getFloat(const char* key, const float defaultValue) const
+{
+    const char* value = find(key);
+    return (value != nullptr && *value != '\0') ? strtof(value, nullptr) : defaultValue;
+}
+
+std::vector<uint32_t> BenchmarkArgs::getUintList(const char* key, const std::vector<uint32_t>& defaultValue) const
+{
+    const char* value = find(key);
+    if (value == nullptr || *value == '\0') {
+        return defaultValue;
+    }
+
+    std::vector<uint32_t> list;
+    char* end = const_cast<char*>(value);
+    while (*end != '\0') {
+        list.push_back(strtoul(end, &end, 0));
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            break;
+        }
+    }
+    return list;
+}
+
+std::vector<std::string> BenchmarkArgs::getStringList(const char* key, const std::vector<std::string>& defaultValue) const
+{
+    const char* value = find(key);
+    if (value == nullptr || *value == '\0') {
+        return defaultValue;
+    }
+
+    std::vector<std::string> list;
+    const char* start = value;
+    for (const char* end = value;; end++) {
+        if (*end == ',' || *end == '\0') {
+            list.emplace_back(start, end);
+            start = end + 1;
+        }
+        if (*end == '\0') {
+            break;
+        }
+    }
+    return list;
+}
+
+uint64_t benchmarkCpuMicros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
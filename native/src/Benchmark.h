@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <Print.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Options of a suite, "--key value" or "--flag". An option given more than
+ * once takes the last value, with() appends options to a copy.
+ */
+class BenchmarkArgs {
+public:
+    BenchmarkArgs(const int argc, char* argv[]);
+    // Options separated by spaces, e.g. "--inverters 10 --mix hm"
+    explicit BenchmarkArgs(const char* options);
+
+    BenchmarkArgs with(const char* options) const;
+
+    bool has(const char* key) const;
+    const char* getString(const char* key, const char* defaultValue) const;
+    uint32_t getUint(const char* key, const uint32_t defaultValue) const;
+    float getFloat(const char* key, const float defaultValue) const;
+    std::vector<uint32_t> getUintList(const char* key, const std::vector<uint32_t>& defaultValue) const;
+    std::vector<std::string> getStringList(const char* key, const std::vector<std::string>& defaultValue) const;
+
+private:
+    void append(const char* options);
+    const char* find(const char* key) const;
+
+    std::vector<std::string> _args;
+};
+
+typedef int (*BenchmarkFunc_t)(const BenchmarkArgs& args);
+
+struct BenchmarkSuite_t {
+    const char* name;
+    const char* description;
+    BenchmarkFunc_t func;
+};
+
+// Discards all output, used to keep the library messages out of the measurements
+class NullOutput : public Print {
+public:
+    size_t write(uint8_t /*c*/) override { return 1; }
+    size_t write(const uint8_t* /*buffer*/, size_t size) override { return size; }
+    int availableForWrite() override { return 4096; }
+};
+
+// Process cpu time in microseconds
+uint64_t benchmarkCpuMicros();
+
+int benchmarkFleet(const BenchmarkArgs& args);
+int benchmarkCmt(const BenchmarkArgs& args);
+int benchmarkThreads(const BenchmarkArgs& args);
+int benchmarkMicro(const BenchmarkArgs& args);
+int benchmarkReplay(const BenchmarkArgs& args);
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Runs HoymilesRadio_CMT against the host CMT2300A wrapper (CmtHost) which
+counts every register access, see runCmtFleet(). The packets are answered by
+virtual HMS inverters near, at medium distance and far away. A request only
+reaches an inverter if the transmit power is high enough for its path loss.
+The fleet runs once with every transmit power mode.
+
+Options:
+  --tx-power <list>    static, adaptive or both (default static,adaptive)
+  and the options of runCmtFleet()
+*/
+#include "Benchmark.h"
+#include "Scenario.h"
+#include <cstdio>
+#include <string>
+
+static const char* const distanceNames[] = { "near", "medium", "far" };
+
+int benchmarkCmt(const BenchmarkArgs& args)
+{
+    printf("%9s %7s %9s %7s %9s %9s %9s %8s %8s %9s %9s %9s\n",
+        "TX power", "Polls", "Failures", "TX", "Retunes", "Skipped", "Redund.", "PA", "Redund.", "dBm", "dBm", "dBm");
+    printf("%9s %7s %9s %7s %9s %9s %9s %8s %8s %9s %9s %9s\n",
+        "", "", "", "", "", "", "retunes", "writes", "PA", distanceNames[DISTANCE_NEAR], distanceNames[DISTANCE_MEDIUM], distanceNames[DISTANCE_FAR]);
+
+    uint32_t packetsSent = 0;
+    for (const std::string& mode : args.getStringList("--tx-power", { "static", "adaptive" })) {
+        const CmtResult_t r = runCmtFleet(args.with(("--tx-power " + mode).c_str()));
+        printf("%9s %7u %9u %7u %9u %9u %9u %8u %8u %9.1f %9.1f %9.1f\n",
+            mode.c_str(), r.polls, r.failures, r.spi.packetsSent,
+            r.spi.channelWrites, r.retune.skipped, r.spi.channelWritesRedundant,
+            r.spi.paLevelWrites, r.spi.paLevelWritesRedundant,
+            r.level[DISTANCE_NEAR], r.level[DISTANCE_MEDIUM], r.level[DISTANCE_FAR]);
+        packetsSent = r.spi.packetsSent;
+    }
+    printf("\nWithout the cache every packet writes the channel register: %u writes\n", packetsSent);
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Runs the complete Hoymiles stack (HoymilesClass::loop, command queue, fragment
+reassembly and all parsers) against fleets of virtual inverters in virtual
+time, see runFleet() for the workload options. Every combination of fleet
+size, mix and compared value is simulated and reported in one row. Further
+tables are printed for the workloads which were enabled.
+
+Options:
+  --inverters <list>   fleet sizes (default 10,25,50,100)
+  --mix <list>         mixes to simulate, e.g. hm,hms,hm+hms (default mixed)
+  --compare <option>   simulates every value of a SimFleet option, e.g.
+                       adaptive-poll, learned-timeout, hopping, log or loss
+  --values <list>      values of the compared option (default depends on the option)
+*/
+#include "Benchmark.h"
+#include "Scenario.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+struct FleetRun_t {
+    std::string label;
+    FleetResult_t result;
+};
+
+static const struct {
+    const char* option;
+    const char* values;
+} comparisons[] = {
+    { "adaptive-poll", "off,on" },
+    { "learned-timeout", "off,on" },
+    { "hopping", "round-robin,adaptive" },
+    { "log", "off,deferred,eager" },
+    { "loss", "0.02,0.05,0.1,0.2" },
+};
+
+static const char* const groupNames[] = { "stable", "cloudy", "offline", "far" };
+static const char* const priorityNames[] = { "control", "realtime", "metadata" };
+static const char* const classNames[] = { "realtime", "alarm", "devinfo", "config", "control" };
+static_assert(sizeof(groupNames) / sizeof(groupNames[0]) == FleetGroup_Max, "Missing group name");
+static_assert(sizeof(priorityNames) / sizeof(priorityNames[0]) == CommandPriority_Max, "Missing priority name");
+static_assert(sizeof(classNames) / sizeof(classNames[0]) == CommandLatencyClass_Max, "Missing latency class name");
+
+static void printGroups(const std::vector<FleetRun_t>& runs)
+{
+    printf("\n%-24s %8s %9s %8s %9s %11s %11s %9s\n",
+        "Run", "Group", "Inverters", "Polls", "Failed %", "Interval s", "Timeout ms", "Error W");
+    for (const FleetRun_t& run : runs) {
+        for (uint8_t g = 0; g < FleetGroup_Max; g++) {
+            const FleetGroupResult_t& r = run.result.groups[g];
+            if (r.inverters == 0) {
+                continue;
+            }
+            printf("%-24s %8s %9u %8u %9.2f %11.1f %11.0f %9.1f\n",
+                run.label.c_str(), groupNames[g], r.inverters, r.polls,
+                r.polls + r.failures > 0 ? 100.0f * r.failures / (r.polls + r.failures) : 0,
+                r.interval, r.timeout, r.powerError);
+        }
+    }
+}
+
+static void printLimits(const std::vector<FleetRun_t>& runs)
+{
+    printf("\n%-24s %10s %10s %12s %8s %10s %11s %10s %10s\n",
+        "Run", "Requested", "Coalesced", "Transmitted", "Saved %", "Exhausted", "Last limit", "Avg ms", "Max ms");
+    for (const FleetRun_t& run : runs) {
+        const FleetLimitResult_t& r = run.result.limits;
+        printf("%-24s %10u %10u %12u %8.1f %10u %11s %10.0f %10.0f\n",
+            run.label.c_str(), r.requested, r.coalesced, r.transmitted,
+            r.requested > 0 ? 100.0f * r.coalesced / r.requested : 0,
+            r.exhausted, r.mismatches == 0 ? "ok" : "ERROR",
+            r.delivered > 0 ? r.latencySum / 1000.0 / r.delivered : 0, r.latencyMax / 1000.0);
+    }
+
+    printf("\n%-24s %9s %9s %10s %10s %9s\n", "Run", "Queue", "Commands", "Wait avg ms", "Wait max ms", "Promoted");
+    for (const FleetRun_t& run : runs) {
+        for (uint8_t p = 0; p < CommandPriority_Max; p++) {
+            const CommandWaitStatistics_t& w = run.result.limits.wait[p];
+            printf("%-24s %9s %9u %10.0f %10u %9u\n",
+                p == 0 ? run.label.c_str() : "", priorityNames[p], w.count,
+                w.count > 0 ? static_cast<float>(w.totalWait) / w.count : 0, w.maxWait, w.promoted);
+        }
+    }
+}
+
+static void printRetransmit(const std::vector<FleetRun_t>& runs)
+{
+    printf("\n%-24s %9s %9s %10s %7s\n", "Run", "Class", "Rounds", "Fragments", "Saved");
+    for (const FleetRun_t& run : runs) {
+        for (uint8_t c = 0; c < CommandLatencyClass_Max; c++) {
+            const RetransmitStatistics_t& s = run.result.retransmit[c];
+            printf("%-24s %9s %9u %10u %7u\n",
+                c == 0 ? run.label.c_str() : "", classNames[c], s.rounds, s.fragments, s.fragments - s.rounds);
+        }
+    }
+}
+
+static void printLog(const std::vector<FleetRun_t>& runs)
+{
+    printf("\n%-24s %8s %11s %10s %14s\n", "Run", "Dropped", "Blocked ms", "UART kB", "Host total ms");
+    for (const FleetRun_t& run : runs) {
+        const FleetResult_t& r = run.result;
+        printf("%-24s %8u %11.1f %10.1f %14.1f\n",
+            run.label.c_str(), r.log.dropped, r.log.blockedUs / 1000.0, r.log.bytes / 1024.0, r.totalMs);
+    }
+}
+
+static void printChannels(const std::vector<FleetRun_t>& runs)
+{
+    printf("\n%-24s %8s %9s %10s %9s %10s\n", "Run", "Channel", "TX share", "Answered", "RX share", "Fragments");
+    for (const FleetRun_t& run : runs) {
+        const ChannelQualityTable& totals = run.result.channels;
+        uint32_t txTotal = 0;
+        uint32_t rxTotal = 0;
+        for (uint8_t i = 0; i < CHANNEL_QUALITY_CHANNELS; i++) {
+            txTotal += totals.getEntry(i).txCount;
+            rxTotal += totals.getEntry(i).rxSlots;
+        }
+        for (uint8_t i = 0; i < CHANNEL_QUALITY_CHANNELS; i++) {
+            const ChannelQualityEntry_t& e = totals.getEntry(i);
+            printf("%-24s %8u %8.1f%% %9.1f%% %8.1f%% %10u\n",
+                i == 0 ? run.label.c_str() : "", ChannelHopping::getChannel(i),
+                txTotal > 0 ? 100.0f * e.txCount / txTotal : 0,
+                e.txCount > 0 ? 100.0f * e.txAnswered / e.txCount : 0,
+                rxTotal > 0 ? 100.0f * e.rxSlots / rxTotal : 0,
+                e.rxFragments);
+        }
+    }
+}
+
+int benchmarkFleet(const BenchmarkArgs& args)
+{
+    const char* compare = args.getString("--compare", "");
+    const char* defaultValues = "";
+    for (const auto& c : comparisons) {
+        if (strcmp(compare, c.option) == 0) {
+            defaultValues = c.values;
+        }
+    }
+    const std::string defaults = std::string("--values ") + defaultValues;
+    const std::vector<std::string> values = *compare != '\0'
+        ? (args.has("--values") ? args : args.with(defaults.c_str())).getStringList("--values", {})
+        : std::vector<std::string> { "" };
+    if (values.empty()) {
+        printf("Missing --values for --compare %s\n", compare);
+        return 1;
+    }
+
+    const float duration = args.getUint("--duration", 300);
+
+    printf("%-24s %9s %8s %8s %8s %7s %9s %8s %7s %9s %9s %10s %6s %11s %11s %11s\n",
+        "Run", "Inverters", "Polls/s", "Cycle s", "First s", "p95 s", "Failed %", "TX", "Lost", "Overflows",
+        "RX early", "RX wait %", "Saved", "Host us/it", "Allocs/poll", "B/inverter");
+
+    std::vector<FleetRun_t> runs;
+    for (const uint32_t count : args.getUintList("--inverters", { 10, 25, 50, 100 })) {
+        for (const std::string& mix : args.getStringList("--mix", { "mixed" })) {
+            for (const std::string& value : values) {
+                std::string options = "--mix " + mix;
+                std::string label = std::to_string(count) + " " + mix;
+                if (!value.empty()) {
+                    options += std::string(" --") + compare + " " + value;
+                    label += " " + value;
+                }
+
+                const FleetResult_t r = runFleet(args.with(options.c_str()), count);
+                runs.push_back({ label, r });
+
+                const float pollsPerSec = r.polls / duration;
+                printf("%-24s %9u %8.2f %8.2f %8.1f %7.2f %9.2f %8u %7u %9u %9u %10.1f %6u %11.3f %11.2f %11.0f\n",
+                    label.c_str(),
+                    r.inverters,
+                    pollsPerSec,
+                    pollsPerSec > 0 ? r.inverters / pollsPerSec : 0,
+                    r.firstS,
+                    r.p95S,
+                    r.polls + r.failures > 0 ? 100.0f * r.failures / (r.polls + r.failures) : 0,
+                    r.tx,
+                    r.lost,
+                    r.overflows,
+                    r.rxTiming.completedEarly,
+                    r.rxTiming.totalTimeout > 0 ? 100.0f * r.rxTiming.totalElapsed / r.rxTiming.totalTimeout : 0,
+                    r.retransmit[LATENCY_REALTIME].fragments - r.retransmit[LATENCY_REALTIME].rounds,
+                    r.iterations > 0 ? static_cast<double>(r.hostMicros) / r.iterations : 0,
+                    r.polls > 0 ? static_cast<float>(r.allocations) / r.polls : 0,
+                    r.inverters > 0 ? static_cast<double>(r.libraryBytes) / r.inverters : 0);
+
+                if (r.missing > 0) {
+                    printf("%u inverters never delivered data\n", r.missing);
+                }
+            }
+        }
+    }
+
+    if (args.has("--cloudy") || args.has("--offline") || args.has("--far")) {
+        printGroups(runs);
+    }
+    if (args.has("--limits")) {
+        printLimits(runs);
+    }
+    if (args.has("--loss") || strcmp(compare, "loss") == 0) {
+        printRetransmit(runs);
+    }
+    if (args.has("--log") || args.has("--baud") || strcmp(compare, "log") == 0) {
+        printLog(runs);
+    }
+    if (args.has("--jam")) {
+        printChannels(runs);
+    }
+
+    return 0;
+}
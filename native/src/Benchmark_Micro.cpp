@@ -0,0 +1,513 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Single threaded micro benchmarks of the hot paths against their previous
+implementations, one section each:
+  crc          bitwise, table and slice-by-4 crc implementations. The one
+               used by the firmware is selected with -DHOY_CRC_IMPLEMENTATION
+  lookup       inverter lookup by serial and by fragment, linear scan
+               returning a shared_ptr against the serial and radio id index
+  fields       full render of all fields of every model, scan of the byte
+               assignment decoding on every access against StatisticsParser
+
+The results of the current implementations are checked by the native tests.
+
+Options:
+  --only <list>        sections to run (default all)
+  --iterations <n>     calls per implementation (default crc 200000, lookup 1000000, fields 20000)
+  --lengths <list>     crc: buffer sizes in bytes (default 11,27,100,250)
+  --inverters <list>   lookup: fleet sizes (default 10,50,200)
+  --seed <n>           random seed (default 1)
+*/
+#include "Benchmark.h"
+#include "HostAlloc.h"
+#include "SimFleet.h"
+#include <Hoymiles.h>
+#include <inverters/HERF_2CH.h>
+#include <inverters/HMS_1CH.h>
+#include <inverters/HMS_1CHv2.h>
+#include <inverters/HMS_2CH.h>
+#include <inverters/HMS_4CH.h>
+#include <inverters/HMT_4CH.h>
+#include <inverters/HMT_6CH.h>
+#include <inverters/HM_1CH.h>
+#include <inverters/HM_2CH.h>
+#include <inverters/HM_4CH.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <crc.h>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+
+typedef uint8_t (*Crc8Func_t)(const uint8_t buf[], const uint8_t len);
+typedef uint16_t (*Crc16Func_t)(const uint8_t buf[], const uint8_t len, const uint16_t start);
+typedef uint16_t (*Crc16Nrf24Func_t)(const uint8_t buf[], const uint16_t lenBits, const uint16_t startBit, const uint16_t crcIn);
+
+static volatile uintptr_t sink;
+
+static bool isSelected(const BenchmarkArgs& args, const char* section)
+{
+    const std::vector<std::string> only = args.getStringList("--only", {});
+    return only.empty() || std::find(only.begin(), only.end(), section) != only.end();
+}
+
+template <typename F>
+static double measureNs(const uint32_t iterations, F func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        func(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+static void printCrc(const BenchmarkArgs& args)
+{
+    std::mt19937 rng(args.getUint("--seed", 1));
+    const uint32_t iterations = args.getUint("--iterations", 200000);
+    uint8_t buf[256];
+    for (auto& b : buf) {
+        b = rng();
+    }
+
+    struct {
+        const char* name;
+        Crc8Func_t crc8;
+        Crc16Func_t crc16;
+        Crc16Nrf24Func_t crc16nrf24;
+    } const variants[] = {
+        { "bitwise", &crc8_bitwise, &crc16_bitwise, &crc16nrf24_bitwise },
+        { "table", &crc8_table, &crc16_table, &crc16nrf24_table },
+        { "slice4", nullptr, &crc16_slice4, nullptr },
+    };
+
+    auto printNs = [](const double ns) {
+        if (ns > 0) {
+            printf(" %12.1f", ns);
+        } else {
+            printf(" %12s", "-");
+        }
+    };
+
+    printf("Active crc implementation: %d\n", HOY_CRC_IMPLEMENTATION);
+    printf("%6s %-8s %12s %12s %12s %12s\n", "Bytes", "Variant", "crc8 ns", "crc16 ns", "nrf24 ns", "crc16 MB/s");
+
+    for (const uint32_t length : args.getUintList("--lengths", { 11, 27, 100, 250 })) {
+        const uint8_t len = length > 255 ? 255 : length;
+
+        for (const auto& v : variants) {
+            // The buffer start is varied to avoid the compiler hoisting the call out of the loop
+            const double ns8 = v.crc8 == nullptr ? 0 : measureNs(iterations, [&](uint32_t i) { sink += v.crc8(&buf[i & 1], len); });
+            const double ns16 = measureNs(iterations, [&](uint32_t i) { sink += v.crc16(&buf[i & 1], len, 0xffff); });
+            const double nsNrf = v.crc16nrf24 == nullptr ? 0 : measureNs(iterations, [&](uint32_t i) { sink += v.crc16nrf24(&buf[i & 1], len * 8, 0, 0xffff); });
+
+            printf("%6u %-8s", len, v.name);
+            printNs(ns8);
+            printNs(ns16);
+            printNs(nsNrf);
+            printf(" %12.1f\n", ns16 > 0 ? len * 1000.0 / ns16 : 0);
+        }
+    }
+}
+
+#define LOOKUP_METHODS 5
+
+static const char* const methodNames[LOOKUP_METHODS] = {
+    "scan serial", "scan fragment", "getInverterBySerial", "findInverterBySerial", "findInverterByFragment"
+};
+
+struct LookupKey_t {
+    uint64_t serial;
+    fragment_t fragment;
+};
+
+// Previous HoymilesClass::getInverterBySerial
+static std::shared_ptr<InverterAbstract> scanSerial(const std::vector<std::shared_ptr<InverterAbstract>>& inverters, const uint64_t serial)
+{
+    for (size_t i = 0; i < inverters.size(); i++) {
+        if (inverters[i]->serial() == serial) {
+            return inverters[i];
+        }
+    }
+    return nullptr;
+}
+
+// Previous HoymilesClass::getInverterByFragment
+static std::shared_ptr<InverterAbstract> scanFragment(const std::vector<std::shared_ptr<InverterAbstract>>& inverters, const fragment_t& fragment)
+{
+    if (fragment.len <= 4) {
+        return nullptr;
+    }
+
+    std::shared_ptr<InverterAbstract> inv;
+    for (size_t i = 0; i < inverters.size(); i++) {
+        inv = inverters[i];
+        serial_u p;
+        p.u64 = inv->serial();
+
+        if ((p.b[3] == fragment.fragment[1])
+            && (p.b[2] == fragment.fragment[2])
+            && (p.b[1] == fragment.fragment[3])
+            && (p.b[0] == fragment.fragment[4])) {
+
+            return inv;
+        }
+    }
+    return nullptr;
+}
+
+static InverterAbstract* lookup(const uint8_t method, const std::vector<std::shared_ptr<InverterAbstract>>& inverters, const LookupKey_t& key)
+{
+    switch (method) {
+    case 0:
+        return scanSerial(inverters, key.serial).get();
+    case 1:
+        return scanFragment(inverters, key.fragment).get();
+    case 2:
+        return Hoymiles.getInverterBySerial(key.serial).get();
+    case 3:
+        return Hoymiles.findInverterBySerial(key.serial);
+    default:
+        return Hoymiles.findInverterByFragment(key.fragment);
+    }
+}
+
+static void printLookup(const BenchmarkArgs& args)
+{
+    const uint32_t lookups = args.getUint("--iterations", 1000000);
+    std::mt19937 rng(args.getUint("--seed", 1));
+
+    printf("%10s", "Inverters");
+    for (const char* name : methodNames) {
+        printf(" %23s", name);
+    }
+    printf("   (ns per lookup)\n");
+
+    for (const uint32_t count : args.getUintList("--inverters", { 10, 50, 200 })) {
+        NullOutput output;
+        SimFleet fleet(args, &output);
+        fleet.addInverters(count, "mixed");
+
+        std::vector<std::shared_ptr<InverterAbstract>> inverters;
+        for (uint32_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+            inverters.push_back(Hoymiles.getInverterByPos(i));
+        }
+
+        // Answer fragment header: command, inverter radio id, dtu radio id, fragment id. One lookup in ten is unknown.
+        std::vector<LookupKey_t> keys(4096);
+        for (auto& key : keys) {
+            key.serial = rng() % 10 == 0 ? SimFleet::buildSerial("hm", count + rng() % 1000) : inverters[rng() % inverters.size()]->serial();
+            serial_u s;
+            s.u64 = key.serial;
+            key.fragment = {};
+            key.fragment.fragment[0] = 0x95;
+            key.fragment.fragment[1] = s.b[3];
+            key.fragment.fragment[2] = s.b[2];
+            key.fragment.fragment[3] = s.b[1];
+            key.fragment.fragment[4] = s.b[0];
+            key.fragment.fragment[9] = 0x01;
+            key.fragment.len = 27;
+        }
+
+        printf("%10u", count);
+        for (uint8_t m = 0; m < LOOKUP_METHODS; m++) {
+            uintptr_t sum = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < lookups; i++) {
+                sum += reinterpret_cast<uintptr_t>(lookup(m, inverters, keys[i % keys.size()]));
+            }
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            sink = sum;
+            printf(" %23.1f", ns / lookups);
+        }
+        printf("\n");
+    }
+}
+
+struct FieldOffset_t {
+    ChannelType_t type;
+    ChannelNum_t ch;
+    FieldId_t fieldId;
+    float offset;
+};
+
+// Previous StatisticsParser lookup and channel enumeration on a copy of the payload
+class LegacyFields {
+public:
+    LegacyFields(StatisticsParser& parser, const byteAssign_t* byteAssignment, const uint8_t size, const uint8_t* payload)
+        : _parser(parser)
+        , _byteAssignment(byteAssignment)
+        , _size(size)
+        , _payload(payload)
+    {
+    }
+
+    const byteAssign_t* getAssignment(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
+    {
+        for (uint8_t i = 0; i < _size; i++) {
+            if (_byteAssignment[i].type == type && _byteAssignment[i].ch == channel && _byteAssignment[i].fieldId == fieldId) {
+                return &_byteAssignment[i];
+            }
+        }
+        return nullptr;
+    }
+
+    const FieldOffset_t* getSetting(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
+    {
+        for (auto& i : _offsets) {
+            if (i.type == type && i.ch == channel && i.fieldId == fieldId) {
+                return &i;
+            }
+        }
+        return nullptr;
+    }
+
+    void setOffset(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, const float offset)
+    {
+        _offsets.push_back({ type, channel, fieldId, offset });
+    }
+
+    std::list<ChannelType_t> types() const
+    {
+        return { TYPE_AC, TYPE_DC, TYPE_INV };
+    }
+
+    std::list<ChannelNum_t> channels(const ChannelType_t type) const
+    {
+        std::list<ChannelNum_t> l;
+        for (uint8_t i = 0; i < _size; i++) {
+            if (_byteAssignment[i].type == type) {
+                l.push_back(_byteAssignment[i].ch);
+            }
+        }
+        l.unique();
+        return l;
+    }
+
+    bool has(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
+    {
+        return getAssignment(type, channel, fieldId) != nullptr;
+    }
+
+    const char* unit(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
+    {
+        return units[getAssignment(type, channel, fieldId)->unitId];
+    }
+
+    const char* name(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
+    {
+        return fields[getAssignment(type, channel, fieldId)->fieldId];
+    }
+
+    uint8_t digits(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
+    {
+        return getAssignment(type, channel, fieldId)->digits;
+    }
+
+    float value(const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId) const
+    {
+        const byteAssign_t* pos = getAssignment(type, channel, fieldId);
+        if (pos == nullptr) {
+            return 0;
+        }
+
+        if (pos->div == CMD_CALC) {
+            return calc(pos->start, pos->num);
+        }
+
+        uint32_t val = 0;
+        for (uint8_t ptr = pos->start; ptr != pos->start + pos->num; ptr++) {
+            val = (val << 8) | _payload[ptr];
+        }
+
+        float result;
+        if (pos->isSigned && pos->num == 2) {
+            result = static_cast<float>(static_cast<int16_t>(val));
+        } else if (pos->isSigned && pos->num == 4) {
+            result = static_cast<float>(static_cast<int32_t>(val));
+        } else {
+            result = static_cast<float>(val);
+        }
+        result /= static_cast<float>(pos->div);
+
+        const FieldOffset_t* setting = getSetting(type, channel, fieldId);
+        if (setting != nullptr) {
+            result += setting->offset;
+        }
+        return result;
+    }
+
+private:
+    float sum(const ChannelType_t type, const FieldId_t fieldId) const
+    {
+        float result = 0;
+        for (auto& channel : channels(type)) {
+            result += value(type, channel, fieldId);
+        }
+        return result;
+    }
+
+    float calc(const uint8_t func, const uint8_t arg0) const
+    {
+        switch (func) {
+        case CALC_TOTAL_YT:
+            return sum(TYPE_DC, FLD_YT);
+        case CALC_TOTAL_YD:
+            return sum(TYPE_DC, FLD_YD);
+        case CALC_CH_UDC:
+            return value(TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_UDC);
+        case CALC_TOTAL_PDC:
+            return sum(TYPE_DC, FLD_PDC);
+        case CALC_TOTAL_EFF: {
+            const float acPower = sum(TYPE_AC, FLD_PAC);
+            const float dcPower = sum(TYPE_DC, FLD_PDC);
+            return dcPower > 0 ? acPower / dcPower * 100.0f : 0;
+        }
+        case CALC_CH_IRR:
+            if (_parser.getStringMaxPower(arg0) > 0) {
+                return value(TYPE_DC, static_cast<ChannelNum_t>(arg0), FLD_PDC) / _parser.getStringMaxPower(arg0) * 100.0f;
+            }
+            return 0;
+        case CALC_TOTAL_IAC:
+            return value(TYPE_AC, CH0, FLD_IAC_1) + value(TYPE_AC, CH0, FLD_IAC_2) + value(TYPE_AC, CH0, FLD_IAC_3);
+        }
+        return 0;
+    }
+
+    StatisticsParser& _parser;
+    const byteAssign_t* _byteAssignment;
+    uint8_t _size;
+    const uint8_t* _payload;
+    std::list<FieldOffset_t> _offsets;
+};
+
+// StatisticsParser accessors in the signature of LegacyFields
+class IndexedFields {
+public:
+    explicit IndexedFields(StatisticsParser& parser)
+        : _parser(parser)
+    {
+    }
+    bool has(const ChannelType_t t, const ChannelNum_t c, const FieldId_t f) const { return _parser.hasChannelFieldValue(t, c, f); }
+    float value(const ChannelType_t t, const ChannelNum_t c, const FieldId_t f) const { return _parser.getChannelFieldValue(t, c, f); }
+    const char* unit(const ChannelType_t t, const ChannelNum_t c, const FieldId_t f) const { return _parser.getChannelFieldUnit(t, c, f); }
+    const char* name(const ChannelType_t t, const ChannelNum_t c, const FieldId_t f) const { return _parser.getChannelFieldName(t, c, f); }
+    uint8_t digits(const ChannelType_t t, const ChannelNum_t c, const FieldId_t f) const { return _parser.getChannelFieldDigits(t, c, f); }
+    const std::array<ChannelType_t, CHANNEL_TYPE_CNT>& types() const { return _parser.getChannelTypes(); }
+    ChannelList channels(const ChannelType_t t) const { return _parser.getChannelsByType(t); }
+
+private:
+    StatisticsParser& _parser;
+};
+
+// Value, unit, name and digits of every field of every channel, like the live view, MQTT and Prometheus
+template <typename Fields>
+static uint32_t render(const Fields& f)
+{
+    float valueSum = 0;
+    uint32_t fieldCount = 0;
+    for (auto& t : f.types()) {
+        for (auto& c : f.channels(t)) {
+            for (uint8_t i = 0; i < FIELD_CNT; i++) {
+                const FieldId_t fieldId = static_cast<FieldId_t>(i);
+                if (!f.has(t, c, fieldId)) {
+                    continue;
+                }
+                valueSum += f.value(t, c, fieldId);
+                sink += strlen(f.unit(t, c, fieldId)) + strlen(f.name(t, c, fieldId)) + f.digits(t, c, fieldId);
+                fieldCount++;
+            }
+        }
+    }
+    sink += static_cast<uintptr_t>(valueSum);
+    return fieldCount;
+}
+
+template <typename Fields>
+static double measureRender(const Fields& f, const uint32_t renders, uint32_t& fieldCount, uint64_t& allocations)
+{
+    const uint64_t allocationStart = HostAlloc::getAllocationCount();
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < renders; i++) {
+        fieldCount = render(f);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / renders;
+    allocations = HostAlloc::getAllocationCount() - allocationStart;
+    return ns;
+}
+
+static void printFields(const BenchmarkArgs& args)
+{
+    const uint32_t renders = args.getUint("--iterations", 20000);
+    std::mt19937 rng(args.getUint("--seed", 1));
+
+    std::unique_ptr<InverterAbstract> models[] = {
+        std::make_unique<HM_1CH>(nullptr, 0x112100000001),
+        std::make_unique<HM_2CH>(nullptr, 0x114100000001),
+        std::make_unique<HM_4CH>(nullptr, 0x116100000001),
+        std::make_unique<HERF_2CH>(nullptr, 0x282100000001),
+        std::make_unique<HMS_1CH>(nullptr, 0x112400000001),
+        std::make_unique<HMS_1CHv2>(nullptr, 0x112500000001),
+        std::make_unique<HMS_2CH>(nullptr, 0x114400000001),
+        std::make_unique<HMS_4CH>(nullptr, 0x116400000001),
+        std::make_unique<HMT_4CH>(nullptr, 0x136100000001),
+        std::make_unique<HMT_6CH>(nullptr, 0x138200000001),
+    };
+
+    printf("%27s %7s %14s %14s %9s %13s %14s\n", "Model", "Fields", "Scan ns", "Index ns", "Speedup", "Scan allocs", "Index allocs");
+
+    for (auto& inv : models) {
+        inv->init();
+        StatisticsParser& parser = *inv->Statistics();
+
+        uint8_t payload[STATISTIC_PACKET_SIZE];
+        for (auto& b : payload) {
+            b = rng();
+        }
+        parser.beginAppendFragment();
+        parser.clearBuffer();
+        parser.appendFragment(0, payload, parser.getExpectedByteCount());
+        parser.endAppendFragment();
+
+        LegacyFields legacy(parser, inv->getByteAssignment(), inv->getByteAssignmentSize(), payload);
+        for (auto& c : parser.getChannelsByType(TYPE_DC)) {
+            parser.setStringMaxPower(c, 400);
+            parser.setChannelFieldOffset(TYPE_DC, c, FLD_YT, c * 1.5f);
+            legacy.setOffset(TYPE_DC, c, FLD_YT, c * 1.5f);
+        }
+
+        uint32_t fieldCount = 0;
+        uint64_t scanAllocations;
+        uint64_t indexAllocations;
+        const double scanNs = measureRender(legacy, renders, fieldCount, scanAllocations);
+        const double indexNs = measureRender(IndexedFields(parser), renders, fieldCount, indexAllocations);
+
+        printf("%27s %7u %14.1f %14.1f %8.1fx %13.1f %14.1f\n", inv->typeName().c_str(), fieldCount, scanNs, indexNs, scanNs / indexNs,
+            static_cast<double>(scanAllocations) / renders, static_cast<double>(indexAllocations) / renders);
+    }
+}
+
+int benchmarkMicro(const BenchmarkArgs& args)
+{
+    if (isSelected(args, "crc")) {
+        printCrc(args);
+        printf("\n");
+    }
+    if (isSelected(args, "lookup")) {
+        printLookup(args);
+        printf("\n");
+    }
+    if (isSelected(args, "fields")) {
+        printFields(args);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Replays a capture of the RF traffic (see RfCapture and /api/rfcapture/download)
+through InverterAbstract::addRxFragment and the parsers of the commands. A
+command is evaluated with verifyAllFragments when the next command for the
+same inverter is transmitted, retransmit requests keep the fragments. Reports
+the evaluated commands and the host time spent per command.
+
+Without --file a capture of a simulated fleet is recorded first (see
+recordCapture()) and compared with its replay.
+
+Options:
+  --file <path>        capture to replay (default: record one)
+  --out <path>         write the recorded capture to this file
+  --repeat <n>         replay the capture n times for the timing (default 10)
+  --verbose            print library output
+  and the options of recordCapture()
+*/
+#include "Benchmark.h"
+#include "Scenario.h"
+#include <cstdio>
+
+int benchmarkReplay(const BenchmarkArgs& args)
+{
+    NullOutput nullOutput;
+    Print* output = args.has("--verbose") ? static_cast<Print*>(&Serial) : &nullOutput;
+
+    RecordResult_t recording = {};
+    const bool recorded = !args.has("--file");
+
+    if (recorded) {
+        recording = recordCapture(args);
+        printf("Recorded %zu bytes, %u completed commands, %u records overwritten\n",
+            recording.capture.size(), recording.completed, recording.overwritten);
+
+        if (args.has("--out")) {
+            FILE* f = fopen(args.getString("--out", ""), "wb");
+            if (f == nullptr || fwrite(recording.capture.data(), 1, recording.capture.size(), f) != recording.capture.size()) {
+                printf("Unable to write %s\n", args.getString("--out", ""));
+            }
+            if (f != nullptr) {
+                fclose(f);
+            }
+        }
+    } else {
+        FILE* f = fopen(args.getString("--file", ""), "rb");
+        if (f == nullptr) {
+            printf("Unable to read %s\n", args.getString("--file", ""));
+            return 1;
+        }
+        uint8_t chunk[4096];
+        size_t len;
+        while ((len = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+            recording.capture.insert(recording.capture.end(), chunk, chunk + len);
+        }
+        fclose(f);
+    }
+
+    ReplayResult_t r;
+    if (!replayCapture(recording.capture, args.getUint("--repeat", 10), r, output)) {
+        printf("Invalid capture\n");
+        return 1;
+    }
+
+    const uint32_t commands = r.complete + r.incomplete + r.noAnswer + r.errors;
+    printf("\n%8s %8s %10s %8s %8s %9s %11s %9s %7s %14s\n",
+        "TX", "RX", "CRC error", "Unknown", "Skipped", "Complete", "Incomplete", "No answer", "Error", "Host us/cmd");
+    printf("%8u %8u %10u %8u %8u %9u %11u %9u %7u %14.2f\n",
+        r.tx, r.rx, r.crcErrors, r.unknown, r.skipped, r.complete, r.incomplete, r.noAnswer, r.errors,
+        commands > 0 ? r.hostUs / commands : 0);
+
+    if (recorded) {
+        uint32_t mismatches = 0;
+        for (const auto& v : recording.values) {
+            const ReplayValues_t& replayed = r.values[v.first];
+            if (replayed.power != v.second.power || replayed.yieldTotal != v.second.yieldTotal) {
+                mismatches++;
+            }
+        }
+        printf("\nRecorded: %u completed, replayed: %u completed, %u inverters with different values\n",
+            recording.completed, r.complete, mismatches);
+    }
+
+    return 0;
+}
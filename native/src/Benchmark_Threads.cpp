@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Measures the data exchanged between threads in real time, one section each:
+  task         radio loop in the main loop against the radio task next to a
+               consumer blocking the main loop (see runRadioTask())
+  snapshot     SnapshotBuffer with a writer publishing as fast as possible
+  statistics   StatisticsParser without readers, with readers holding the
+               semaphore (previous read path) and with lock-free readers
+  spsc         fragment handoff, SpscRingBuffer against a locked std::queue
+  mpsc         console messages of several producers, MpscRingBuffer against
+               a locked buffer, once with a fast and once with a serial consumer
+
+Options:
+  --only <list>        sections to run (default all)
+  --duration <ms>      duration of the task, snapshot and statistics runs (default 3000)
+  --threads <n>        statistics readers and mpsc producers (default 4)
+  --model <type>       statistics: hm, hms or hmt (default hmt)
+  --fragments <n>      spsc: fragments per run (default 2000000)
+  --writes <n>         mpsc: messages per producer (default 20000)
+  --burst <n>          mpsc: messages a producer writes before it sleeps for 1 ms (default 16)
+  --baud <n>           mpsc: baud rate of the serial consumer (default 115200)
+  --seed <n>           random seed (default 1)
+  and the options of runRadioTask()
+*/
+#include "Benchmark.h"
+#include "Scenario.h"
+#include "SimFleet.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static bool isSelected(const BenchmarkArgs& args, const char* section)
+{
+    const std::vector<std::string> only = args.getStringList("--only", {});
+    return only.empty() || std::find(only.begin(), only.end(), section) != only.end();
+}
+
+static void printTask(const BenchmarkArgs& args)
+{
+    const float duration = args.getUint("--duration", 3000) / 1000.0f;
+
+    printf("%6s %9s %8s %9s %11s %11s %10s %8s %9s %13s\n",
+        "Mode", "Commands", "Cmds/s", "Failed %", "RX avg ms", "Timeout ms", "Overflows", "Wakeups", "Reads", "Inconsistent");
+    for (const char* mode : { "off", "on" }) {
+        const TaskResult_t r = runRadioTask(args.with((std::string("--radio-task ") + mode).c_str()));
+        const float failureRate = r.succeeded + r.failed > 0 ? 100.0f * r.failed / (r.succeeded + r.failed) : 0;
+        printf("%6s %9u %8.2f %9.2f %11.1f %11.1f %10u %8u %9u %13u\n",
+            strcmp(mode, "on") == 0 ? "task" : "loop", r.succeeded, r.succeeded / duration, failureRate, r.rxElapsed, r.rxTimeout,
+            r.overflows, r.wakeups, r.reads, r.inconsistent);
+    }
+}
+
+static void printStatistics(const BenchmarkArgs& args)
+{
+    NullOutput output;
+    SimFleet fleet(args, &output);
+    auto inv = fleet.addInverter(SimFleet::buildSerial(args.getString("--model", "hmt"), 0));
+    if (inv == nullptr) {
+        printf("Unknown model\n");
+        return;
+    }
+
+    const uint32_t readers = args.getUint("--threads", 4);
+    const uint32_t durationMs = args.getUint("--duration", 3000);
+    const float seconds = durationMs / 1000.0f;
+
+    printf("Model: %s, %u fields\n\n", inv->typeName().c_str(), inv->getByteAssignmentSize());
+    printf("%10s %8s %10s %11s %11s %13s %15s %13s\n",
+        "Readers", "Threads", "Frames/s", "Decode p99", "Decode max", "Snapshots/s", "Field reads/s", "Inconsistent");
+
+    static const char* const modes[] = { "none", "locked", "lock-free" };
+    for (const StatisticsReaders_t mode : { READERS_NONE, READERS_LOCKED, READERS_LOCK_FREE }) {
+        const StatisticsResult_t r = runStatisticsReaders(*inv, mode, readers, durationMs);
+        printf("%10s %8u %10.0f %9.2fus %9.1fus %13.0f %15.0f %13llu\n",
+            modes[mode], mode != READERS_NONE ? readers : 0, r.frames / seconds, r.p99Us, r.maxUs,
+            r.reads / seconds, r.fieldReads / seconds,
+            static_cast<unsigned long long>(r.inconsistent));
+    }
+}
+
+static void printSpsc(const BenchmarkArgs& args)
+{
+    const uint32_t count = args.getUint("--fragments", 2000000);
+
+    printf("%-14s %12s %12s %10s %10s %7s\n", "Buffer", "Fragments", "ns/fragment", "Full", "Max used", "Errors");
+    for (const bool locked : { true, false }) {
+        const HandoffResult_t r = runSpsc(count, locked);
+        printf("%-14s %12u %12.1f %10u %10u %7u\n",
+            locked ? "queue+mutex" : "SpscRingBuffer", count, r.seconds * 1e9 / count, r.full, r.highWaterMark, r.errors);
+    }
+}
+
+static void printMpsc(const BenchmarkArgs& args)
+{
+    const uint32_t producers = std::min<uint32_t>(args.getUint("--threads", 4), 255);
+    const uint32_t writes = args.getUint("--writes", 20000);
+    const uint32_t burst = args.getUint("--burst", 16);
+    const uint32_t seed = args.getUint("--seed", 1);
+
+    printf("%9s %7s %12s %10s %10s %10s %10s %7s\n",
+        "Consumer", "Buffer", "Msgs/s", "Received", "Dropped", "p99 ns", "Max ns", "Errors");
+    for (const uint32_t baud : { 0u, args.getUint("--baud", 115200) }) {
+        for (const bool locked : { false, true }) {
+            const HandoffResult_t r = runMpsc(producers, writes, burst, baud, seed, locked);
+            printf("%9s %7s %12.0f %10llu %10llu %10.0f %10.0f %7u\n",
+                baud == 0 ? "fast" : "uart", locked ? "mutex" : "mpsc", r.written / r.seconds,
+                static_cast<unsigned long long>(r.received), static_cast<unsigned long long>(r.dropped),
+                r.p99Ns, r.maxNs, r.errors);
+        }
+    }
+}
+
+int benchmarkThreads(const BenchmarkArgs& args)
+{
+    if (isSelected(args, "task")) {
+        printTask(args);
+        printf("\n");
+    }
+    if (isSelected(args, "snapshot")) {
+        uint32_t reads;
+        const uint32_t torn = runSnapshotStress(args.getUint("--duration", 3000), reads);
+        printf("SnapshotBuffer: %u reads, %u torn\n\n", reads, torn);
+    }
+    if (isSelected(args, "statistics")) {
+        printStatistics(args);
+        printf("\n");
+    }
+    if (isSelected(args, "spsc")) {
+        printSpsc(args);
+        printf("\n");
+    }
+    if (isSelected(args, "mpsc")) {
+        printMpsc(args);
+    }
+    return 0;
+}
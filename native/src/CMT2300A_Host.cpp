@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Host implementation of the CMT2300A wrapper. There is no chip on the host
+therefore isChipConnected() fails by default and HoymilesRadio_CMT stays
+uninitialized. The object is still created by HoymilesRadio_CMT::init() and
+used for frequency/channel calculations, which is why the register state that
+is relevant for them is kept here. CmtHost can pretend a connected chip, it
+counts the register accesses and delivers injected packets.
+*/
+#include "CmtHost.h"
+#include <cmt2300wrapper.h>
+#include <cstring>
+#include <deque>
+
+struct HostPacket {
+    uint8_t data[32];
+    uint8_t len;
+    int8_t rssi;
+};
+
+static uint8_t hostChannel = 0;
+static int8_t hostPaLevel = INT8_MIN;
+static bool hostConnected = false;
+static CmtHost::Responder hostResponder;
+static std::deque<HostPacket> hostRxFifo;
+static CmtHost::Statistics_t hostStatistics = {};
+
+void CmtHost::setConnected(const bool connected)
+{
+    hostConnected = connected;
+}
+
+void CmtHost::setResponder(Responder responder)
+{
+    hostResponder = responder;
+}
+
+void CmtHost::injectPacket(const uint8_t buf[], const uint8_t len, const int8_t rssi)
+{
+    HostPacket packet;
+    packet.len = len < sizeof(packet.data) ? len : sizeof(packet.data);
+    memcpy(packet.data, buf, packet.len);
+    packet.rssi = rssi;
+    hostRxFifo.push_back(packet);
+}
+
+CmtHost::Statistics_t CmtHost::getStatistics()
+{
+    return hostStatistics;
+}
+
+void CmtHost::resetStatistics()
+{
+    hostStatistics = {};
+}
+
+int8_t CmtHost::getPALevel()
+{
+    return hostPaLevel;
+}
+
+CMT2300A::CMT2300A(const uint8_t pin_sdio, const uint8_t pin_clk, const uint8_t pin_cs, const uint8_t pin_fcs, const uint32_t spi_speed)
+{
+    _pin_sdio = pin_sdio;
+    _pin_clk = pin_clk;
+    _pin_cs = pin_cs;
+    _pin_fcs = pin_fcs;
+    _spi_speed = spi_speed;
+}
+
+bool CMT2300A::begin(void)
+{
+    return _init_pins() && _init_radio();
+}
+
+bool CMT2300A::isChipConnected()
+{
+    return hostConnected;
+}
+
+bool CMT2300A::startListening(void)
+{
+    return true;
+}
+
+bool CMT2300A::stopListening(void)
+{
+    return true;
+}
+
+bool CMT2300A::available(void)
+{
+    return !hostRxFifo.empty();
+}
+
+void CMT2300A::read(void* buf, const uint8_t len)
+{
+    if (hostRxFifo.empty()) {
+        return;
+    }
+    memcpy(buf, hostRxFifo.front().data, len < hostRxFifo.front().len ? len : hostRxFifo.front().len);
+    hostRxFifo.pop_front();
+}
+
+bool CMT2300A::write(const uint8_t* buf, const uint8_t len)
+{
+    hostStatistics.packetsSent++;
+    if (hostResponder) {
+        hostResponder(buf, len, hostChannel, hostPaLevel);
+    }
+    return true;
+}
+
+void CMT2300A::setChannel(const uint8_t channel)
+{
+    hostStatistics.channelWrites++;
+    hostStatistics.channelWritesRedundant += channel == hostChannel ? 1 : 0;
+    hostChannel = channel;
+}
+
+uint8_t CMT2300A::getChannel(void)
+{
+    hostStatistics.channelReads++;
+    return hostChannel;
+}
+
+uint8_t CMT2300A::getDynamicPayloadSize(void)
+{
+    return hostRxFifo.empty() ? 0 : hostRxFifo.front().len;
+}
+
+int CMT2300A::getRssiDBm()
+{
+    return hostRxFifo.empty() ? -128 : hostRxFifo.front().rssi;
+}
+
+bool CMT2300A::setPALevel(const int8_t level)
+{
+    if (level < -10 || level > 20) {
+        return false;
+    }
+    hostStatistics.paLevelWrites++;
+    hostStatistics.paLevelWritesRedundant += level == hostPaLevel ? 1 : 0;
+    hostPaLevel = level;
+    return true;
+}
+
+bool CMT2300A::rxFifoAvailable()
+{
+    return !hostRxFifo.empty();
+}
+
+uint32_t CMT2300A::getBaseFrequency() const
+{
+    return getBaseFrequency(_frequencyBand);
+}
+
+FrequencyBand_t CMT2300A::getFrequencyBand() const
+{
+    return _frequencyBand;
+}
+
+void CMT2300A::setFrequencyBand(const FrequencyBand_t mode)
+{
+    _frequencyBand = mode;
+    _init_radio();
+}
+
+void CMT2300A::flush_rx(void)
+{
+    hostRxFifo.clear();
+}
+
+bool CMT2300A::_init_pins()
+{
+    return true;
+}
+
+bool CMT2300A::_init_radio()
+{
+    // Like the chip, loading the register bank resets the channel and the transmit power
+    hostChannel = 0;
+    hostPaLevel = INT8_MIN;
+    return true;
+}
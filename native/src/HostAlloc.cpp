@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HostAlloc.h"
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+static std::atomic<uint64_t> allocationCount { 0 };
+static std::atomic<uint64_t> allocatedBytes { 0 };
+static std::atomic<uint64_t> liveBytes { 0 };
+
+uint64_t HostAlloc::getAllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t HostAlloc::getAllocatedBytes()
+{
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t HostAlloc::getLiveBytes()
+{
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+static void* countedAlloc(const size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    liveBytes.fetch_add(malloc_usable_size(ptr), std::memory_order_relaxed);
+    return ptr;
+}
+
+static void countedFree(void* ptr)
+{
+    if (ptr != nullptr) {
+        liveBytes.fetch_sub(malloc_usable_size(ptr), std::memory_order_relaxed);
+    }
+    std::free(ptr);
+}
+
+void* operator new(size_t size)
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size)
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    countedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    countedFree(ptr);
+}
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HostClock.h"
+#include <chrono>
+
+HostClockClass HostClock;
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+void HostClockClass::setVirtual(const bool enabled)
+{
+    if (enabled && !_virtual) {
+        _virtualMicros = getMicros();
+    }
+    _virtual = enabled;
+}
+
+bool HostClockClass::isVirtual() const
+{
+    return _virtual;
+}
+
+void HostClockClass::advanceMicros(const uint64_t us)
+{
+    _virtualMicros += us;
+}
+
+uint64_t HostClockClass::getMicros() const
+{
+    if (_virtual) {
+        return _virtualMicros;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HoymilesRadio_Sim.h"
+#include "HostClock.h"
+#include <Hoymiles.h>
+
+void HoymilesRadio_Sim::init(const uint32_t seed)
+{
+    _random.seed(seed);
+    _isInitialized = true;
+}
+
+void HoymilesRadio_Sim::loop()
+{
+    if (!_isInitialized) {
+        return;
+    }
+
+    const uint64_t now = HostClock.getMicros();
+    if (now - _lastRxSwitch >= SIM_RX_SLOT_US) {
+        switchRxChannel();
+    }
+
+    // Fragments which are "on air" are handed over like in the hardware drivers
+    uint8_t fifoUsed = 0;
+    while (!_airQueue.empty() && _airQueue.top().dueMicros <= now) {
+        const SimFragment& air = _airQueue.top();
+        if (isLost(*air.inverter, _rxChannel)) {
+            _lostFragmentCount++;
+        } else if (_rxFifoDepth > 0 && fifoUsed >= _rxFifoDepth) {
+            // Arrived since the last loop() but the chip had no space left
+            _fifoOverflowCount++;
+        } else {
+            fifoUsed++;
+            fragment_t fragment = air.fragment;
+            fragment.channel = _rxChannel;
+            if (!_rxBuffer.push(fragment)) {
+                HOY_LOG(RADIO, WARN, "Sim: Buffer full\r\n");
+            }
+        }
+        _airQueue.pop();
+    }
+
+    const fragment_t* f;
+    while ((f = _rxBuffer.front()) != nullptr) {
+        Hoymiles.getRfCapture().addRx(RF_CAPTURE_SIM, *f);
+
+        if (!checkFragmentCrc(*f)) {
+            HOY_LOG(RADIO, WARN, "Frame kaputt\r\n");
+        } else {
+            InverterAbstract* inv = Hoymiles.findInverterByFragment(*f);
+            if (nullptr != inv) {
+                HOY_LOG(RADIO, DEBUG, "RX Sim --> ");
+                dumpBuf(f->fragment, f->len, false);
+                HOY_LOG(RADIO, DEBUG, "| %d dBm\r\n", f->rssi);
+
+                _channelHopping.addRxFragment(*inv, *f);
+                handleReceivedFragment(*inv, *f);
+                _rxFragmentCount++;
+            } else {
+                HOY_LOG(RADIO, WARN, "Inverter Not found!\r\n");
+            }
+        }
+        _rxBuffer.pop();
+    }
+
+    handleReceivedPackage();
+}
+
+VirtualInverter* HoymilesRadio_Sim::addVirtualInverter(const InverterAbstract& model, const VirtualInverterConfig& config)
+{
+    _inverters.push_back(std::make_unique<VirtualInverter>(model, config));
+    return _inverters.back().get();
+}
+
+VirtualInverter* HoymilesRadio_Sim::getVirtualInverter(const uint64_t serial)
+{
+    for (auto& inv : _inverters) {
+        if (inv->serial() == serial) {
+            return inv.get();
+        }
+    }
+    return nullptr;
+}
+
+void HoymilesRadio_Sim::removeVirtualInverters()
+{
+    _inverters.clear();
+    while (!_airQueue.empty()) {
+        _airQueue.pop();
+    }
+}
+
+void HoymilesRadio_Sim::setAirtime(const uint32_t airtimeUs)
+{
+    _airtimeUs = airtimeUs;
+}
+
+void HoymilesRadio_Sim::setRxFifoDepth(const uint8_t depth)
+{
+    _rxFifoDepth = depth;
+}
+
+ChannelHopping& HoymilesRadio_Sim::getChannelHopping()
+{
+    return _channelHopping;
+}
+
+void HoymilesRadio_Sim::removeInverter(const InverterAbstract& inv)
+{
+    _channelHopping.removeInverter(inv);
+}
+
+uint32_t HoymilesRadio_Sim::getTxCount() const
+{
+    return _txCount;
+}
+
+uint32_t HoymilesRadio_Sim::getRxFragmentCount() const
+{
+    return _rxFragmentCount;
+}
+
+uint32_t HoymilesRadio_Sim::getLostFragmentCount() const
+{
+    return _lostFragmentCount;
+}
+
+uint32_t HoymilesRadio_Sim::getFifoOverflowCount() const
+{
+    return _fifoOverflowCount;
+}
+
+void HoymilesRadio_Sim::resetStatistics()
+{
+    _txCount = 0;
+    _rxFragmentCount = 0;
+    _lostFragmentCount = 0;
+    _fifoOverflowCount = 0;
+}
+
+bool HoymilesRadio_Sim::isLost(const VirtualInverter& inverter, const uint8_t channel)
+{
+    const uint8_t index = ChannelHopping::getChannelIndex(channel);
+    return isLost(inverter.getConfig().lossRate)
+        || (index < CHANNEL_QUALITY_CHANNELS && isLost(inverter.getConfig().channelLossRate[index]));
+}
+
+bool HoymilesRadio_Sim::isLost(const float rate)
+{
+    if (rate <= 0) {
+        return false;
+    }
+    return std::uniform_real_distribution<float>(0, 1)(_random) < rate;
+}
+
+void HoymilesRadio_Sim::switchRxChannel()
+{
+    _rxChannel = _channelHopping.getRxChannel();
+    _lastRxSwitch = HostClock.getMicros();
+}
+
+void HoymilesRadio_Sim::sendEsbPacket(CommandAbstract& cmd)
+{
+    cmd.incrementSendCount();
+
+    cmd.setRouterAddress(DtuSerial().u64);
+
+    const uint8_t txChannel = _channelHopping.getTxChannel(Hoymiles.findInverterBySerial(cmd.getTargetAddress()));
+
+    HOY_LOG(RADIO, DEBUG, "TX %s Sim Channel: %d --> ", cmd.getCommandName().c_str(), txChannel);
+    dumpBuf(cmd.getDataPayload(), cmd.getDataSize());
+    Hoymiles.getRfCapture().addTx(RF_CAPTURE_SIM, txChannel, cmd.getDataPayload(), cmd.getDataSize());
+
+    _txCount++;
+    _busyFlag = true;
+    _rxTimeout.set(cmd.getTimeout());
+    switchRxChannel();
+
+    VirtualInverter* inv = getVirtualInverter(cmd.getTargetAddress());
+    if (inv == nullptr || isLost(*inv, txChannel)) {
+        return;
+    }
+
+    fragment_t response[VIRTUAL_MAX_RESPONSE_FRAGMENTS];
+    const uint8_t count = inv->handleRequest(cmd.getDataPayload(), cmd.getDataSize(), response);
+
+    const VirtualInverterConfig& config = inv->getConfig();
+    uint64_t due = HostClock.getMicros() + _airtimeUs + config.latencyUs;
+    for (uint8_t i = 0; i < count; i++) {
+        if (config.jitterUs > 0) {
+            due += std::uniform_int_distribution<uint32_t>(0, config.jitterUs)(_random);
+        }
+
+        // Lost fragments are determined when they are received on the current rx channel
+        _airQueue.push({ due, _sequence++, response[i], inv });
+        due += _airtimeUs + config.fragmentSpacingUs;
+    }
+}
+
+void HoymilesRadio_Sim::handleRxPeriodEnd()
+{
+    _channelHopping.finishRxPeriod();
+}
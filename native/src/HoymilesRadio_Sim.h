@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "VirtualInverter.h"
+#include <ChannelHopping.h>
+#include <HoymilesRadio.h>
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+// air time of a single packet
+#define SIM_DEFAULT_AIRTIME_US 1300
+
+// time between two rx channel switches (like HoymilesRadio_NRF)
+#define SIM_RX_SLOT_US 4000
+
+/*
+ * Radio backend without hardware. Sent commands are answered by the registered
+ * virtual inverters. The answers are delivered, after the configured latency and
+ * with the configured loss, through the same path as fragments received by
+ * HoymilesRadio_NRF/CMT. The channels are selected like in HoymilesRadio_NRF,
+ * a packet on a channel with a configured channel loss rate gets lost with
+ * this additional probability.
+ */
+class HoymilesRadio_Sim : public HoymilesRadio {
+public:
+    void init(const uint32_t seed = 1);
+    void loop();
+
+    VirtualInverter* addVirtualInverter(const InverterAbstract& model, const VirtualInverterConfig& config);
+    VirtualInverter* getVirtualInverter(const uint64_t serial);
+    void removeVirtualInverters();
+
+    void setAirtime(const uint32_t airtimeUs);
+    // Packets the radio chip holds until loop() reads them (NRF24: 3), further packets are dropped.
+    // 0 = unlimited, the default because the simulations tick fast enough to never overflow.
+    void setRxFifoDepth(const uint8_t depth);
+
+    ChannelHopping& getChannelHopping();
+
+    void removeInverter(const InverterAbstract& inv);
+
+    uint32_t getTxCount() const;
+    uint32_t getRxFragmentCount() const;
+    uint32_t getLostFragmentCount() const;
+    uint32_t getFifoOverflowCount() const;
+    void resetStatistics();
+
+private:
+    struct SimFragment {
+        uint64_t dueMicros;
+        uint32_t sequence;
+        fragment_t fragment;
+        VirtualInverter* inverter;
+
+        bool operator>(const SimFragment& other) const
+        {
+            return dueMicros != other.dueMicros ? dueMicros > other.dueMicros : sequence > other.sequence;
+        }
+    };
+
+    void sendEsbPacket(CommandAbstract& cmd);
+    void handleRxPeriodEnd();
+    void switchRxChannel();
+    bool isLost(const VirtualInverter& inverter, const uint8_t channel);
+    bool isLost(const float rate);
+
+    std::vector<std::unique_ptr<VirtualInverter>> _inverters;
+    std::priority_queue<SimFragment, std::vector<SimFragment>, std::greater<SimFragment>> _airQueue;
+    uint32_t _sequence = 0;
+
+    std::mt19937 _random;
+    uint32_t _airtimeUs = SIM_DEFAULT_AIRTIME_US;
+    uint8_t _rxFifoDepth = 0;
+
+    ChannelHopping _channelHopping;
+    uint8_t _rxChannel = 0;
+    uint64_t _lastRxSwitch = 0;
+
+    uint32_t _txCount = 0;
+    uint32_t _rxFragmentCount = 0;
+    uint32_t _lostFragmentCount = 0;
+    uint32_t _fifoOverflowCount = 0;
+};
@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "Print.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::write(const char* str)
+{
+    return write(reinterpret_cast<const uint8_t*>(str), strlen(str));
+}
+
+size_t Print::printf(const char* format, ...)
+{
+    char buf[64];
+    va_list arg;
+    va_start(arg, format);
+    va_list copy;
+    va_copy(copy, arg);
+    const int len = vsnprintf(buf, sizeof(buf), format, copy);
+    va_end(copy);
+
+    if (len < 0) {
+        va_end(arg);
+        return 0;
+    }
+
+    if (static_cast<size_t>(len) < sizeof(buf)) {
+        va_end(arg);
+        return write(reinterpret_cast<const uint8_t*>(buf), len);
+    }
+
+    std::vector<char> temp(len + 1);
+    vsnprintf(temp.data(), temp.size(), format, arg);
+    va_end(arg);
+    return write(reinterpret_cast<const uint8_t*>(temp.data()), len);
+}
+
+size_t Print::printNumber(unsigned long long value, const int base, const bool negative)
+{
+    char buf[8 * sizeof(value) + 2];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+
+    const int b = (base < 2) ? 10 : base;
+    do {
+        const char c = value % b;
+        value /= b;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (value);
+
+    if (negative) {
+        *--str = '-';
+    }
+    return write(str);
+}
+
+size_t Print::print(const String& str)
+{
+    return write(str.c_str());
+}
+
+size_t Print::print(const char* str)
+{
+    return write(str);
+}
+
+size_t Print::print(const char c)
+{
+    return write(static_cast<uint8_t>(c));
+}
+
+size_t Print::print(const unsigned char value, const int base)
+{
+    return print(static_cast<unsigned long long>(value), base);
+}
+
+size_t Print::print(const int value, const int base)
+{
+    return print(static_cast<long long>(value), base);
+}
+
+size_t Print::print(const unsigned int value, const int base)
+{
+    return print(static_cast<unsigned long long>(value), base);
+}
+
+size_t Print::print(const long value, const int base)
+{
+    return print(static_cast<long long>(value), base);
+}
+
+size_t Print::print(const unsigned long value, const int base)
+{
+    return print(static_cast<unsigned long long>(value), base);
+}
+
+size_t Print::print(const long long value, const int base)
+{
+    if (base == 10 && value < 0) {
+        return printNumber(-static_cast<unsigned long long>(value), base, true);
+    }
+    return printNumber(static_cast<unsigned long long>(value), base, false);
+}
+
+size_t Print::print(const unsigned long long value, const int base)
+{
+    return printNumber(value, base, false);
+}
+
+size_t Print::print(const double value, const int digits)
+{
+    return printf("%.*f", digits, value);
+}
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+size_t Print::println(const String& str)
+{
+    return print(str) + println();
+}
+
+size_t Print::println(const char* str)
+{
+    return print(str) + println();
+}
+
+size_t Print::println(const char c)
+{
+    return print(c) + println();
+}
+
+size_t Print::println(const unsigned char value, const int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(const int value, const int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(const unsigned int value, const int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(const long value, const int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(const unsigned long value, const int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(const long long value, const int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(const unsigned long long value, const int base)
+{
+    return print(value, base) + println();
+}
+
+size_t Print::println(const double value, const int digits)
+{
+    return print(value, digits) + println();
+}
@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+/*
+ * Scenarios shared by the benchmark suites and the native tests
+ * (test/test_*). The runners only measure, the suites print the results and
+ * the tests check them.
+ */
+#include "Benchmark.h"
+#include "CmtHost.h"
+#include <Hoymiles.h>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+enum FleetGroup_t {
+    GROUP_STABLE,
+    GROUP_CLOUDY, // power changes under passing clouds
+    GROUP_OFFLINE, // switched off, never answers
+    GROUP_FAR, // long latency and jitter
+    FleetGroup_Max,
+};
+
+struct FleetGroupResult_t {
+    uint32_t inverters;
+    uint32_t polls;
+    uint32_t failures; // failed realtime data requests
+    float interval; // average poll interval at the end (s)
+    float timeout; // average realtime data timeout at the end (ms)
+    float powerError; // average difference between real and reported power (W)
+};
+
+struct FleetLimitResult_t {
+    uint32_t requested;
+    uint32_t coalesced;
+    uint32_t transmitted;
+    uint32_t exhausted;
+    uint32_t mismatches; // inverters without the last requested limit after the drain
+    uint32_t delivered;
+    uint64_t latencySum; // µs until the virtual inverter received a limit
+    uint64_t latencyMax;
+    CommandWaitStatistics_t wait[CommandPriority_Max];
+};
+
+struct FleetLogResult_t {
+    uint32_t dropped; // deferred records which did not fit into the log buffer
+    uint64_t blockedUs; // radio loop blocked by the serial port
+    uint64_t bytes;
+};
+
+struct FleetResult_t {
+    uint32_t inverters;
+    uint32_t polls;
+    uint32_t failures;
+    uint32_t missing; // inverters without any update
+    float firstS; // until every inverter delivered data once
+    float meanS; // interval between two updates of the same inverter
+    float p95S;
+    float maxS;
+    uint32_t fragments;
+    uint32_t tx;
+    uint32_t lost;
+    uint32_t overflows; // fragments dropped by the radio chips
+    RxTimingStatistics_t rxTiming;
+    RetransmitStatistics_t retransmit[CommandLatencyClass_Max];
+    uint64_t hostMicros;
+    uint64_t iterations;
+    uint64_t allocations;
+    uint64_t libraryBytes;
+    double totalMs; // host time including the formatting of the deferred log
+    FleetGroupResult_t groups[FleetGroup_Max];
+    FleetLimitResult_t limits;
+    FleetLogResult_t log;
+    ChannelQualityTable channels; // NRF transmissions and answers per channel
+};
+
+/*
+ * Polls a SimFleet in virtual time. Besides the SimFleet options:
+ *   --mix, --duration (s), --tick (µs), --verbose
+ *   --cloudy, --offline, --far    percent of the fleet in these groups,
+ *                                 assigned in blocks of whole mix cycles
+ *   --cloud (s), --far-latency (µs), --far-jitter (µs)
+ *   --jam <channels>, --jam-loss  disturbed NRF channels
+ *   --limits <n>, --sources <n>   limits per minute and source to random
+ *                                 inverters, drained for 60 s afterwards
+ *   --baud, --uart-fifo           log to a modelled serial port
+ */
+FleetResult_t runFleet(const BenchmarkArgs& args, const uint32_t count);
+
+enum CmtDistance_t {
+    DISTANCE_NEAR,
+    DISTANCE_MEDIUM,
+    DISTANCE_FAR,
+    CmtDistance_Max,
+};
+
+struct CmtResult_t {
+    uint32_t polls;
+    uint32_t failures;
+    CmtHost::Statistics_t spi;
+    CmtRetuneStatistics_t retune;
+    float level[CmtDistance_Max]; // average transmit power at the end (dBm)
+};
+
+/*
+ * Runs HoymilesRadio_CMT against CmtHost with HMS inverters at three
+ * distances and sends a channel change request at half time. Options:
+ *   --inverters, --duration (s), --pa (dBm), --tx-power static|adaptive,
+ *   --tick (µs), --loss, --seed, --verbose
+ */
+CmtResult_t runCmtFleet(const BenchmarkArgs& args);
+
+struct TaskResult_t {
+    uint32_t succeeded;
+    uint32_t failed;
+    float rxElapsed; // average ms between transmission and evaluation
+    float rxTimeout; // average configured timeout in ms
+    uint32_t overflows;
+    uint32_t wakeups;
+    uint32_t reads;
+    uint32_t inconsistent;
+};
+
+/*
+ * Runs a SimFleet in real time next to a consumer which blocks the main loop
+ * and reads the statistics snapshots meanwhile. Options:
+ *   --radio-task off|on, --inverters, --mix, --duration (ms), --busy (ms),
+ *   --period (ms), --fifo
+ */
+TaskResult_t runRadioTask(const BenchmarkArgs& args);
+
+// Publishes checksummed values from a writer thread, returns the number of torn reads
+uint32_t runSnapshotStress(const uint32_t durationMs, uint32_t& reads);
+
+enum StatisticsReaders_t {
+    READERS_NONE,
+    READERS_LOCKED,
+    READERS_LOCK_FREE,
+};
+
+struct StatisticsResult_t {
+    uint64_t frames;
+    uint64_t reads; // getValues
+    uint64_t fieldReads; // getChannelFieldValue
+    uint64_t inconsistent;
+    double p99Us; // frame decode of the radio thread
+    double maxUs;
+};
+
+// Decodes frames of the model while the readers read all values at once
+StatisticsResult_t runStatisticsReaders(const InverterAbstract& inv, const StatisticsReaders_t mode, const uint32_t readers, const uint32_t durationMs);
+
+struct HandoffResult_t {
+    double seconds;
+    uint64_t written;
+    uint64_t received;
+    uint64_t dropped; // messages
+    uint32_t full; // writes rejected or retried because the buffer was full
+    uint32_t highWaterMark;
+    double p99Ns; // write latency
+    double maxNs;
+    uint32_t errors; // messages lost, duplicated or out of order
+};
+
+// Fragments from one producer to one consumer through SpscRingBuffer or a locked std::queue
+HandoffResult_t runSpsc(const uint32_t fragments, const bool locked);
+// Messages from several producers to a consumer through MpscRingBuffer or a locked buffer, baud 0 is a fast consumer
+HandoffResult_t runMpsc(const uint32_t producers, const uint32_t writes, const uint32_t burst, const uint32_t baud, const uint32_t seed, const bool locked);
+
+// Realtime values of an inverter after a recording or a replay
+struct ReplayValues_t {
+    float power;
+    float yieldTotal;
+};
+
+struct RecordResult_t {
+    std::vector<uint8_t> capture; // same layout as /api/rfcapture/download
+    uint32_t completed;
+    uint32_t overwritten;
+    std::map<uint64_t, ReplayValues_t> values;
+};
+
+struct ReplayResult_t {
+    uint32_t tx;
+    uint32_t rx;
+    uint32_t crcErrors;
+    uint32_t unknown; // packets of inverters which are not in the header
+    uint32_t skipped; // commands without parser (control, channel change)
+    uint32_t complete;
+    uint32_t incomplete; // fragments still missing after the retransmits
+    uint32_t noAnswer;
+    uint32_t errors; // rejected by the parser
+    double hostUs;
+    std::map<uint64_t, ReplayValues_t> values;
+};
+
+/*
+ * Records the RF traffic of a SimFleet. Options:
+ *   --inverters, --mix, --duration (s), --size (kB), --verbose
+ */
+RecordResult_t recordCapture(const BenchmarkArgs& args);
+// Returns false if the capture is invalid, only the last of repeat runs is reported
+bool replayCapture(const std::vector<uint8_t>& capture, const uint32_t repeat, ReplayResult_t& result, Print* output);
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HostClock.h"
+#include "Scenario.h"
+#include "SimFleet.h"
+#include "VirtualInverter.h"
+#include <cstring>
+#include <memory>
+#include <random>
+
+// transmit power of the inverters and sensitivity of their receivers (dBm)
+#define CMT_TEST_INVERTER_POWER 10
+#define CMT_TEST_SENSITIVITY -95
+
+// rssi of the answers received by the DTU
+static const int8_t distanceRssi[] = { -55, -77, -88 };
+
+CmtResult_t runCmtFleet(const BenchmarkArgs& args)
+{
+    NullOutput nullOutput;
+    Print* output = args.has("--verbose") ? static_cast<Print*>(&Serial) : &nullOutput;
+
+    HostClock.setVirtual(true);
+    CmtHost::setConnected(true);
+    CmtHost::resetStatistics();
+
+    Hoymiles.init();
+    Hoymiles.setMessageOutput(output);
+    Hoymiles.initCMT(-1, -1, -1, -1, -1, -1);
+    Hoymiles.setPollInterval(0);
+
+    HoymilesRadio_CMT* radio = Hoymiles.getRadioCmt();
+    radio->setDtuSerial(SIM_DTU_SERIAL);
+    radio->setCountryMode(CountryModeId_t::MODE_EU);
+    radio->setInverterTargetFrequency(HOYMILES_CMT_WORK_FREQ);
+    radio->setPALevel(args.getUint("--pa", 10));
+    radio->setPALevelAdaptive(strcmp(args.getString("--tx-power", "adaptive"), "static") != 0);
+
+    VirtualInverterConfig config;
+    config.lossRate = args.getFloat("--loss", 0.02f);
+
+    const uint32_t count = args.getUint("--inverters", 9);
+    std::vector<std::unique_ptr<VirtualInverter>> virtuals;
+    std::vector<CmtDistance_t> distances;
+    for (uint32_t i = 0; i < count; i++) {
+        char name[24];
+        snprintf(name, sizeof(name), "Cmt %u", i);
+        auto inv = Hoymiles.addInverter(name, SimFleet::buildSerial("hms", i));
+        distances.push_back(static_cast<CmtDistance_t>(i % CmtDistance_Max));
+        config.rssi = distanceRssi[distances.back()];
+        virtuals.push_back(std::make_unique<VirtualInverter>(*inv, config));
+    }
+
+    std::mt19937 random(args.getUint("--seed", 1));
+    std::uniform_real_distribution<float> uniform(0, 1);
+
+    CmtHost::setResponder([&](const uint8_t buf[], const uint8_t len, const uint8_t /*channel*/, const int8_t paLevel) {
+        // Bytes 1-4 contain the lower 4 bytes of the target serial
+        const uint32_t target = (buf[1] << 24) | (buf[2] << 16) | (buf[3] << 8) | buf[4];
+        for (auto& virt : virtuals) {
+            if (static_cast<uint32_t>(virt->serial()) != target) {
+                continue;
+            }
+
+            const int8_t rssi = virt->getConfig().rssi;
+            const int pathLoss = CMT_TEST_INVERTER_POWER - rssi;
+            if (paLevel - pathLoss < CMT_TEST_SENSITIVITY || uniform(random) < virt->getConfig().lossRate) {
+                return;
+            }
+
+            fragment_t response[VIRTUAL_MAX_RESPONSE_FRAGMENTS];
+            const uint8_t fragments = virt->handleRequest(buf, len, response);
+            for (uint8_t i = 0; i < fragments; i++) {
+                if (uniform(random) >= virt->getConfig().lossRate) {
+                    CmtHost::injectPacket(response[i].fragment, response[i].len, rssi + static_cast<int8_t>(uniform(random) * 6) - 3);
+                }
+            }
+        }
+    });
+
+    CmtResult_t result = {};
+    std::vector<uint32_t> lastUpdate(count, 0);
+    std::vector<uint32_t> lastFailures(count, 0);
+
+    const uint64_t tick = args.getUint("--tick", 250);
+    const uint64_t start = HostClock.getMicros();
+    const uint64_t end = start + static_cast<uint64_t>(args.getUint("--duration", 300)) * 1000000;
+    bool channelChangeSent = false;
+    uint32_t lastCheck = millis();
+
+    while (HostClock.getMicros() < end) {
+        Hoymiles.loop();
+        HostClock.advanceMicros(tick);
+
+        if (!channelChangeSent && HostClock.getMicros() - start > (end - start) / 2) {
+            channelChangeSent = true;
+            for (uint32_t i = 0; i < count; i++) {
+                Hoymiles.getInverterByPos(i)->sendChangeChannelRequest();
+            }
+        }
+
+        if (millis() != lastCheck) {
+            lastCheck = millis();
+            for (uint32_t i = 0; i < count; i++) {
+                StatisticsParser* statistics = Hoymiles.getInverterByPos(i)->Statistics();
+                if (statistics->getLastUpdate() != lastUpdate[i]) {
+                    lastUpdate[i] = statistics->getLastUpdate();
+                    result.polls++;
+                }
+                // Reset to zero by every successful request
+                if (statistics->getRxFailureCount() > lastFailures[i]) {
+                    result.failures += statistics->getRxFailureCount() - lastFailures[i];
+                }
+                lastFailures[i] = statistics->getRxFailureCount();
+            }
+        }
+    }
+
+    uint32_t distanceCount[CmtDistance_Max] = {};
+    for (uint32_t i = 0; i < count; i++) {
+        result.level[distances[i]] += radio->getPALevel(*Hoymiles.getInverterByPos(i));
+        distanceCount[distances[i]]++;
+    }
+    for (uint8_t d = 0; d < CmtDistance_Max; d++) {
+        if (distanceCount[d] > 0) {
+            result.level[d] /= distanceCount[d];
+        }
+    }
+
+    result.spi = CmtHost::getStatistics();
+    result.retune = radio->getRetuneStatistics();
+
+    CmtHost::setResponder(nullptr);
+    while (Hoymiles.getNumInverters() > 0) {
+        Hoymiles.removeInverterBySerial(Hoymiles.getInverterByPos(0)->serial());
+    }
+    CmtHost::setConnected(false);
+    radio->setPALevelAdaptive(HOYMILES_CMT_PA_ADAPTIVE);
+    Hoymiles.setMessageOutput(&Serial);
+    return result;
+}
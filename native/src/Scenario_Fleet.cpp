@@ -0,0 +1,336 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HostAlloc.h"
+#include "HostClock.h"
+#include "Scenario.h"
+#include "SimFleet.h"
+#include <HoymilesLog.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+
+// Timeout of RealTimeRunDataCommand if the timeouts are not learned (ms)
+#define FLEET_REALTIME_TIMEOUT 500
+
+// Serial port which sends one byte every 10 bit times and blocks the writer while its FIFO is full
+class UartOutput : public Print {
+public:
+    UartOutput(const uint32_t baud, const uint32_t fifo)
+        : _byteNs(10000000000ULL / baud)
+        , _fifo(fifo)
+    {
+    }
+
+    size_t write(uint8_t /*c*/) override
+    {
+        const uint64_t now = HostClock.getMicros() * 1000;
+        _busyUntil = std::max(_busyUntil, now) + _byteNs;
+        // Wait until the oldest byte has been sent
+        if (_busyUntil - now > _fifo * _byteNs) {
+            const uint64_t waitUs = (_busyUntil - now - _fifo * _byteNs + 999) / 1000;
+            HostClock.advanceMicros(waitUs);
+            _blockedUs += waitUs;
+        }
+        _bytes++;
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        for (size_t i = 0; i < size; i++) {
+            write(buffer[i]);
+        }
+        return size;
+    }
+
+    int availableForWrite() override
+    {
+        const uint64_t now = HostClock.getMicros() * 1000;
+        const uint64_t queued = _busyUntil > now ? (_busyUntil - now + _byteNs - 1) / _byteNs : 0;
+        return queued < _fifo ? _fifo - queued : 0;
+    }
+
+    uint64_t getBlockedUs() const { return _blockedUs; }
+    uint64_t getBytes() const { return _bytes; }
+
+private:
+    const uint64_t _byteNs;
+    const uint64_t _fifo;
+    uint64_t _busyUntil = 0;
+    uint64_t _blockedUs = 0;
+    uint64_t _bytes = 0;
+};
+
+struct PendingLimit_t {
+    VirtualInverter* inverter;
+    uint32_t count;
+    uint64_t sentMicros;
+};
+
+// Groups are assigned in blocks of whole mix cycles, so that every group has the same inverter types
+static FleetGroup_t getGroup(const BenchmarkArgs& args, const uint32_t index, const uint32_t count)
+{
+    static const char* const options[FleetGroup_Max] = { nullptr, "--cloudy", "--offline", "--far" };
+
+    const uint8_t mixSize = SimFleet::getMixSize(args.getString("--mix", "mixed"));
+    const uint32_t cycles = (count + mixSize - 1) / mixSize;
+    const uint32_t cycle = index / mixSize;
+
+    uint32_t first = 0;
+    for (uint8_t g = GROUP_CLOUDY; g < FleetGroup_Max; g++) {
+        first += (cycles * args.getUint(options[g], 0) + 50) / 100;
+        if (cycle < first) {
+            return static_cast<FleetGroup_t>(g);
+        }
+    }
+    return GROUP_STABLE;
+}
+
+static void addStatistics(CommandWaitStatistics_t& total, const CommandWaitStatistics_t& s)
+{
+    total.count += s.count;
+    total.totalWait += s.totalWait;
+    total.maxWait = std::max(total.maxWait, s.maxWait);
+    total.promoted += s.promoted;
+}
+
+FleetResult_t runFleet(const BenchmarkArgs& args, const uint32_t count)
+{
+    NullOutput nullOutput;
+    std::unique_ptr<UartOutput> uart;
+    Print* output = &nullOutput;
+    if (args.has("--baud")) {
+        uart = std::make_unique<UartOutput>(args.getUint("--baud", 115200), args.getUint("--uart-fifo", 128));
+        output = uart.get();
+    } else if (args.has("--verbose")) {
+        output = &Serial;
+    }
+
+    SimFleet fleet(args, output);
+    fleet.addInverters(count, args.getString("--mix", "mixed"));
+
+    FleetResult_t result = {};
+    result.inverters = Hoymiles.getNumInverters();
+    result.libraryBytes = fleet.getLibraryBytes();
+
+    VirtualInverterConfig base = fleet.getConfig();
+    for (const uint32_t channel : args.getUintList("--jam", {})) {
+        const uint8_t index = ChannelHopping::getChannelIndex(channel);
+        if (index < CHANNEL_QUALITY_CHANNELS) {
+            base.channelLossRate[index] = args.getFloat("--jam-loss", 0.9f);
+        }
+    }
+
+    std::vector<FleetGroup_t> groups(result.inverters);
+    std::vector<VirtualInverter*> virtuals(result.inverters);
+    for (uint32_t i = 0; i < result.inverters; i++) {
+        groups[i] = getGroup(args, i, result.inverters);
+        virtuals[i] = fleet.getVirtualInverter(Hoymiles.getInverterByPos(i)->serial());
+        result.groups[groups[i]].inverters++;
+
+        VirtualInverterConfig config = base;
+        if (groups[i] == GROUP_OFFLINE) {
+            config.lossRate = 1;
+        } else if (groups[i] == GROUP_FAR) {
+            config.latencyUs = args.getUint("--far-latency", 60000);
+            config.jitterUs = args.getUint("--far-jitter", 15000);
+        }
+        virtuals[i]->setConfig(config);
+    }
+
+    std::mt19937 rng(args.getUint("--seed", 1));
+    std::uniform_real_distribution<float> cloudPower(50, 600);
+
+    const uint64_t tick = args.getUint("--tick", 250);
+    const uint64_t start = HostClock.getMicros();
+    const uint64_t end = start + static_cast<uint64_t>(args.getUint("--duration", 300)) * 1000000;
+    const uint64_t cloudPeriod = static_cast<uint64_t>(std::max<uint32_t>(args.getUint("--cloud", 10), 1)) * 1000000;
+    uint64_t nextCloud = start + cloudPeriod;
+
+    // Sources are started with an offset to each other
+    const uint32_t sources = args.getUint("--limits", 0) > 0 ? args.getUint("--sources", 1) : 0;
+    const uint64_t limitPeriod = 60000000ULL / std::max<uint32_t>(args.getUint("--limits", 0), 1);
+    std::vector<uint64_t> nextLimit(sources);
+    for (uint32_t s = 0; s < sources; s++) {
+        nextLimit[s] = start + 2000000 + limitPeriod * s / sources;
+    }
+    std::map<uint64_t, float> lastLimit;
+    std::vector<PendingLimit_t> pending;
+
+    std::vector<uint32_t> lastUpdate(result.inverters, 0);
+    std::vector<uint32_t> lastFailures(result.inverters, 0);
+    std::vector<uint32_t> intervals;
+    uint32_t updated = 0;
+    uint32_t lastCheck = millis();
+    const uint32_t startMillis = millis();
+    const uint32_t droppedBefore = HoymilesLog.getStatistics().dropped;
+    double errorSum = 0;
+    uint32_t errorSamples = 0;
+    const uint64_t allocationStart = HostAlloc::getAllocationCount();
+    const auto hostStart = std::chrono::steady_clock::now();
+
+    while (HostClock.getMicros() < end) {
+        for (auto& next : nextLimit) {
+            if (HostClock.getMicros() < next) {
+                continue;
+            }
+            next += limitPeriod;
+
+            auto inv = Hoymiles.getInverterByPos(rng() % result.inverters);
+            VirtualInverter* vinv = fleet.getVirtualInverter(inv->serial());
+            const float limit = 10 + rng() % 91;
+            if (inv->sendActivePowerControlRequest(limit, PowerLimitControlType::RelativNonPersistent)) {
+                lastLimit[inv->serial()] = limit;
+                pending.push_back({ vinv, vinv->getLimitCommandCount(), HostClock.getMicros() });
+                result.limits.requested++;
+            }
+        }
+
+        if (HostClock.getMicros() >= nextCloud) {
+            nextCloud += cloudPeriod;
+            for (uint32_t i = 0; i < result.inverters; i++) {
+                if (groups[i] == GROUP_CLOUDY) {
+                    virtuals[i]->setPower(cloudPower(rng));
+                }
+            }
+        }
+
+        // Flushes the deferred log as far as the output takes it
+        result.hostMicros += fleet.tick(tick);
+        result.iterations++;
+
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (it->inverter->getLimitCommandCount() == it->count) {
+                ++it;
+                continue;
+            }
+            const uint64_t latency = HostClock.getMicros() - it->sentMicros;
+            result.limits.latencySum += latency;
+            result.limits.latencyMax = std::max(result.limits.latencyMax, latency);
+            result.limits.delivered++;
+            it = pending.erase(it);
+        }
+
+        // Statistics are updated with millisecond resolution
+        if (millis() == lastCheck) {
+            continue;
+        }
+        lastCheck = millis();
+
+        for (uint32_t i = 0; i < result.inverters; i++) {
+            auto inv = Hoymiles.getInverterByPos(i);
+            StatisticsParser* statistics = inv->Statistics();
+            FleetGroupResult_t& group = result.groups[groups[i]];
+
+            const uint32_t update = statistics->getLastUpdate();
+            if (update != lastUpdate[i]) {
+                if (lastUpdate[i] == 0) {
+                    if (++updated == result.inverters) {
+                        result.firstS = (update - startMillis) / 1000.0f;
+                    }
+                } else {
+                    intervals.push_back(update - lastUpdate[i]);
+                }
+                lastUpdate[i] = update;
+                group.polls++;
+            }
+
+            // Reset to zero by every successful request
+            if (statistics->getRxFailureCount() > lastFailures[i]) {
+                group.failures += statistics->getRxFailureCount() - lastFailures[i];
+            }
+            lastFailures[i] = statistics->getRxFailureCount();
+
+            if (groups[i] == GROUP_CLOUDY && update > 0) {
+                errorSum += std::fabs(virtuals[i]->getPower() - statistics->getChannelFieldValue(TYPE_AC, CH0, FLD_PAC));
+                errorSamples++;
+            }
+        }
+    }
+
+    result.totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hostStart).count();
+    result.allocations = HostAlloc::getAllocationCount() - allocationStart;
+
+    // Let the queue drain, limits which failed are resent during the poll cycle
+    if (sources > 0) {
+        const uint64_t drainEnd = HostClock.getMicros() + 60 * 1000000ULL;
+        while (HostClock.getMicros() < drainEnd) {
+            fleet.tick(tick);
+        }
+    }
+
+    for (uint32_t i = 0; i < result.inverters; i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+        FleetGroupResult_t& group = result.groups[groups[i]];
+
+        group.interval += inv->PollInterval()->getInterval() / 1000.0f;
+        group.timeout += Hoymiles.getRxTimeoutMax() > 0
+            ? inv->ResponseLatency()->getTimeout(LATENCY_REALTIME, Hoymiles.getRxTimeoutMin(), std::min<uint32_t>(FLEET_REALTIME_TIMEOUT, Hoymiles.getRxTimeoutMax()))
+            : FLEET_REALTIME_TIMEOUT;
+
+        result.limits.transmitted += virtuals[i]->getLimitCommandCount();
+        const auto it = lastLimit.find(inv->serial());
+        if (it != lastLimit.end() && virtuals[i]->getLimitPercent() != it->second) {
+            result.limits.mismatches++;
+        }
+    }
+
+    for (FleetGroupResult_t& group : result.groups) {
+        result.polls += group.polls;
+        result.failures += group.failures;
+        if (group.inverters > 0) {
+            group.interval /= group.inverters;
+            group.timeout /= group.inverters;
+        }
+    }
+    result.groups[GROUP_CLOUDY].powerError = errorSamples > 0 ? errorSum / errorSamples : 0;
+
+    result.missing = result.inverters - updated;
+    if (!intervals.empty()) {
+        std::sort(intervals.begin(), intervals.end());
+        uint64_t sum = 0;
+        for (const uint32_t interval : intervals) {
+            sum += interval;
+        }
+        result.meanS = sum / 1000.0f / intervals.size();
+        result.p95S = intervals[intervals.size() * 95 / 100] / 1000.0f;
+        result.maxS = intervals.back() / 1000.0f;
+    }
+
+    result.fragments = fleet.getRxFragmentCount();
+    result.tx = fleet.getTxCount();
+    result.lost = fleet.getLostFragmentCount();
+    result.overflows = fleet.getFifoOverflowCount();
+    result.channels = fleet.radioNrf().getChannelHopping().getTotals();
+
+    for (HoymilesRadio* radio : { static_cast<HoymilesRadio*>(&fleet.radioNrf()), static_cast<HoymilesRadio*>(&fleet.radioCmt()) }) {
+        const RxTimingStatistics_t timing = radio->getRxTimingStatistics();
+        result.rxTiming.exchanges += timing.exchanges;
+        result.rxTiming.completedEarly += timing.completedEarly;
+        result.rxTiming.totalElapsed += timing.totalElapsed;
+        result.rxTiming.totalTimeout += timing.totalTimeout;
+
+        for (uint8_t c = 0; c < CommandLatencyClass_Max; c++) {
+            const RetransmitStatistics_t s = radio->getRetransmitStatistics(static_cast<CommandLatencyClass_t>(c));
+            result.retransmit[c].rounds += s.rounds;
+            result.retransmit[c].fragments += s.fragments;
+        }
+        for (uint8_t p = 0; p < CommandPriority_Max; p++) {
+            addStatistics(result.limits.wait[p], radio->getCommandWaitStatistics(static_cast<CommandPriority_t>(p)));
+        }
+
+        result.limits.coalesced += radio->getCommandCoalescedCount();
+        result.limits.exhausted += radio->getCommandPoolExhaustedCount();
+    }
+
+    result.log.dropped = HoymilesLog.getStatistics().dropped - droppedBefore;
+    if (uart != nullptr) {
+        result.log.blockedUs = uart->getBlockedUs();
+        result.log.bytes = uart->getBytes();
+    }
+    return result;
+}
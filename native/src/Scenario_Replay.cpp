@@ -0,0 +1,231 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "HostClock.h"
+#include "Scenario.h"
+#include "SimFleet.h"
+#include <RfCapture.h>
+#include <algorithm>
+#include <chrono>
+#include <commands/AlarmDataCommand.h>
+#include <commands/DevInfoAllCommand.h>
+#include <commands/DevInfoSimpleCommand.h>
+#include <commands/GridOnProFilePara.h>
+#include <commands/RealTimeRunDataCommand.h>
+#include <commands/SystemConfigParaCommand.h>
+#include <cstring>
+#include <crc.h>
+#include <memory>
+
+// Recreates the command from the transmitted packet, only requests with an answer to parse are supported
+static std::unique_ptr<CommandAbstract> createCommand(const uint64_t serial, const uint8_t data[], const uint8_t len)
+{
+    if (data[0] != 0x15 || len < 16) {
+        return nullptr;
+    }
+
+    const time_t time = (static_cast<uint32_t>(data[12]) << 24) | (data[13] << 16) | (data[14] << 8) | data[15];
+    switch (data[10]) {
+    case 0x00:
+        return std::unique_ptr<CommandAbstract>(new DevInfoSimpleCommand(serial, 0, time));
+    case 0x01:
+        return std::unique_ptr<CommandAbstract>(new DevInfoAllCommand(serial, 0, time));
+    case 0x02:
+        return std::unique_ptr<CommandAbstract>(new GridOnProFilePara(serial, 0, time));
+    case 0x05:
+        return std::unique_ptr<CommandAbstract>(new SystemConfigParaCommand(serial, 0, time));
+    case 0x0b:
+        return std::unique_ptr<CommandAbstract>(new RealTimeRunDataCommand(serial, 0, time));
+    case 0x11:
+        return std::unique_ptr<CommandAbstract>(new AlarmDataCommand(serial, 0, time));
+    default:
+        return nullptr;
+    }
+}
+
+static void evaluate(InverterAbstract& inv, CommandAbstract& cmd, ReplayResult_t& result)
+{
+    const uint8_t verifyResult = inv.verifyAllFragments(cmd);
+    if (verifyResult == FRAGMENT_ALL_MISSING_RESEND || verifyResult == FRAGMENT_ALL_MISSING_TIMEOUT) {
+        result.noAnswer++;
+    } else if (verifyResult == FRAGMENT_HANDLE_ERROR) {
+        result.errors++;
+    } else if (verifyResult > 0) {
+        result.incomplete++;
+    } else {
+        result.complete++;
+    }
+}
+
+static ReplayValues_t getValues(InverterAbstract& inv)
+{
+    return { inv.Statistics()->getChannelFieldValue(TYPE_AC, CH0, FLD_PAC),
+        inv.Statistics()->getChannelFieldValue(TYPE_AC, CH0, FLD_YT) };
+}
+
+bool replayCapture(const std::vector<uint8_t>& capture, const uint32_t repeat, ReplayResult_t& result, Print* output)
+{
+    RfCaptureHeader_t header;
+    if (capture.size() < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, capture.data(), sizeof(header));
+    const size_t recordsStart = sizeof(header) + header.inverterCount * sizeof(uint64_t);
+    if (memcmp(header.magic, RF_CAPTURE_MAGIC, sizeof(header.magic)) != 0
+        || header.version != RF_CAPTURE_VERSION || capture.size() < recordsStart) {
+        return false;
+    }
+
+    HostClock.setVirtual(true);
+    Hoymiles.init();
+    Hoymiles.setMessageOutput(output);
+
+    for (uint8_t i = 0; i < header.inverterCount; i++) {
+        uint64_t serial;
+        memcpy(&serial, &capture[sizeof(header) + i * sizeof(uint64_t)], sizeof(serial));
+        char name[24];
+        snprintf(name, sizeof(name), "Replay %u", i);
+        Hoymiles.addInverter(name, serial);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t r = 0; r < std::max<uint32_t>(repeat, 1); r++) {
+        // Only the last run is reported, the others are used for the timing
+        result = {};
+        std::map<InverterAbstract*, std::unique_ptr<CommandAbstract>> pending;
+        // A capture may interleave the answers of several radios, every inverter gets its own buffer
+        std::map<InverterAbstract*, ReassemblyBuffer_t> buffers;
+        uint32_t lastMicros = 0;
+
+        size_t pos = recordsStart;
+        while (pos + sizeof(RfCaptureRecord_t) <= capture.size()) {
+            RfCaptureRecord_t record;
+            memcpy(&record, &capture[pos], sizeof(record));
+            pos += sizeof(record);
+            if (pos + record.len > capture.size() || record.len > MAX_RF_PAYLOAD_SIZE) {
+                break; // truncated download
+            }
+
+            fragment_t fragment = {};
+            memcpy(fragment.fragment, &capture[pos], record.len);
+            fragment.len = record.len;
+            fragment.channel = record.channel;
+            fragment.rssi = record.rssi;
+            pos += record.len;
+
+            // Keep the time base of the parsers (e.g. getLastUpdate)
+            if (lastMicros != 0) {
+                HostClock.advanceMicros(record.micros - lastMicros);
+            }
+            lastMicros = record.micros;
+
+            // The inverter address is at the same position in requests and answers
+            InverterAbstract* inv = fragment.len >= 10 ? Hoymiles.findInverterByFragment(fragment) : nullptr;
+
+            if (record.flags & RF_CAPTURE_FLAG_TX) {
+                result.tx++;
+                if (inv == nullptr) {
+                    result.unknown++;
+                    continue;
+                }
+                if (fragment.fragment[0] == 0x15 && fragment.len == 11) {
+                    // RequestFrameCommand (10 bytes plus crc), the answer completes the pending command
+                    continue;
+                }
+
+                auto& cmd = pending[inv];
+                if (cmd != nullptr) {
+                    evaluate(*inv, *cmd, result);
+                }
+                cmd = createCommand(inv->serial(), fragment.fragment, fragment.len);
+                if (cmd == nullptr) {
+                    result.skipped++;
+                }
+                inv->setRxFragmentBuffer(&buffers[inv]);
+            } else {
+                result.rx++;
+                if (fragment.len == 0 || crc8(fragment.fragment, fragment.len - 1) != fragment.fragment[fragment.len - 1]) {
+                    result.crcErrors++;
+                } else if (inv == nullptr) {
+                    result.unknown++;
+                } else {
+                    inv->addRxFragment(fragment.fragment, fragment.len);
+                }
+            }
+        }
+
+        for (auto& p : pending) {
+            if (p.second != nullptr) {
+                evaluate(*p.first, *p.second, result);
+            }
+        }
+        for (auto& p : buffers) {
+            p.first->setRxFragmentBuffer(nullptr);
+        }
+    }
+
+    result.hostUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / std::max<uint32_t>(repeat, 1);
+
+    while (Hoymiles.getNumInverters() > 0) {
+        auto inv = Hoymiles.getInverterByPos(0);
+        result.values[inv->serial()] = getValues(*inv);
+        Hoymiles.removeInverterBySerial(inv->serial());
+    }
+    Hoymiles.setMessageOutput(&Serial);
+    return true;
+}
+
+RecordResult_t recordCapture(const BenchmarkArgs& args)
+{
+    NullOutput nullOutput;
+    Print* output = args.has("--verbose") ? static_cast<Print*>(&Serial) : &nullOutput;
+
+    SimFleet fleet(args, output);
+    fleet.addInverters(args.getUint("--inverters", 10), args.getString("--mix", "mixed"));
+
+    RfCapture& capture = Hoymiles.getRfCapture();
+    capture.begin(args.getUint("--size", 4096) * 1024);
+
+    const uint64_t end = HostClock.getMicros() + static_cast<uint64_t>(args.getUint("--duration", 120)) * 1000000;
+    while (HostClock.getMicros() < end) {
+        fleet.tick(250);
+    }
+
+    // Let the commands in flight finish, the replay evaluates them as well
+    Hoymiles.setPollInterval(3600);
+    while (!fleet.radioNrf().isIdle() || !fleet.radioNrf().isQueueEmpty()
+        || !fleet.radioCmt().isIdle() || !fleet.radioCmt().isQueueEmpty()) {
+        fleet.tick(250);
+    }
+
+    RecordResult_t result = {};
+    for (HoymilesRadio* radio : { static_cast<HoymilesRadio*>(&fleet.radioNrf()), static_cast<HoymilesRadio*>(&fleet.radioCmt()) }) {
+        result.completed += radio->getStatisticsSnapshot().commands.succeeded;
+    }
+
+    // Same layout as the download of the web API
+    std::vector<uint64_t> serials;
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+        serials.push_back(inv->serial());
+        result.values[inv->serial()] = getValues(*inv);
+    }
+
+    result.capture.resize(sizeof(RfCaptureHeader_t) + serials.size() * sizeof(uint64_t));
+    RfCapture::writeHeader(result.capture.data(), result.capture.size(), serials.data(), serials.size());
+
+    uint32_t position = capture.getStartPosition();
+    const uint32_t captureEnd = capture.getEndPosition();
+    uint8_t chunk[1024];
+    size_t len;
+    while ((len = capture.read(position, captureEnd, chunk, sizeof(chunk))) > 0) {
+        result.capture.insert(result.capture.end(), chunk, chunk + len);
+    }
+
+    result.overwritten = capture.getStatistics().overwritten;
+    capture.end();
+    Hoymiles.setPollInterval(0);
+    return result;
+}
@@ -0,0 +1,573 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "Scenario.h"
+#include "SimFleet.h"
+#include <MpscRingBuffer.h>
+#include <SnapshotBuffer.h>
+#include <SpscRingBuffer.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+
+#define STATISTICS_POWER_A 400
+#define STATISTICS_POWER_B 500
+
+#define MPSC_SLOT_SIZE 32
+#define MPSC_SLOT_COUNT 128
+#define MPSC_MAX_PAYLOAD 58
+
+static volatile float sink;
+
+// A snapshot has to be consistent in itself and must not go back in time
+static bool isConsistent(const RadioStatistics_t& s, const RadioStatistics_t& last)
+{
+    return s.rxTiming.completedEarly <= s.rxTiming.exchanges
+        && s.commands.succeeded + s.commands.failed <= s.rxTiming.exchanges
+        && s.rxTiming.exchanges >= last.rxTiming.exchanges
+        && s.commands.succeeded >= last.commands.succeeded
+        && s.commands.failed >= last.commands.failed;
+}
+
+TaskResult_t runRadioTask(const BenchmarkArgs& args)
+{
+    NullOutput nullOutput;
+    Print* output = args.has("--verbose") ? static_cast<Print*>(&Serial) : &nullOutput;
+    const bool task = strcmp(args.getString("--radio-task", "on"), "off") != 0;
+
+    // Radio chips hold only a few packets until the loop reads them
+    SimFleet fleet(args.has("--fifo") ? args : args.with("--fifo 3"), output, false);
+    fleet.addInverters(args.getUint("--inverters", 10), args.getString("--mix", "mixed"));
+    HoymilesRadio* radios[] = { &fleet.radioNrf(), &fleet.radioCmt() };
+
+    TaskResult_t result = {};
+    RadioStatistics_t last[2] = {};
+
+    const auto now = [] { return std::chrono::steady_clock::now(); };
+    const auto busy = std::chrono::milliseconds(args.getUint("--busy", 40));
+    const auto period = std::chrono::milliseconds(args.getUint("--period", 100));
+    const auto end = now() + std::chrono::milliseconds(args.getUint("--duration", 3000));
+    auto nextBusy = now() + period;
+
+    if (task) {
+        Hoymiles.startRadioTask(tskNO_AFFINITY);
+    }
+
+    while (now() < end) {
+        if (task) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } else {
+            // Also runs the loops of the simulated radios
+            Hoymiles.loop();
+        }
+
+        if (now() >= nextBusy) {
+            const auto busyEnd = now() + busy;
+            while (now() < busyEnd) {
+                for (uint8_t r = 0; r < 2; r++) {
+                    const RadioStatistics_t s = radios[r]->getStatisticsSnapshot();
+                    result.reads++;
+                    if (!isConsistent(s, last[r])) {
+                        result.inconsistent++;
+                    }
+                    last[r] = s;
+                }
+            }
+            nextBusy = now() + period;
+        }
+    }
+
+    if (task) {
+        Hoymiles.stopRadioTask();
+        result.wakeups = Hoymiles.getRadioTaskStatistics().wakeups;
+    }
+
+    result.overflows = fleet.getFifoOverflowCount();
+
+    uint32_t exchanges = 0;
+    for (HoymilesRadio* radio : radios) {
+        const RadioStatistics_t s = radio->getStatisticsSnapshot();
+        result.succeeded += s.commands.succeeded;
+        result.failed += s.commands.failed;
+        exchanges += s.rxTiming.exchanges;
+        result.rxElapsed += s.rxTiming.totalElapsed;
+        result.rxTimeout += s.rxTiming.totalTimeout;
+    }
+    if (exchanges > 0) {
+        result.rxElapsed /= exchanges;
+        result.rxTimeout /= exchanges;
+    }
+    return result;
+}
+
+struct StressValue_t {
+    uint32_t sequence;
+    uint32_t words[13];
+    uint32_t check;
+};
+
+uint32_t runSnapshotStress(const uint32_t durationMs, uint32_t& reads)
+{
+    SnapshotBuffer<StressValue_t> buffer;
+    std::atomic<bool> stop { false };
+
+    std::thread writer([&buffer, &stop] {
+        StressValue_t value = {};
+        while (!stop) {
+            value.sequence++;
+            value.check = value.sequence;
+            for (uint32_t& word : value.words) {
+                word = value.sequence * 2654435761u;
+                value.check ^= word;
+            }
+            buffer.publish(value);
+        }
+    });
+
+    uint32_t torn = 0;
+    uint32_t lastSequence = 0;
+    reads = 0;
+    const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(durationMs);
+    while (std::chrono::steady_clock::now() < end) {
+        StressValue_t value;
+        reads++;
+        buffer.read(value);
+
+        uint32_t check = value.sequence;
+        for (const uint32_t word : value.words) {
+            check ^= word;
+        }
+        if (check != value.check || value.sequence < lastSequence) {
+            torn++;
+        }
+        lastSequence = value.sequence;
+    }
+
+    stop = true;
+    writer.join();
+    return torn;
+}
+
+// Gives the readers access to the parser semaphore for the locked baseline
+class LockedStatisticsParser : public StatisticsParser {
+public:
+    void getValuesLocked(StatisticsValues_t& values)
+    {
+        HOY_SEMAPHORE_TAKE();
+        getValues(values);
+        HOY_SEMAPHORE_GIVE();
+    }
+};
+
+// Every raw field of a frame carries the same counter
+static void encodeFrame(const InverterAbstract& inv, const uint16_t counter, uint8_t payload[])
+{
+    const byteAssign_t* assignment = inv.getByteAssignment();
+    for (uint8_t i = 0; i < inv.getByteAssignmentSize(); i++) {
+        if (assignment[i].div == CMD_CALC) {
+            continue;
+        }
+        uint32_t val = counter;
+        for (int8_t b = assignment[i].num - 1; b >= 0; b--) {
+            payload[assignment[i].start + b] = val & 0xff;
+            val >>= 8;
+        }
+    }
+}
+
+// All raw fields and the calculated total DC power and irradiation have to belong to the same frame
+static bool isConsistent(const InverterAbstract& inv, const StatisticsParser& parser, const ChannelList& dcChannels, const StatisticsValues_t& values)
+{
+    const byteAssign_t* assignment = inv.getByteAssignment();
+
+    int64_t counter = -1;
+    for (uint8_t i = 0; i < inv.getByteAssignmentSize(); i++) {
+        if (assignment[i].div == CMD_CALC) {
+            continue;
+        }
+        const int64_t val = std::lround(values.values[i] * assignment[i].div);
+        if (counter >= 0 && val != counter) {
+            return false;
+        }
+        counter = val;
+    }
+
+    for (uint8_t i = 0; i < inv.getByteAssignmentSize(); i++) {
+        const byteAssign_t& a = assignment[i];
+        if (a.div != CMD_CALC) {
+            continue;
+        }
+        if (a.start == CALC_TOTAL_PDC) {
+            float dcPower = 0;
+            for (auto& c : dcChannels) {
+                dcPower += parser.getChannelFieldValue(values, TYPE_DC, c, FLD_PDC);
+            }
+            if (values.values[i] != dcPower) {
+                return false;
+            }
+        } else if (a.start == CALC_CH_IRR) {
+            const float pdc = parser.getChannelFieldValue(values, TYPE_DC, static_cast<ChannelNum_t>(a.num), FLD_PDC);
+            if (values.values[i] != pdc / STATISTICS_POWER_A * 100.0f && values.values[i] != pdc / STATISTICS_POWER_B * 100.0f) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+StatisticsResult_t runStatisticsReaders(const InverterAbstract& inv, const StatisticsReaders_t mode, const uint32_t readers, const uint32_t durationMs)
+{
+    LockedStatisticsParser parser;
+    parser.setByteAssignment(inv.getByteAssignment(), inv.getByteAssignmentSize(), inv.getByteAssignmentIndex());
+    const ChannelList dcChannels = parser.getChannelsByType(TYPE_DC);
+    for (auto& c : dcChannels) {
+        parser.setStringMaxPower(c, STATISTICS_POWER_A);
+    }
+
+    std::atomic<bool> stop { false };
+    StatisticsResult_t result = {};
+    std::vector<uint32_t> latencies;
+
+    // Decodes frames as fast as possible
+    std::thread radio([&] {
+        uint8_t payload[STATISTIC_PACKET_SIZE] = {};
+        uint16_t counter = 0;
+        while (!stop) {
+            counter = counter % 30000 + 1;
+            encodeFrame(inv, counter, payload);
+
+            const auto begin = std::chrono::steady_clock::now();
+            parser.beginAppendFragment();
+            parser.clearBuffer();
+            parser.appendFragment(0, payload, parser.getExpectedByteCount());
+            parser.endAppendFragment();
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+        }
+    });
+
+    // Changes the string powers like a configuration change from the web interface
+    std::thread settings([&] {
+        bool toggle = true;
+        while (!stop) {
+            toggle = !toggle;
+            for (auto& c : dcChannels) {
+                parser.setStringMaxPower(c, toggle ? STATISTICS_POWER_A : STATISTICS_POWER_B);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::vector<StatisticsResult_t> readerResults(mode != READERS_NONE ? readers : 0);
+    std::vector<std::thread> threads;
+    for (uint32_t r = 0; r < readerResults.size(); r++) {
+        threads.emplace_back([&, r] {
+            StatisticsResult_t& rr = readerResults[r];
+            uint32_t lastGeneration = 0;
+            float sum = 0;
+            while (!stop) {
+                StatisticsValues_t values;
+                rr.reads++;
+                if (mode == READERS_LOCKED) {
+                    parser.getValuesLocked(values);
+                } else {
+                    parser.getValues(values);
+                }
+                if (values.generation > 0 && (values.generation < lastGeneration || !isConsistent(inv, parser, dcChannels, values))) {
+                    rr.inconsistent++;
+                }
+                lastGeneration = values.generation;
+
+                for (auto& c : dcChannels) {
+                    sum += parser.getChannelFieldValue(TYPE_DC, c, FLD_PDC);
+                    rr.fieldReads++;
+                }
+            }
+            sink = sum;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(durationMs));
+    stop = true;
+    radio.join();
+    settings.join();
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    for (const StatisticsResult_t& rr : readerResults) {
+        result.reads += rr.reads;
+        result.fieldReads += rr.fieldReads;
+        result.inconsistent += rr.inconsistent;
+    }
+
+    result.frames = latencies.size();
+    std::sort(latencies.begin(), latencies.end());
+    result.p99Us = latencies.empty() ? 0 : latencies[latencies.size() * 99 / 100] / 1000.0;
+    result.maxUs = latencies.empty() ? 0 : latencies.back() / 1000.0;
+    return result;
+}
+
+static void fillFragment(fragment_t& f, const uint32_t seq)
+{
+    memset(f.fragment, 0xcc, MAX_RF_PAYLOAD_SIZE);
+    memcpy(f.fragment, &seq, sizeof(seq));
+    f.len = 27;
+}
+
+static uint32_t fragmentSeq(const fragment_t& f)
+{
+    uint32_t seq;
+    memcpy(&seq, f.fragment, sizeof(seq));
+    return seq;
+}
+
+static HandoffResult_t runSpscRing(const uint32_t count)
+{
+    static SpscRingBuffer<fragment_t, 32> ring;
+    HandoffResult_t result = {};
+    const uint32_t overflowStart = ring.getOverflowCount();
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (uint32_t seq = 0; seq < count;) {
+            fragment_t* f = ring.prepare();
+            if (f == nullptr) {
+                std::this_thread::yield();
+                continue;
+            }
+            fillFragment(*f, seq++);
+            ring.commit();
+        }
+    });
+
+    for (uint32_t expected = 0; expected < count;) {
+        const fragment_t* f = ring.front();
+        if (f == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (fragmentSeq(*f) != expected++) {
+            result.errors++;
+        }
+        ring.pop();
+        result.received++;
+    }
+    producer.join();
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.full = ring.getOverflowCount() - overflowStart;
+    result.highWaterMark = ring.getHighWaterMark();
+    result.errors += ring.empty() ? 0 : 1;
+    return result;
+}
+
+// Previously used for the radio receive path
+static HandoffResult_t runLockedQueue(const uint32_t count)
+{
+    std::queue<fragment_t> queue;
+    std::mutex mutex;
+    HandoffResult_t result = {};
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (uint32_t seq = 0; seq < count;) {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (queue.size() >= 32) {
+                result.full++;
+                lock.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+            fragment_t f;
+            fillFragment(f, seq++);
+            queue.push(f);
+            if (queue.size() > result.highWaterMark) {
+                result.highWaterMark = queue.size();
+            }
+        }
+    });
+
+    for (uint32_t expected = 0; expected < count;) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (queue.empty()) {
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+        if (fragmentSeq(queue.front()) != expected++) {
+            result.errors++;
+        }
+        queue.pop();
+        result.received++;
+    }
+    producer.join();
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+HandoffResult_t runSpsc(const uint32_t fragments, const bool locked)
+{
+    HandoffResult_t result = locked ? runLockedQueue(fragments) : runSpscRing(fragments);
+    result.written = fragments;
+    return result;
+}
+
+// Previous MessageOutput buffer: one buffer shared under a mutex
+class LockedBuffer {
+public:
+    bool write(const uint8_t data[], const size_t len)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_len + len > sizeof(_buffer)) {
+            return false;
+        }
+        memcpy(&_buffer[_len], data, len);
+        _len += len;
+        return true;
+    }
+
+    size_t read(uint8_t buffer[], const size_t maxLen)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const size_t len = std::min(_len, maxLen);
+        memcpy(buffer, _buffer, len);
+        memmove(_buffer, &_buffer[len], _len - len);
+        _len -= len;
+        return len;
+    }
+
+private:
+    std::mutex _mutex;
+    uint8_t _buffer[MPSC_SLOT_SIZE * MPSC_SLOT_COUNT];
+    size_t _len = 0;
+};
+
+// Message: producer, sequence number, payload length, payload
+static size_t buildMessage(uint8_t message[], const uint8_t producer, const uint32_t sequence, const uint8_t len)
+{
+    message[0] = producer;
+    memcpy(&message[1], &sequence, sizeof(sequence));
+    message[5] = len;
+    for (uint8_t i = 0; i < len; i++) {
+        message[6 + i] = (sequence + i) & 0xff;
+    }
+    return 6 + len;
+}
+
+template <typename Buffer>
+static HandoffResult_t runMessages(const uint32_t producers, const uint32_t writes, const uint32_t burst, const uint32_t baud, const uint32_t seed)
+{
+    Buffer buffer;
+    std::atomic<uint32_t> running { producers };
+    std::vector<uint64_t> dropped(producers, 0);
+    std::vector<std::vector<uint32_t>> latencies(producers);
+    HandoffResult_t result = {};
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            std::mt19937 rng(seed + p);
+            std::uniform_int_distribution<uint32_t> length(0, MPSC_MAX_PAYLOAD);
+            uint8_t message[6 + MPSC_MAX_PAYLOAD];
+            latencies[p].reserve(writes);
+            for (uint32_t s = 0; s < writes; s++) {
+                const size_t len = buildMessage(message, p, s, length(rng));
+                const auto begin = std::chrono::steady_clock::now();
+                const bool ok = buffer.write(message, len);
+                latencies[p].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+                if (!ok) {
+                    dropped[p]++;
+                }
+                if (burst > 0 && s % burst == burst - 1) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            running--;
+        });
+    }
+
+    // Consumer: parses the byte stream, a message may be split between two reads
+    std::vector<int64_t> lastSequence(producers, -1);
+    std::vector<uint8_t> pending;
+    uint8_t chunk[256];
+    const double byteUs = baud > 0 ? 10e6 / baud : 0;
+
+    for (;;) {
+        const bool finished = running == 0;
+        const size_t len = buffer.read(chunk, sizeof(chunk));
+        if (len == 0) {
+            if (finished) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        if (byteUs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<uint64_t>(len * byteUs)));
+        }
+
+        pending.insert(pending.end(), chunk, chunk + len);
+        size_t pos = 0;
+        while (pending.size() - pos >= 6 && pending.size() - pos >= 6u + pending[pos + 5]) {
+            const uint8_t producer = pending[pos];
+            uint32_t sequence;
+            memcpy(&sequence, &pending[pos + 1], sizeof(sequence));
+            const uint8_t payloadLen = pending[pos + 5];
+
+            bool valid = producer < producers && static_cast<int64_t>(sequence) > lastSequence[producer];
+            for (uint8_t i = 0; valid && i < payloadLen; i++) {
+                valid = pending[pos + 6 + i] == ((sequence + i) & 0xff);
+            }
+            if (!valid) {
+                // The stream cannot be parsed any further
+                result.errors++;
+                pending.clear();
+                pos = 0;
+                break;
+            }
+            lastSequence[producer] = sequence;
+            result.received++;
+            pos += 6 + payloadLen;
+        }
+        pending.erase(pending.begin(), pending.begin() + pos);
+    }
+
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<uint32_t> all;
+    for (uint32_t p = 0; p < producers; p++) {
+        result.dropped += dropped[p];
+        all.insert(all.end(), latencies[p].begin(), latencies[p].end());
+    }
+    std::sort(all.begin(), all.end());
+    result.written = all.size();
+    result.full = result.dropped;
+    result.p99Ns = all.empty() ? 0 : all[all.size() * 99 / 100];
+    result.maxNs = all.empty() ? 0 : all.back();
+    // Every message is either received or counted as dropped
+    if (result.received + result.dropped != result.written || !pending.empty()) {
+        result.errors++;
+    }
+    return result;
+}
+
+HandoffResult_t runMpsc(const uint32_t producers, const uint32_t writes, const uint32_t burst, const uint32_t baud, const uint32_t seed, const bool locked)
+{
+    if (locked) {
+        return runMessages<LockedBuffer>(producers, writes, burst, baud, seed);
+    }
+    return runMessages<MpscRingBuffer<MPSC_SLOT_SIZE, MPSC_SLOT_COUNT>>(producers, writes, burst, baud, seed);
+}
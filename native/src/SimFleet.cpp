@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "SimFleet.h"
+#include "HostAlloc.h"
+#include "HostClock.h"
+#include <HoymilesLog.h>
+#include <chrono>
+#include <cstring>
+
+SimFleet::SimFleet(const BenchmarkArgs& args, Print* output, const bool virtualClock)
+{
+    HostClock.setVirtual(virtualClock);
+
+    const uint32_t seed = args.getUint("--seed", 1);
+    _simNrf.init(seed);
+    _simCmt.init(seed + 1);
+    _simNrf.setDtuSerial(SIM_DTU_SERIAL);
+    _simCmt.setDtuSerial(SIM_DTU_SERIAL);
+    _simNrf.setRxFifoDepth(args.getUint("--fifo", 0));
+    _simCmt.setRxFifoDepth(args.getUint("--fifo", 0));
+    _simNrf.getChannelHopping().setAdaptive(strcmp(args.getString("--hopping", "adaptive"), "round-robin") != 0);
+
+    Hoymiles.init();
+    Hoymiles.setMessageOutput(output);
+    // Host chip is never connected, it is only used for frequency calculations
+    Hoymiles.initCMT(-1, -1, -1, -1, -1, -1);
+    Hoymiles.setPollInterval(args.getUint("--interval", 0));
+
+    if (strcmp(args.getString("--adaptive-poll", "off"), "on") == 0) {
+        Hoymiles.setPollIntervalBounds(args.getUint("--poll-min", 0), args.getUint("--poll-max", 30));
+    }
+    // A maximum of 0 disables the learned timeouts
+    Hoymiles.setRxTimeoutBounds(args.getUint("--timeout-min", RESPONSE_TIMEOUT_MIN),
+        strcmp(args.getString("--learned-timeout", "on"), "off") != 0 ? args.getUint("--timeout-max", RESPONSE_TIMEOUT_MAX) : 0);
+
+    const char* log = args.getString("--log", "");
+    if (strcmp(log, "off") == 0) {
+        HoymilesLog.setLevel(HOY_LOG_NONE);
+    } else if (strcmp(log, "deferred") == 0 || strcmp(log, "eager") == 0) {
+        HoymilesLog.setDeferred(strcmp(log, "deferred") == 0);
+    }
+
+    _config.latencyUs = args.getUint("--latency", _config.latencyUs);
+    _config.fragmentSpacingUs = args.getUint("--spacing", _config.fragmentSpacingUs);
+    _config.jitterUs = args.getUint("--jitter", _config.jitterUs);
+    _config.lossRate = args.getFloat("--loss", 0.02f);
+}
+
+SimFleet::~SimFleet()
+{
+    while (Hoymiles.getNumInverters() > 0) {
+        Hoymiles.removeInverterBySerial(Hoymiles.getInverterByPos(0)->serial());
+    }
+
+    // The settings are global, do not leak them into the next fleet
+    Hoymiles.setMessageOutput(&Serial);
+    Hoymiles.setPollIntervalBounds(0, 0);
+    Hoymiles.setRxTimeoutBounds(RESPONSE_TIMEOUT_MIN, RESPONSE_TIMEOUT_MAX);
+    HoymilesLog.clear();
+    HoymilesLog.setLevel(HOY_LOG_VERBOSE);
+    HoymilesLog.setDeferred(HOY_LOG_DEFERRED);
+}
+
+uint8_t SimFleet::getMixSize(const char* mix)
+{
+    if (strcmp(mix, "mixed") == 0) {
+        return 3;
+    }
+
+    uint8_t size = 1;
+    for (const char* c = mix; *c != '\0'; c++) {
+        size += *c == '+' ? 1 : 0;
+    }
+    return size;
+}
+
+uint64_t SimFleet::buildSerial(const char* mix, const uint32_t index)
+{
+    if (strcmp(mix, "mixed") == 0) {
+        mix = "hm+hms+hmt";
+    }
+
+    // Type of this index in the + separated list
+    const char* type = mix;
+    for (uint32_t i = index % getMixSize(mix); i > 0; i--) {
+        type = strchr(type, '+') + 1;
+    }
+    const size_t len = strcspn(type, "+");
+
+    if (len == 3 && strncmp(type, "hms", len) == 0) {
+        return 0x114420000000 + index; // HMS-800-2T
+    } else if (len == 3 && strncmp(type, "hmt", len) == 0) {
+        return 0x138230000000 + index; // HMT-2250-6T
+    }
+    return 0x116110000000 + index; // HM-1500-4T
+}
+
+void SimFleet::addInverters(const uint32_t count, const char* mix)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        addInverter(buildSerial(mix, i));
+    }
+}
+
+std::shared_ptr<InverterAbstract> SimFleet::addInverter(const uint64_t serial)
+{
+    char name[24];
+    snprintf(name, sizeof(name), "Sim %u", static_cast<uint32_t>(Hoymiles.getNumInverters()));
+
+    const uint64_t before = HostAlloc::getLiveBytes();
+    auto inv = Hoymiles.addInverter(name, serial, &_simNrf, &_simCmt);
+    _libraryBytes += HostAlloc::getLiveBytes() - before;
+    if (inv == nullptr) {
+        return nullptr;
+    }
+
+    HoymilesRadio_Sim* radio = inv->getRadio() == &_simNrf ? &_simNrf : &_simCmt;
+    radio->addVirtualInverter(*inv, _config);
+    return inv;
+}
+
+VirtualInverter* SimFleet::getVirtualInverter(const uint64_t serial)
+{
+    VirtualInverter* inv = _simNrf.getVirtualInverter(serial);
+    return inv != nullptr ? inv : _simCmt.getVirtualInverter(serial);
+}
+
+const VirtualInverterConfig& SimFleet::getConfig() const
+{
+    return _config;
+}
+
+uint64_t SimFleet::tick(const uint64_t tickUs)
+{
+    const auto start = std::chrono::steady_clock::now();
+    // Also runs the loops of the simulated radios
+    Hoymiles.loop();
+    const uint64_t hostMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // Formatting the deferred log is not part of the loop
+    HoymilesLog.flush(*Hoymiles.getMessageOutput());
+
+    HostClock.advanceMicros(tickUs);
+    return hostMicros;
+}
+
+HoymilesRadio_Sim& SimFleet::radioNrf()
+{
+    return _simNrf;
+}
+
+HoymilesRadio_Sim& SimFleet::radioCmt()
+{
+    return _simCmt;
+}
+
+uint32_t SimFleet::getTxCount() const
+{
+    return _simNrf.getTxCount() + _simCmt.getTxCount();
+}
+
+uint32_t SimFleet::getRxFragmentCount() const
+{
+    return _simNrf.getRxFragmentCount() + _simCmt.getRxFragmentCount();
+}
+
+uint32_t SimFleet::getLostFragmentCount() const
+{
+    return _simNrf.getLostFragmentCount() + _simCmt.getLostFragmentCount();
+}
+
+uint32_t SimFleet::getFifoOverflowCount() const
+{
+    return _simNrf.getFifoOverflowCount() + _simCmt.getFifoOverflowCount();
+}
+
+uint64_t SimFleet::getLibraryBytes() const
+{
+    return _libraryBytes;
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include "Benchmark.h"
+#include "HoymilesRadio_Sim.h"
+#include <Hoymiles.h>
+#include <cstdint>
+
+#define SIM_DTU_SERIAL 0x199980122304
+
+/*
+ * Sets up HoymilesClass with two simulated radios (one for HM and one for
+ * HMS/HMT inverters) and a fleet of virtual inverters. Common options:
+ *   --latency, --spacing, --jitter, --loss, --seed, --interval, --fifo
+ * and the library features, all off or on like in the firmware by default:
+ *   --adaptive-poll off|on   with --poll-min and --poll-max (s)
+ *   --learned-timeout off|on with --timeout-min and --timeout-max (ms)
+ *   --hopping round-robin|adaptive
+ *   --log off|deferred|eager
+ * All inverters are removed and the library defaults are restored when the
+ * fleet is destroyed.
+ */
+class SimFleet {
+public:
+    // virtualClock = false runs the simulation in real time (e.g. with the radio task)
+    SimFleet(const BenchmarkArgs& args, Print* output, const bool virtualClock = true);
+    ~SimFleet();
+
+    // mix is hm, hms, hmt, a list of them joined by + (round robin) or mixed (hm+hms+hmt)
+    void addInverters(const uint32_t count, const char* mix);
+    std::shared_ptr<InverterAbstract> addInverter(const uint64_t serial);
+
+    VirtualInverter* getVirtualInverter(const uint64_t serial);
+    const VirtualInverterConfig& getConfig() const;
+
+    // Runs HoymilesClass::loop() once, advances the virtual clock by tickUs and
+    // returns the host time spent in the loops in µs.
+    uint64_t tick(const uint64_t tickUs);
+
+    HoymilesRadio_Sim& radioNrf();
+    HoymilesRadio_Sim& radioCmt();
+
+    uint32_t getTxCount() const;
+    uint32_t getRxFragmentCount() const;
+    uint32_t getLostFragmentCount() const;
+    uint32_t getFifoOverflowCount() const;
+    // Heap taken by HoymilesClass for the added inverters, without the virtual inverters
+    uint64_t getLibraryBytes() const;
+
+    static uint64_t buildSerial(const char* mix, const uint32_t index);
+    // Number of inverter types the mix cycles through
+    static uint8_t getMixSize(const char* mix);
+
+private:
+    HoymilesRadio_Sim _simNrf;
+    HoymilesRadio_Sim _simCmt;
+    VirtualInverterConfig _config;
+    uint64_t _libraryBytes = 0;
+};
@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Simulates the RF protocol side of a Hoymiles inverter.
+
+Response frame structure (as sent by the inverter):
+00   01 02 03 04   05 06 07 08   09   10 ... n-1   n
+----------------------------------------------------
+95   71 60 35 46   80 12 23 04   01   payload      CRC8
+^^   ^^^^^^^^^^^   ^^^^^^^^^^^   ^^
+Cmd  Inverter      DTU           Fragment id (0x80 marks the last fragment)
+
+Multi fragment responses carry a CRC16 (modbus) over the whole payload in the
+last two payload bytes of the last fragment.
+*/
+#include "VirtualInverter.h"
+#include <crc.h>
+#include <cstring>
+
+VirtualInverter::VirtualInverter(const InverterAbstract& model, const VirtualInverterConfig& config)
+{
+    _serial.u64 = model.serial();
+    _config = config;
+    _byteAssignment = model.getByteAssignment();
+    _byteAssignmentSize = model.getByteAssignmentSize();
+
+    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
+        if (_byteAssignment[i].type == TYPE_DC && _byteAssignment[i].ch + 1 > _dcChannelCount) {
+            _dcChannelCount = _byteAssignment[i].ch + 1;
+        }
+    }
+}
+
+uint64_t VirtualInverter::serial() const
+{
+    return _serial.u64;
+}
+
+const VirtualInverterConfig& VirtualInverter::getConfig() const
+{
+    return _config;
+}
+
+void VirtualInverter::setConfig(const VirtualInverterConfig& config)
+{
+    _config = config;
+}
+
+float VirtualInverter::getPower() const
+{
+    return _power;
+}
+
+void VirtualInverter::setPower(const float power)
+{
+    _power = power;
+}
+
+float VirtualInverter::getLimitPercent() const
+{
+    return _limitPercent;
+}
+
+uint32_t VirtualInverter::getLimitCommandCount() const
+{
+    return _limitCommandCount;
+}
+
+uint8_t VirtualInverter::handleRequest(const uint8_t request[], const uint8_t len, fragment_t response[])
+{
+    uint8_t data[VIRTUAL_MAX_RESPONSE_FRAGMENTS * VIRTUAL_FRAGMENT_DATA_SIZE] = {};
+
+    switch (request[0]) {
+    case 0x15:
+        if (len == 11) {
+            // RequestFrameCommand: re-send a single fragment of the last response
+            const uint8_t fragmentId = request[9] & 0x7f;
+            if (fragmentId == 0 || fragmentId > _lastResponseCount) {
+                return 0;
+            }
+            response[0] = _lastResponse[fragmentId - 1];
+            return 1;
+        }
+
+        switch (request[10]) {
+        case 0x00: // DevInfoSimple
+            data[2] = 0x10; // hardware part number
+            data[3] = 0x12;
+            data[4] = 0x30;
+            data[5] = 0x00;
+            data[6] = 0x01; // hardware version
+            data[7] = 0x00;
+            return buildMultiDataResponse(request, data, 14, response);
+
+        case 0x01: // DevInfoAll
+            data[0] = 0x27; // firmware version 10001
+            data[1] = 0x11;
+            data[2] = 0x07; // firmware build year 2023
+            data[3] = 0xe7;
+            data[4] = 0x04; // month/day 12/15
+            data[5] = 0xbf;
+            data[6] = 0x04; // hour/minute 12:00
+            data[7] = 0xb0;
+            data[9] = 0x50; // bootloader version
+            return buildMultiDataResponse(request, data, 14, response);
+
+        case 0x02: // GridOnProFilePara
+            data[0] = 0x03; // EU - EN 50549-1:2019
+            data[1] = 0x00;
+            data[2] = 0x10;
+            return buildMultiDataResponse(request, data, 8, response);
+
+        case 0x05: { // SystemConfigPara
+            const uint16_t limit = _limitPercent * 10;
+            data[2] = limit >> 8;
+            data[3] = limit;
+            return buildMultiDataResponse(request, data, 16, response);
+        }
+
+        case 0x0b: // RealTimeRunData
+            return buildMultiDataResponse(request, data, encodeRealTimeData(data), response);
+
+        case 0x11: // AlarmData
+            return buildMultiDataResponse(request, data, 2, response);
+
+        default:
+            return 0;
+        }
+
+    case 0x51: // DevControl (power limit, on/off, restart)
+        if (request[10] == 0x0b) {
+            _limitCommandCount++;
+            // Only relative limits (type 0x0001 and 0x0101) are applied
+            if (request[15] == 0x01) {
+                _limitPercent = ((request[12] << 8) | request[13]) / 10.0f;
+            }
+        }
+        data[0] = request[10];
+        return buildSingleResponse(request, data, 2, response);
+
+    default:
+        // e.g. ChannelChange (0x56) is not answered
+        return 0;
+    }
+}
+
+uint8_t VirtualInverter::buildMultiDataResponse(const uint8_t request[], const uint8_t data[], const uint8_t dataLen, fragment_t response[])
+{
+    uint8_t payload[VIRTUAL_MAX_RESPONSE_FRAGMENTS * VIRTUAL_FRAGMENT_DATA_SIZE];
+    memcpy(payload, data, dataLen);
+
+    const uint16_t crc = crc16(data, dataLen);
+    payload[dataLen] = crc >> 8;
+    payload[dataLen + 1] = crc;
+    const uint16_t payloadLen = dataLen + 2;
+
+    uint8_t count = 0;
+    for (uint16_t offs = 0; offs < payloadLen; offs += VIRTUAL_FRAGMENT_DATA_SIZE) {
+        const uint8_t len = min<uint16_t>(VIRTUAL_FRAGMENT_DATA_SIZE, payloadLen - offs);
+        const bool isLast = offs + len >= payloadLen;
+        buildFragment(response[count], request, count + 1, isLast, &payload[offs], len);
+        response[count].rssi = _config.rssi;
+        count++;
+    }
+
+    memcpy(_lastResponse, response, count * sizeof(fragment_t));
+    _lastResponseCount = count;
+    return count;
+}
+
+uint8_t VirtualInverter::buildSingleResponse(const uint8_t request[], const uint8_t data[], const uint8_t dataLen, fragment_t response[])
+{
+    buildFragment(response[0], request, 1, true, data, dataLen);
+    response[0].rssi = _config.rssi;
+    return 1;
+}
+
+void VirtualInverter::buildFragment(fragment_t& fragment, const uint8_t request[], const uint8_t fragmentId, const bool isLast, const uint8_t data[], const uint8_t dataLen)
+{
+    memset(&fragment, 0, sizeof(fragment));
+    fragment.fragment[0] = request[0] | 0x80;
+    memcpy(&fragment.fragment[1], &request[1], 8); // inverter and dtu address
+    fragment.fragment[9] = fragmentId | (isLast ? 0x80 : 0x00);
+    memcpy(&fragment.fragment[10], data, dataLen);
+    fragment.len = 10 + dataLen + 1;
+    fragment.fragment[fragment.len - 1] = crc8(fragment.fragment, fragment.len - 1);
+}
+
+uint8_t VirtualInverter::encodeRealTimeData(uint8_t data[]) const
+{
+    uint8_t len = 0;
+    for (uint8_t i = 0; i < _byteAssignmentSize; i++) {
+        const byteAssign_t& assign = _byteAssignment[i];
+        if (assign.div == CMD_CALC) {
+            continue;
+        }
+
+        uint32_t val;
+        if (assign.isSigned) {
+            val = static_cast<uint32_t>(static_cast<int32_t>(getFieldValue(assign) * assign.div));
+        } else {
+            val = static_cast<uint32_t>(getFieldValue(assign) * assign.div);
+        }
+
+        for (int8_t b = assign.num - 1; b >= 0; b--) {
+            data[assign.start + b] = val;
+            val >>= 8;
+        }
+        len = max<uint8_t>(len, assign.start + assign.num);
+    }
+    return len;
+}
+
+float VirtualInverter::getFieldValue(const byteAssign_t& assign) const
+{
+    const float dcPower = _power / 0.95f / max<uint8_t>(_dcChannelCount, 1);
+
+    switch (assign.fieldId) {
+    case FLD_UDC:
+        return 32.5f;
+    case FLD_IDC:
+        return dcPower / 32.5f;
+    case FLD_PDC:
+        return dcPower;
+    case FLD_YD:
+        return 1500.0f / max<uint8_t>(_dcChannelCount, 1);
+    case FLD_YT:
+        return _yieldTotal / max<uint8_t>(_dcChannelCount, 1);
+    case FLD_UAC:
+    case FLD_UAC_1N:
+    case FLD_UAC_2N:
+    case FLD_UAC_3N:
+        return 230.0f;
+    case FLD_UAC_12:
+    case FLD_UAC_23:
+    case FLD_UAC_31:
+        return 400.0f;
+    case FLD_IAC:
+        return _power / 230.0f;
+    case FLD_IAC_1:
+    case FLD_IAC_2:
+    case FLD_IAC_3:
+        return _power / 3 / 230.0f;
+    case FLD_PAC:
+        return _power;
+    case FLD_F:
+        return 50.0f;
+    case FLD_T:
+        return 35.0f;
+    case FLD_PF:
+        return 1.0f;
+    default:
+        return 0.0f;
+    }
+}
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#include <ChannelQualityTable.h>
+#include <inverters/InverterAbstract.h>
+#include <types.h>
+#include <cstdint>
+
+// maximum amount of fragments a virtual inverter answers with
+#define VIRTUAL_MAX_RESPONSE_FRAGMENTS 12
+
+// amount of payload bytes per response fragment (like real inverters)
+#define VIRTUAL_FRAGMENT_DATA_SIZE 16
+
+struct VirtualInverterConfig {
+    uint32_t latencyUs = 5000; // time between end of request and first response fragment
+    uint32_t fragmentSpacingUs = 1500; // time between two response fragments
+    uint32_t jitterUs = 1000; // random additional delay per fragment
+    float lossRate = 0.0f; // probability that a single packet gets lost (0..1)
+    int8_t rssi = -60; // reported signal strength of the response fragments
+    float channelLossRate[CHANNEL_QUALITY_CHANNELS] = {}; // additional loss per channel of the NRF hopping list (0..1)
+};
+
+class VirtualInverter {
+public:
+    // The byte assignment of the real inverter model is used to encode the realtime data
+    VirtualInverter(const InverterAbstract& model, const VirtualInverterConfig& config);
+
+    uint64_t serial() const;
+
+    const VirtualInverterConfig& getConfig() const;
+    void setConfig(const VirtualInverterConfig& config);
+
+    // Total ac output power used to derive all realtime values
+    float getPower() const;
+    void setPower(const float power);
+
+    // Last relative limit received by a DevControl command
+    float getLimitPercent() const;
+    uint32_t getLimitCommandCount() const;
+
+    // Builds the complete RF frames (including header and CRC8) answering a request.
+    // Returns the amount of fragments written to response.
+    uint8_t handleRequest(const uint8_t request[], const uint8_t len, fragment_t response[]);
+
+private:
+    uint8_t buildMultiDataResponse(const uint8_t request[], const uint8_t data[], const uint8_t dataLen, fragment_t response[]);
+    uint8_t buildSingleResponse(const uint8_t request[], const uint8_t data[], const uint8_t dataLen, fragment_t response[]);
+    static void buildFragment(fragment_t& fragment, const uint8_t request[], const uint8_t fragmentId, const bool isLast, const uint8_t data[], const uint8_t dataLen);
+
+    uint8_t encodeRealTimeData(uint8_t data[]) const;
+    float getFieldValue(const byteAssign_t& assign) const;
+
+    serial_u _serial;
+    VirtualInverterConfig _config;
+
+    const byteAssign_t* _byteAssignment;
+    uint8_t _byteAssignmentSize;
+    uint8_t _dcChannelCount = 0;
+
+    float _power = 300;
+    float _yieldTotal = 1234.5;
+    float _limitPercent = 100;
+    uint32_t _limitCommandCount = 0;
+
+    // last multi fragment response, used to answer retransmit requests
+    fragment_t _lastResponse[VIRTUAL_MAX_RESPONSE_FRAGMENTS];
+    uint8_t _lastResponseCount = 0;
+};
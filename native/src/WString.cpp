@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "WString.h"
+#include <cstdio>
+
+static std::string toBase(unsigned long value, const unsigned char base, const bool negative)
+{
+    char buf[8 * sizeof(value) + 2];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+
+    const unsigned char b = (base < 2) ? 10 : base;
+    do {
+        const char c = value % b;
+        value /= b;
+        *--str = c < 10 ? c + '0' : c + 'a' - 10;
+    } while (value);
+
+    if (negative) {
+        *--str = '-';
+    }
+    return str;
+}
+
+String::String(const char* str)
+    : _str(str != nullptr ? str : "")
+{
+}
+
+String::String(const std::string& str)
+    : _str(str)
+{
+}
+
+String::String(const char c)
+    : _str(1, c)
+{
+}
+
+String::String(const int value, const unsigned char base)
+    : String(static_cast<long>(value), base)
+{
+}
+
+String::String(const unsigned int value, const unsigned char base)
+    : String(static_cast<unsigned long>(value), base)
+{
+}
+
+String::String(const long value, const unsigned char base)
+    : _str(base == 10 && value < 0 ? toBase(-static_cast<unsigned long>(value), base, true) : toBase(value, base, false))
+{
+}
+
+String::String(const unsigned long value, const unsigned char base)
+    : _str(toBase(value, base, false))
+{
+}
+
+String::String(const float value, const unsigned int decimalPlaces)
+    : String(static_cast<double>(value), decimalPlaces)
+{
+}
+
+String::String(const double value, const unsigned int decimalPlaces)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    _str = buf;
+}
+
+String& String::operator+=(const String& rhs)
+{
+    _str += rhs._str;
+    return *this;
+}
+
+String& String::operator+=(const char* rhs)
+{
+    _str += rhs;
+    return *this;
+}
+
+String& String::operator+=(const char c)
+{
+    _str += c;
+    return *this;
+}
+
+String operator+(const String& lhs, const String& rhs)
+{
+    String s(lhs);
+    s += rhs;
+    return s;
+}
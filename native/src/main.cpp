@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+// The native tests (pio test -e native) bring their own main()
+#ifndef PIO_UNIT_TESTING
+
+#include "Benchmark.h"
+#include <cstdio>
+#include <cstring>
+
+static const BenchmarkSuite_t suites[] = {
+    { "fleet", "Simulated inverter fleets: poll rate, failures, memory and the library features", &benchmarkFleet },
+    { "cmt", "CMT2300A register cache and transmit power control against a host chip", &benchmarkCmt },
+    { "threads", "Radio task, snapshots and buffers between threads", &benchmarkThreads },
+    { "micro", "Crc, inverter lookup and field render against their previous implementations", &benchmarkMicro },
+    { "replay", "Replay of a raw RF capture through the fragment handling and the parsers", &benchmarkReplay },
+};
+
+static void printUsage(const char* name)
+{
+    printf("Usage: %s <suite> [options]\n\nAvailable suites:\n", name);
+    for (const auto& suite : suites) {
+        printf("  %-12s %s\n", suite.name, suite.description);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    for (const auto& suite : suites) {
+        if (strcmp(argv[1], suite.name) == 0) {
+            return suite.func(BenchmarkArgs(argc - 2, &argv[2]));
+        }
+    }
+
+    printf("Unknown suite: %s\n\n", argv[1]);
+    printUsage(argv[0]);
+    return 1;
+}
+
+#endif
@@ -7,14 +7,18 @@
 #include "Utils.h"
 #include "defaults.h"
 #include <ArduinoJson.h>
+#include <algorithm>
 #include <LittleFS.h>
+#include <new>
 #include <nvs_flash.h>
 
 CONFIG_T config;
 
 void ConfigurationClass::init()
 {
-    memset(&config, 0x0, sizeof(config));
+    // Zeroes all plain members, CONFIG_T is too large for a temporary on the stack
+    config.~CONFIG_T();
+    new (&config) CONFIG_T();
 }
 
 bool ConfigurationClass::write()
@@ -88,6 +92,8 @@ bool ConfigurationClass::write()
     JsonObject dtu = doc["dtu"].to<JsonObject>();
     dtu["serial"] = config.Dtu.Serial;
     dtu["poll_interval"] = config.Dtu.PollInterval;
+    dtu["poll_interval_min"] = config.Dtu.PollIntervalMin;
+    dtu["poll_interval_max"] = config.Dtu.PollIntervalMax;
     dtu["nrf_pa_level"] = config.Dtu.Nrf.PaLevel;
     dtu["cmt_pa_level"] = config.Dtu.Cmt.PaLevel;
     dtu["cmt_frequency"] = config.Dtu.Cmt.Frequency;
@@ -116,7 +122,7 @@ bool ConfigurationClass::write()
     }
 
     JsonArray inverters = doc["inverters"].to<JsonArray>();
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
+    for (uint8_t i = 0; i < config.Inverter.size(); i++) {
         JsonObject inv = inverters.add<JsonObject>();
         inv["serial"] = config.Inverter[i].Serial;
         inv["name"] = config.Inverter[i].Name;
@@ -147,7 +153,7 @@ bool ConfigurationClass::write()
     sunspec["power_divider"] = config.SunSpec.PowerDivider;
 
     JsonArray sunspecinv = sunspec["inverters"].to<JsonArray>();
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
+    for (uint8_t i = 0; i < config.SunSpec.Inverter.size(); i++) {
         auto serial = config.SunSpec.Inverter[i].Serial;
 
         if(serial == 0) {
@@ -292,6 +298,8 @@ bool ConfigurationClass::read()
     JsonObject dtu = doc["dtu"];
     config.Dtu.Serial = dtu["serial"] | DTU_SERIAL;
     config.Dtu.PollInterval = dtu["poll_interval"] | DTU_POLL_INTERVAL;
+    config.Dtu.PollIntervalMin = dtu["poll_interval_min"] | DTU_POLL_INTERVAL_MIN;
+    config.Dtu.PollIntervalMax = dtu["poll_interval_max"] | DTU_POLL_INTERVAL_MAX;
     config.Dtu.Nrf.PaLevel = dtu["nrf_pa_level"] | DTU_NRF_PA_LEVEL;
     config.Dtu.Cmt.PaLevel = dtu["cmt_pa_level"] | DTU_CMT_PA_LEVEL;
     config.Dtu.Cmt.Frequency = dtu["cmt_frequency"] | DTU_CMT_FREQUENCY;
@@ -320,7 +328,15 @@ bool ConfigurationClass::read()
     }
 
     JsonArray inverters = doc["inverters"];
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
+    // Trailing free slots (e.g. written by older versions) are dropped
+    size_t inverterCount = std::min<size_t>(inverters.size(), INV_MAX_COUNT);
+    while (inverterCount > 0 && (inverters[inverterCount - 1]["serial"] | 0ULL) == 0) {
+        inverterCount--;
+    }
+    config.Inverter.clear();
+    resizeInverters(inverterCount);
+
+    for (uint8_t i = 0; i < config.Inverter.size(); i++) {
         JsonObject inv = inverters[i].as<JsonObject>();
         config.Inverter[i].Serial = inv["serial"] | 0ULL;
         strlcpy(config.Inverter[i].Name, inv["name"] | "", sizeof(config.Inverter[i].Name));
@@ -351,7 +367,7 @@ bool ConfigurationClass::read()
     strlcpy(config.SunSpec.Model, sunspec["model"] | "SunSpec", sizeof(config.SunSpec.Model));
 
     JsonArray sunspecinv = sunspec["inverters"];
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
+    for (uint8_t i = 0; i < config.SunSpec.Inverter.size(); i++) {
         JsonObject inv = sunspecinv[i].as<JsonObject>();
         uint64_t serial = inv["serial"];
 
@@ -397,7 +413,7 @@ void ConfigurationClass::migrate()
 
     if (config.Cfg.Version < 0x00011700) {
         JsonArray inverters = doc["inverters"];
-        for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
+        for (uint8_t i = 0; i < config.Inverter.size(); i++) {
             JsonObject inv = inverters[i].as<JsonObject>();
             JsonArray channels = inv["channels"];
             for (uint8_t c = 0; c < INV_MAX_CHAN_COUNT; c++) {
@@ -450,20 +466,25 @@ CONFIG_T& ConfigurationClass::get()
 
 INVERTER_CONFIG_T* ConfigurationClass::getFreeInverterSlot()
 {
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
-        if (config.Inverter[i].Serial == 0) {
-            return &config.Inverter[i];
+    for (auto& inverter : config.Inverter) {
+        if (inverter.Serial == 0) {
+            return &inverter;
         }
     }
 
-    return nullptr;
+    if (config.Inverter.size() >= INV_MAX_COUNT) {
+        return nullptr;
+    }
+
+    resizeInverters(config.Inverter.size() + 1);
+    return &config.Inverter.back();
 }
 
 INVERTER_CONFIG_T* ConfigurationClass::getInverterConfig(const uint64_t serial)
 {
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
-        if (config.Inverter[i].Serial == serial) {
-            return &config.Inverter[i];
+    for (auto& inverter : config.Inverter) {
+        if (inverter.Serial == serial) {
+            return &inverter;
         }
     }
 
@@ -471,6 +492,23 @@ INVERTER_CONFIG_T* ConfigurationClass::getInverterConfig(const uint64_t serial)
 }
 
 void ConfigurationClass::deleteInverterById(const uint8_t id)
+{
+    if (id >= config.Inverter.size()) {
+        return;
+    }
+
+    resetInverterSlot(id);
+    config.SunSpec.Inverter[id] = SUNSPEC_INVERTER_CONFIG_T();
+
+    // Give the memory of trailing free slots back
+    size_t count = config.Inverter.size();
+    while (count > 0 && config.Inverter[count - 1].Serial == 0) {
+        count--;
+    }
+    resizeInverters(count);
+}
+
+void ConfigurationClass::resetInverterSlot(const uint8_t id)
 {
     config.Inverter[id].Serial = 0ULL;
     strlcpy(config.Inverter[id].Name, "", sizeof(config.Inverter[id].Name));
@@ -492,4 +530,15 @@ void ConfigurationClass::deleteInverterById(const uint8_t id)
     }
 }
 
+void ConfigurationClass::resizeInverters(const size_t count)
+{
+    const size_t previousCount = config.Inverter.size();
+    config.Inverter.resize(count);
+    config.SunSpec.Inverter.resize(count);
+
+    for (size_t i = previousCount; i < count; i++) {
+        resetInverterSlot(i);
+    }
+}
+
 ConfigurationClass Configuration;
@@ -81,10 +81,14 @@ void DatastoreClass::loop()
             }
         }
 
+        // All fields of one frame
+        StatisticsValues_t values;
+        inv->Statistics()->getValues(values);
+
         for (auto& c : inv->Statistics()->getChannelsByType(TYPE_INV)) {
             if (cfg->Poll_Enable) {
-                _totalAcYieldTotalEnabled += inv->Statistics()->getChannelFieldValue(TYPE_INV, c, FLD_YT);
-                _totalAcYieldDayEnabled += inv->Statistics()->getChannelFieldValue(TYPE_INV, c, FLD_YD);
+                _totalAcYieldTotalEnabled += inv->Statistics()->getChannelFieldValue(values, TYPE_INV, c, FLD_YT);
+                _totalAcYieldDayEnabled += inv->Statistics()->getChannelFieldValue(values, TYPE_INV, c, FLD_YD);
 
                 _totalAcYieldTotalDigits = max<unsigned int>(_totalAcYieldTotalDigits, inv->Statistics()->getChannelFieldDigits(TYPE_INV, c, FLD_YT));
                 _totalAcYieldDayDigits = max<unsigned int>(_totalAcYieldDayDigits, inv->Statistics()->getChannelFieldDigits(TYPE_INV, c, FLD_YD));
@@ -93,18 +97,18 @@ void DatastoreClass::loop()
 
         for (auto& c : inv->Statistics()->getChannelsByType(TYPE_AC)) {
             if (inv->getEnablePolling()) {
-                _totalAcPowerEnabled += inv->Statistics()->getChannelFieldValue(TYPE_AC, c, FLD_PAC);
+                _totalAcPowerEnabled += inv->Statistics()->getChannelFieldValue(values, TYPE_AC, c, FLD_PAC);
                 _totalAcPowerDigits = max<unsigned int>(_totalAcPowerDigits, inv->Statistics()->getChannelFieldDigits(TYPE_AC, c, FLD_PAC));
             }
         }
 
         for (auto& c : inv->Statistics()->getChannelsByType(TYPE_DC)) {
             if (inv->getEnablePolling()) {
-                _totalDcPowerEnabled += inv->Statistics()->getChannelFieldValue(TYPE_DC, c, FLD_PDC);
+                _totalDcPowerEnabled += inv->Statistics()->getChannelFieldValue(values, TYPE_DC, c, FLD_PDC);
                 _totalDcPowerDigits = max<unsigned int>(_totalDcPowerDigits, inv->Statistics()->getChannelFieldDigits(TYPE_DC, c, FLD_PDC));
 
                 if (inv->Statistics()->getStringMaxPower(c) > 0) {
-                    _totalDcPowerIrradiation += inv->Statistics()->getChannelFieldValue(TYPE_DC, c, FLD_PDC);
+                    _totalDcPowerIrradiation += inv->Statistics()->getChannelFieldValue(values, TYPE_DC, c, FLD_PDC);
                     _totalDcIrradiationInstalled += inv->Statistics()->getStringMaxPower(c);
                 }
             }
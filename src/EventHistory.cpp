@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "EventHistory.h"
+#include "MessageOutput.h"
+#include <LittleFS.h>
+#include <algorithm>
+#include <ctime>
+
+#define EVENT_HISTORY_MAGIC 0x45564831 // "EVH1"
+#define EVENT_HISTORY_VERSION 1
+
+typedef struct {
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t RecordSize;
+} EventHistoryHeader_t;
+
+EventHistoryClass EventHistory;
+
+EventHistoryClass::EventHistoryClass()
+    : _loopTask(1 * TASK_SECOND, TASK_FOREVER, std::bind(&EventHistoryClass::loop, this))
+{
+}
+
+void EventHistoryClass::init(Scheduler& scheduler)
+{
+    load();
+
+    scheduler.addTask(_loopTask);
+    _loopTask.enable();
+}
+
+bool EventHistoryClass::isAvailable()
+{
+    uint32_t day;
+    uint32_t secondsOfDay;
+    return getLocalDay(day, secondsOfDay);
+}
+
+void EventHistoryClass::loop()
+{
+    // The inverter only reports the time of day, without a valid clock the day is unknown
+    uint32_t day;
+    uint32_t secondsOfDay;
+    if (!getLocalDay(day, secondsOfDay)) {
+        return;
+    }
+
+    _lastUpdate.resize(Hoymiles.getNumInverters(), 0);
+
+    for (uint8_t i = 0; i < _lastUpdate.size(); i++) {
+        auto inv = Hoymiles.getInverterByPos(i);
+        if (inv == nullptr) {
+            continue;
+        }
+
+        AlarmLogParser* log = inv->EventLog();
+        const uint32_t lastUpdate = log->getLastUpdate();
+        if (lastUpdate == 0 || lastUpdate == _lastUpdate[i]) {
+            continue;
+        }
+        _lastUpdate[i] = lastUpdate;
+
+        EventHistoryRecord_t records[ALARM_LOG_ENTRY_COUNT];
+        size_t count = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            const uint8_t entryCount = std::min<uint8_t>(log->getEntryCount(), ALARM_LOG_ENTRY_COUNT);
+            for (uint8_t e = 0; e < entryCount; e++) {
+                AlarmLogEntry_t entry;
+                log->getLogEntry(e, entry);
+
+                EventHistoryRecord_t& record = records[count];
+                record.Serial = inv->serial();
+                record.Entry = EventIndex::makeEntry(day, secondsOfDay, entry.StartTime, entry.EndTime,
+                    entry.MessageId, static_cast<uint8_t>(log->getMessageType()));
+
+                if (_index.insert(record.Serial, record.Entry)) {
+                    count++;
+                }
+            }
+        }
+
+        if (count == 0) {
+            continue;
+        }
+
+        if (_index.size() > EVENT_HISTORY_MAX_COUNT || _fileRecords + count > 2 * EVENT_HISTORY_MAX_COUNT) {
+            compact();
+        } else if (!append(records, count)) {
+            MessageOutput.println("Failed to append to the event history");
+        }
+    }
+}
+
+size_t EventHistoryClass::getEvents(const uint64_t serial, const uint32_t from, const uint32_t to,
+    const size_t offset, const size_t limit, std::vector<EventHistoryEntry_t>& page)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _index.getEvents(serial, from, to, offset, limit, page);
+}
+
+void EventHistoryClass::load()
+{
+    File f = LittleFS.open(EVENT_HISTORY_FILENAME, "r", false);
+    if (!f) {
+        return;
+    }
+
+    EventHistoryHeader_t header;
+    bool valid = f.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header)
+        && header.Magic == EVENT_HISTORY_MAGIC
+        && header.Version == EVENT_HISTORY_VERSION
+        && header.RecordSize == sizeof(EventHistoryRecord_t);
+
+    if (valid) {
+        EventHistoryRecord_t record;
+        while (f.read(reinterpret_cast<uint8_t*>(&record), sizeof(record)) == sizeof(record)) {
+            _index.insert(record.Serial, record.Entry);
+            _fileRecords++;
+        }
+    }
+    f.close();
+
+    MessageOutput.printf("Event history: %u events loaded\r\n", static_cast<uint32_t>(_index.size()));
+
+    if (!valid || _index.size() > EVENT_HISTORY_MAX_COUNT || _fileRecords > 2 * EVENT_HISTORY_MAX_COUNT) {
+        compact();
+    }
+}
+
+bool EventHistoryClass::append(const EventHistoryRecord_t* records, const size_t count)
+{
+    File f = LittleFS.open(EVENT_HISTORY_FILENAME, "a");
+    if (!f) {
+        return false;
+    }
+
+    if (f.size() == 0) {
+        const EventHistoryHeader_t header = { EVENT_HISTORY_MAGIC, EVENT_HISTORY_VERSION, sizeof(EventHistoryRecord_t) };
+        f.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    }
+
+    const size_t len = count * sizeof(EventHistoryRecord_t);
+    const bool ok = f.write(reinterpret_cast<const uint8_t*>(records), len) == len;
+    f.close();
+
+    _fileRecords += count;
+    return ok;
+}
+
+// Drops the oldest events above EVENT_HISTORY_MAX_COUNT and rewrites the file with one record per event
+void EventHistoryClass::compact()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const std::vector<EventHistoryRecord_t> records = _index.compact(EVENT_HISTORY_MAX_COUNT);
+
+    _fileRecords = 0;
+    LittleFS.remove(EVENT_HISTORY_FILENAME);
+    if (!records.empty() && !append(records.data(), records.size())) {
+        MessageOutput.println("Failed to write the event history");
+    }
+}
+
+bool EventHistoryClass::getLocalDay(uint32_t& day, uint32_t& secondsOfDay)
+{
+    const time_t now = time(nullptr);
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+    if (timeinfo.tm_year <= (2016 - 1900)) {
+        return false;
+    }
+
+    // Days since 1970-01-01 of the local date, see http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+    const int32_t y = timeinfo.tm_year + 1900 - (timeinfo.tm_mon < 2 ? 1 : 0);
+    const int32_t era = y / 400;
+    const int32_t yoe = y - era * 400;
+    const int32_t m = timeinfo.tm_mon + 1;
+    const int32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + timeinfo.tm_mday - 1;
+    const int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    day = era * 146097 + doe - 719468;
+    secondsOfDay = timeinfo.tm_hour * 3600 + timeinfo.tm_min * 60 + timeinfo.tm_sec;
+    return true;
+}
@@ -67,8 +67,9 @@ void InverterSettingsClass::init(Scheduler& scheduler)
 
         MessageOutput.println("  Setting poll interval... ");
         Hoymiles.setPollInterval(config.Dtu.PollInterval);
+        Hoymiles.setPollIntervalBounds(config.Dtu.PollIntervalMin, config.Dtu.PollIntervalMax);
 
-        for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
+        for (uint8_t i = 0; i < config.Inverter.size(); i++) {
             if (config.Inverter[i].Serial > 0) {
                 MessageOutput.print("  Adding inverter: ");
                 MessageOutput.print(config.Inverter[i].Serial, HEX);
@@ -97,7 +98,11 @@ void InverterSettingsClass::init(Scheduler& scheduler)
     }
 
     scheduler.addTask(_hoyTask);
-    _hoyTask.enable();
+    if (HOYMILES_RADIO_TASK && Hoymiles.startRadioTask(HOYMILES_RADIO_TASK_CORE)) {
+        MessageOutput.printf("Hoymiles radio task started on core %d\r\n", HOYMILES_RADIO_TASK_CORE);
+    } else {
+        _hoyTask.enable();
+    }
 
     scheduler.addTask(_settingsTask);
     _settingsTask.enable();
@@ -108,8 +113,7 @@ void InverterSettingsClass::settingsLoop()
     const CONFIG_T& config = Configuration.get();
     const bool isDayPeriod = SunPosition.isDayPeriod();
 
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
-        auto const& inv_cfg = config.Inverter[i];
+    for (auto const& inv_cfg : config.Inverter) {
         if (inv_cfg.Serial == 0) {
             continue;
         }
@@ -4,19 +4,19 @@
  */
 #include "MessageOutput.h"
 
-#include <Arduino.h>
+#include <HoymilesLog.h>
+#include <algorithm>
+#include <cstring>
 
 MessageOutputClass MessageOutput;
 
-MessageOutputClass::MessageOutputClass()
-    : _loopTask(TASK_IMMEDIATE, TASK_FOREVER, std::bind(&MessageOutputClass::loop, this))
-{
-}
+thread_local MessageOutputClass::CharBuffer_t MessageOutputClass::_chars;
 
-void MessageOutputClass::init(Scheduler& scheduler)
+void MessageOutputClass::init()
 {
-    scheduler.addTask(_loopTask);
-    _loopTask.enable();
+    if (xTaskCreate(taskFunction, "output", MESSAGE_OUTPUT_TASK_STACK_SIZE, this, MESSAGE_OUTPUT_TASK_PRIORITY, nullptr) == pdPASS) {
+        _taskRunning = true;
+    }
 }
 
 void MessageOutputClass::register_ws_output(AsyncWebSocket* output)
@@ -26,41 +26,101 @@ void MessageOutputClass::register_ws_output(AsyncWebSocket* output)
 
 size_t MessageOutputClass::write(uint8_t c)
 {
-    if (_buff_pos < BUFFER_SIZE) {
-        std::lock_guard<std::mutex> lock(_msgLock);
-        _buffer[_buff_pos] = c;
-        _buff_pos++;
-    } else {
-        _forceSend = true;
+    if (!_taskRunning) {
+        return Serial.write(c);
     }
 
-    return Serial.write(c);
+    // A slot for every byte would fill the buffer with a fraction of its size in text
+    _chars.data[_chars.len++] = c;
+    if (c == '\n' || _chars.len == sizeof(_chars.data)) {
+        flushChars();
+    }
+    return 1;
 }
 
 size_t MessageOutputClass::write(const uint8_t* buffer, size_t size)
 {
-    std::lock_guard<std::mutex> lock(_msgLock);
-    if (_buff_pos + size < BUFFER_SIZE) {
-        memcpy(&_buffer[_buff_pos], buffer, size);
-        _buff_pos += size;
+    if (!_taskRunning) {
+        return Serial.write(buffer, size);
     }
-    _forceSend = true;
 
-    return Serial.write(buffer, size);
+    // Keeps the order of the output of this task
+    flushChars();
+
+    // Never blocks, the output is dropped (and counted) if the buffer is full
+    _buffer.write(buffer, size);
+    return size;
+}
+
+void MessageOutputClass::flushChars()
+{
+    if (_chars.len > 0) {
+        _buffer.write(_chars.data, _chars.len);
+        _chars.len = 0;
+    }
+}
+
+int MessageOutputClass::availableForWrite()
+{
+    return _buffer.available();
+}
+
+MessageOutputStatistics_t MessageOutputClass::getStatistics() const
+{
+    MessageOutputStatistics_t statistics;
+    statistics.droppedBytes = _buffer.getDroppedBytes();
+    statistics.wsDroppedBytes = _wsDroppedBytes;
+    statistics.highWaterMark = _buffer.getHighWaterMark() * MESSAGE_OUTPUT_SLOT_SIZE;
+    return statistics;
+}
+
+void MessageOutputClass::taskFunction(void* arg)
+{
+    static_cast<MessageOutputClass*>(arg)->loop();
 }
 
 void MessageOutputClass::loop()
 {
-    // Send data via websocket if either time is over or buffer is full
-    if (_forceSend || (millis() - _lastSend > 1000)) {
-        std::lock_guard<std::mutex> lock(_msgLock);
-        if (_ws && _buff_pos > 0) {
-            _ws->textAll(_buffer, _buff_pos);
-            _buff_pos = 0;
+    uint8_t chunk[256];
+
+    for (;;) {
+        // Format the deferred log of the radios, it is written with the other output below
+        HoymilesLog.flush(*this);
+
+        const size_t len = _buffer.read(chunk, sizeof(chunk));
+        if (len > 0) {
+            // Only blocks this task, the writers keep filling the buffer
+            Serial.write(chunk, len);
+
+            if (_wsLen + len > sizeof(_wsBuffer)) {
+                sendWs();
+            }
+            const size_t wsLen = std::min(len, sizeof(_wsBuffer));
+            memcpy(&_wsBuffer[_wsLen], chunk, wsLen);
+            _wsLen += wsLen;
+        }
+
+        if (_wsLen > 0 && millis() - _wsLastSend > MESSAGE_OUTPUT_WS_INTERVAL) {
+            sendWs();
+        }
+
+        if (len == 0) {
+            vTaskDelay(pdMS_TO_TICKS(MESSAGE_OUTPUT_IDLE_WAIT));
         }
-        if (_forceSend) {
-            _buff_pos = 0;
+    }
+}
+
+void MessageOutputClass::sendWs()
+{
+    AsyncWebSocket* ws = _ws;
+    if (ws != nullptr && ws->count() > 0) {
+        // Slow clients must not hold back the console, skip the output they cannot take
+        if (ws->availableForWriteAll()) {
+            ws->textAll(_wsBuffer, _wsLen);
+        } else {
+            _wsDroppedBytes += _wsLen;
         }
-        _forceSend = false;
     }
+    _wsLen = 0;
+    _wsLastSend = millis();
 }
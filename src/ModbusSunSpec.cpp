@@ -317,27 +317,31 @@ void ModbusSunSpecClass::loop() {
             continue;
         }
 
+        // All fields of one frame
+        StatisticsValues_t values;
+        stats->getValues(values);
+
         for (auto& t : stats->getChannelTypes()) {
             for (auto& c : stats->getChannelsByType(t)) {
                 if (t == TYPE_AC) {
                     auto phase = conf->channel_ac[c].Phase;
-                    phases[phase].current += (stats->getChannelFieldValue(t, c, FLD_IAC) * 100);
-                    phases[phase].voltage = max(phases[phase].voltage, (uint16_t)(stats->getChannelFieldValue(t, c, FLD_UAC) * 10));
-                    phases[phase].power += (uint16_t)(stats->getChannelFieldValue(t, c, FLD_PAC) * 10);
-                    phases[phase].power_factor += (uint16_t)(stats->getChannelFieldValue(t, c, FLD_PF) * 100);
-                    phases[phase].frequency += (uint16_t)(stats->getChannelFieldValue(t, c, FLD_F) * 10);
+                    phases[phase].current += (stats->getChannelFieldValue(values, t, c, FLD_IAC) * 100);
+                    phases[phase].voltage = max(phases[phase].voltage, (uint16_t)(stats->getChannelFieldValue(values, t, c, FLD_UAC) * 10));
+                    phases[phase].power += (uint16_t)(stats->getChannelFieldValue(values, t, c, FLD_PAC) * 10);
+                    phases[phase].power_factor += (uint16_t)(stats->getChannelFieldValue(values, t, c, FLD_PF) * 100);
+                    phases[phase].frequency += (uint16_t)(stats->getChannelFieldValue(values, t, c, FLD_F) * 10);
                     phases[phase].count++;
                 }
 
                 if (t == TYPE_DC) {
-                    total_current_dc += (stats->getChannelFieldValue(t, c, FLD_IDC) * 100);
-                    max_voltage_dc = max(max_voltage_dc, (uint16_t)(stats->getChannelFieldValue(t, c, FLD_UDC) * 10));
-                    total_power_dc += (uint16_t)(stats->getChannelFieldValue(t, c, FLD_PDC) * 10);
+                    total_current_dc += (stats->getChannelFieldValue(values, t, c, FLD_IDC) * 100);
+                    max_voltage_dc = max(max_voltage_dc, (uint16_t)(stats->getChannelFieldValue(values, t, c, FLD_UDC) * 10));
+                    total_power_dc += (uint16_t)(stats->getChannelFieldValue(values, t, c, FLD_PDC) * 10);
                 }
 
                 if (t == TYPE_INV) {
-                    total_energy += (uint32_t)(stats->getChannelFieldValue(t, c, FLD_YT) * 10 * 1000); // kWh -> Wh
-                    max_temp = max(max_temp, (int16_t)(stats->getChannelFieldValue(t, c, FLD_T) * 10));
+                    total_energy += (uint32_t)(stats->getChannelFieldValue(values, t, c, FLD_YT) * 10 * 1000); // kWh -> Wh
+                    max_temp = max(max_temp, (int16_t)(stats->getChannelFieldValue(values, t, c, FLD_T) * 10));
                 }
             }
         }
@@ -524,7 +528,12 @@ ModbusSunSpecClass::Limit* ModbusSunSpecClass::getLimit(uint64_t serial) {
         }
     }
 
-    return nullptr;
+    if (_limit.size() >= INV_MAX_COUNT) {
+        return nullptr;
+    }
+
+    _limit.push_back({ serial, 0, 0, false });
+    return &_limit.back();
 }
 
 void ModbusSunSpecClass::setManufacturerModel(const char* manufacturer, const char* model) {
@@ -151,7 +151,7 @@ void MqttHandleHassClass::publishInverterField(std::shared_ptr<InverterAbstract>
         createInverterInfo(root, inv);
 
         if (Configuration.get().Mqtt.Hass.Expire) {
-            root["exp_aft"] = Hoymiles.getNumInverters() * max<uint32_t>(Hoymiles.PollInterval(), Configuration.get().Mqtt.PublishInterval) * inv->getReachableThreshold();
+            root["exp_aft"] = max<uint32_t>(Hoymiles.getNumInverters() * max<uint32_t>(Hoymiles.PollInterval(), Configuration.get().Mqtt.PublishInterval), Hoymiles.getPollIntervalMax()) * inv->getReachableThreshold();
         }
         if (devCls != 0) {
             root["dev_cla"] = devCls;
@@ -54,8 +54,10 @@ void MqttHandleInverterClass::loop()
         return;
     }
 
+    _lastPublishStats.resize(Hoymiles.getNumInverters(), 0);
+
     // Loop all inverters
-    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+    for (uint8_t i = 0; i < _lastPublishStats.size(); i++) {
         auto inv = Hoymiles.getInverterByPos(i);
 
         const String subtopic = inv->serialString();
@@ -103,6 +105,10 @@ void MqttHandleInverterClass::loop()
         if (inv->Statistics()->getLastUpdate() > 0 && (lastUpdateInternal != _lastPublishStats[i])) {
             _lastPublishStats[i] = lastUpdateInternal;
 
+            // All fields of one frame
+            StatisticsValues_t values;
+            inv->Statistics()->getValues(values);
+
             // Loop all channels
             for (auto& t : inv->Statistics()->getChannelTypes()) {
                 for (auto& c : inv->Statistics()->getChannelsByType(t)) {
@@ -114,7 +120,7 @@ void MqttHandleInverterClass::loop()
                         }
                     }
                     for (uint8_t f = 0; f < sizeof(_publishFields) / sizeof(FieldId_t); f++) {
-                        publishField(inv, t, c, _publishFields[f]);
+                        publishField(inv, values, t, c, _publishFields[f]);
                     }
                 }
             }
@@ -124,14 +130,14 @@ void MqttHandleInverterClass::loop()
     }
 }
 
-void MqttHandleInverterClass::publishField(std::shared_ptr<InverterAbstract> inv, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId)
+void MqttHandleInverterClass::publishField(std::shared_ptr<InverterAbstract> inv, const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId)
 {
     const String topic = getTopic(inv, type, channel, fieldId);
     if (topic == "") {
         return;
     }
 
-    MqttSettings.publish(topic, inv->Statistics()->getChannelFieldValueString(type, channel, fieldId));
+    MqttSettings.publish(topic, inv->Statistics()->getChannelFieldValueString(values, type, channel, fieldId));
 }
 
 String MqttHandleInverterClass::getTopic(std::shared_ptr<InverterAbstract> inv, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId)
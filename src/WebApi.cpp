@@ -30,6 +30,7 @@ void WebApiClass::init(Scheduler& scheduler)
     _webApiNtp.init(_server, scheduler);
     _webApiPower.init(_server, scheduler);
     _webApiPrometheus.init(_server, scheduler);
+    _webApiRfCapture.init(_server, scheduler);
     _webApiSecurity.init(_server, scheduler);
     _webApiSunSpec.init(_server, scheduler);
     _webApiSysstatus.init(_server, scheduler);
@@ -35,6 +35,53 @@ void WebApiDevInfoClass::onDevInfoStatus(AsyncWebServerRequest* request)
         root["hw_model_name"] = inv->DevInfo()->getHwModelName();
         root["max_power"] = inv->DevInfo()->getMaxPower();
         root["fw_build_datetime"] = inv->DevInfo()->getFwBuildDateTimeStr();
+
+        // Histograms of the time until the complete answer was received.
+        // The last bucket contains everything above the last limit.
+        static const char* const latencyClassNames[CommandLatencyClass_Max] = { "realtime", "alarm", "devinfo", "config", "control" };
+        const ResponseLatencyHistogram* latency = inv->ResponseLatency();
+        auto latencyObj = root["rx_latency"].to<JsonObject>();
+
+        auto limits = latencyObj["bucket_limits_ms"].to<JsonArray>();
+        for (uint8_t b = 0; b < RESPONSE_LATENCY_BUCKETS - 1; b++) {
+            limits.add(ResponseLatencyHistogram::getBucketLimit(b));
+        }
+
+        for (uint8_t c = 0; c < CommandLatencyClass_Max; c++) {
+            const CommandLatencyClass_t latencyClass = static_cast<CommandLatencyClass_t>(c);
+            auto classObj = latencyObj[latencyClassNames[c]].to<JsonObject>();
+            classObj["samples"] = latency->getSampleCount(latencyClass);
+            if (Hoymiles.getRxTimeoutMax() > 0) {
+                classObj["timeout_ms"] = latency->getTimeout(latencyClass, Hoymiles.getRxTimeoutMin(), Hoymiles.getRxTimeoutMax());
+            }
+
+            auto buckets = classObj["buckets"].to<JsonArray>();
+            for (uint8_t b = 0; b < RESPONSE_LATENCY_BUCKETS; b++) {
+                buckets.add(latency->getBucketCount(latencyClass, b));
+            }
+        }
+
+        // Transmit power currently used for this inverter
+        if (inv->getRadio() == Hoymiles.getRadioCmt()) {
+            root["cmt_pa_level"] = Hoymiles.getRadioCmt()->getPALevel(*inv);
+        }
+
+        // Link quality per channel, only the NRF radio hops between channels
+        if (inv->getRadio() == Hoymiles.getRadioNrf()) {
+            auto channels = root["rf_channels"].to<JsonArray>();
+            for (uint8_t c = 0; c < CHANNEL_QUALITY_CHANNELS; c++) {
+                const ChannelQualityEntry_t& entry = inv->ChannelQuality()->getEntry(c);
+                auto channelObj = channels.add<JsonObject>();
+                channelObj["channel"] = ChannelHopping::getChannel(c);
+                channelObj["tx"] = entry.txCount;
+                channelObj["tx_answered"] = entry.txAnswered;
+                channelObj["tx_rate"] = entry.txRate;
+                channelObj["rx_slots"] = entry.rxSlots;
+                channelObj["rx_fragments"] = entry.rxFragments;
+                channelObj["rx_rate"] = entry.rxRate;
+                channelObj["rssi"] = entry.rssi;
+            }
+        }
     }
 
     WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
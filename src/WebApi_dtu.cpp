@@ -35,6 +35,7 @@ void WebApiDtuClass::applyDataTaskCb()
     Hoymiles.getRadioCmt()->setCountryMode(static_cast<CountryModeId_t>(config.Dtu.Cmt.CountryMode));
     Hoymiles.getRadioCmt()->setInverterTargetFrequency(config.Dtu.Cmt.Frequency);
     Hoymiles.setPollInterval(config.Dtu.PollInterval);
+    Hoymiles.setPollIntervalBounds(config.Dtu.PollIntervalMin, config.Dtu.PollIntervalMax);
 }
 
 void WebApiDtuClass::onDtuAdminGet(AsyncWebServerRequest* request)
@@ -54,6 +55,8 @@ void WebApiDtuClass::onDtuAdminGet(AsyncWebServerRequest* request)
         ((uint32_t)(config.Dtu.Serial & 0xFFFFFFFF)));
     root["serial"] = buffer;
     root["pollinterval"] = config.Dtu.PollInterval;
+    root["pollinterval_min"] = config.Dtu.PollIntervalMin;
+    root["pollinterval_max"] = config.Dtu.PollIntervalMax;
     root["nrf_enabled"] = Hoymiles.getRadioNrf()->isInitialized();
     root["nrf_palevel"] = config.Dtu.Nrf.PaLevel;
     root["cmt_enabled"] = Hoymiles.getRadioCmt()->isInitialized();
@@ -71,6 +74,7 @@ void WebApiDtuClass::onDtuAdminGet(AsyncWebServerRequest* request)
         obj["freq_max"] = definition.definition.Freq_Max;
         obj["freq_legal_min"] = definition.definition.Freq_Legal_Min;
         obj["freq_legal_max"] = definition.definition.Freq_Legal_Max;
+        obj["pa_legal_max"] = definition.definition.PaLevel_Legal_Max;
     }
 
     WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
@@ -119,6 +123,19 @@ void WebApiDtuClass::onDtuAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
+    CONFIG_T& config = Configuration.get();
+
+    // The bounds of the adaptive interval are optional, missing ones keep their value
+    const uint32_t pollIntervalMin = root["pollinterval_min"] | config.Dtu.PollIntervalMin;
+    const uint32_t pollIntervalMax = root["pollinterval_max"] | config.Dtu.PollIntervalMax;
+
+    if (pollIntervalMax < pollIntervalMin) {
+        retMsg["message"] = "Maximum poll interval must not be less than the minimum!";
+        retMsg["code"] = WebApiError::DtuInvalidPollIntervalBounds;
+        WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+        return;
+    }
+
     if (root["nrf_palevel"].as<uint8_t>() > 3) {
         retMsg["message"] = "Invalid power level setting!";
         retMsg["code"] = WebApiError::DtuInvalidPowerLevel;
@@ -153,10 +170,10 @@ void WebApiDtuClass::onDtuAdminPost(AsyncWebServerRequest* request)
         return;
     }
 
-    CONFIG_T& config = Configuration.get();
-
     config.Dtu.Serial = serial;
     config.Dtu.PollInterval = root["pollinterval"].as<uint32_t>();
+    config.Dtu.PollIntervalMin = pollIntervalMin;
+    config.Dtu.PollIntervalMax = pollIntervalMax;
     config.Dtu.Nrf.PaLevel = root["nrf_palevel"].as<uint8_t>();
     config.Dtu.Cmt.PaLevel = root["cmt_palevel"].as<int8_t>();
     config.Dtu.Cmt.Frequency = root["cmt_frequency"].as<uint32_t>();
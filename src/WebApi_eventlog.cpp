@@ -3,6 +3,7 @@
  * Copyright (C) 2022-2024 Thomas Basler and others
  */
 #include "WebApi_eventlog.h"
+#include "EventHistory.h"
 #include "WebApi.h"
 #include <AsyncJson.h>
 #include <Hoymiles.h>
@@ -38,9 +39,33 @@ void WebApiEventlogClass::onEventlogStatus(AsyncWebServerRequest* request)
 
     auto inv = Hoymiles.getInverterBySerial(serial);
 
-    if (inv != nullptr) {
+    if (inv != nullptr && EventHistory.isAvailable()) {
+        const size_t offset = request->hasParam("offset") ? request->getParam("offset")->value().toInt() : 0;
+        const size_t limit = request->hasParam("limit") ? std::min<size_t>(request->getParam("limit")->value().toInt(), EVENT_HISTORY_PAGE_MAX) : EVENT_HISTORY_PAGE_SIZE;
+        const uint32_t from = request->hasParam("from") ? request->getParam("from")->value().toInt() : 0;
+        const uint32_t to = request->hasParam("to") ? request->getParam("to")->value().toInt() : UINT32_MAX;
+
+        std::vector<EventHistoryEntry_t> page;
+        root["total"] = EventHistory.getEvents(inv->serial(), from, to, offset, limit, page);
+        root["offset"] = offset;
+        root["count"] = page.size();
+        JsonArray eventsArray = root["events"].to<JsonArray>();
+
+        for (const EventHistoryEntry_t& entry : page) {
+            JsonObject eventsObject = eventsArray.add<JsonObject>();
+
+            eventsObject["message_id"] = entry.MessageId;
+            eventsObject["message"] = AlarmLogParser::getMessageText(entry.MessageId, static_cast<AlarmMessageType_t>(entry.MessageType), locale);
+            eventsObject["start_time"] = entry.Start % 86400;
+            eventsObject["end_time"] = entry.EndTime;
+            eventsObject["timestamp"] = entry.Start;
+        }
+    } else if (inv != nullptr) {
+        // Without a valid clock only the entries of the last alarm log request are known
         uint8_t logEntryCount = inv->EventLog()->getEntryCount();
 
+        root["total"] = logEntryCount;
+        root["offset"] = 0;
         root["count"] = logEntryCount;
         JsonArray eventsArray = root["events"].to<JsonArray>();
 
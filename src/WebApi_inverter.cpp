@@ -35,7 +35,7 @@ void WebApiInverterClass::onInverterList(AsyncWebServerRequest* request)
 
     const CONFIG_T& config = Configuration.get();
 
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
+    for (uint8_t i = 0; i < config.Inverter.size(); i++) {
         if (config.Inverter[i].Serial > 0) {
             JsonObject obj = data.add<JsonObject>();
             obj["id"] = i;
@@ -171,7 +171,7 @@ void WebApiInverterClass::onInverterEdit(AsyncWebServerRequest* request)
         return;
     }
 
-    if (root["id"].as<uint8_t>() > INV_MAX_COUNT - 1) {
+    if (root["id"].as<uint8_t>() >= Configuration.get().Inverter.size()) {
         retMsg["message"] = "Invalid ID specified!";
         retMsg["code"] = WebApiError::InverterInvalidId;
         WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
@@ -285,7 +285,7 @@ void WebApiInverterClass::onInverterDelete(AsyncWebServerRequest* request)
         return;
     }
 
-    if (root["id"].as<uint8_t>() > INV_MAX_COUNT - 1) {
+    if (root["id"].as<uint8_t>() >= Configuration.get().Inverter.size()) {
         retMsg["message"] = "Invalid ID specified!";
         retMsg["code"] = WebApiError::InverterInvalidId;
         WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
@@ -332,7 +332,7 @@ void WebApiInverterClass::onInverterOrder(AsyncWebServerRequest* request)
     uint8_t order = 0;
     for (JsonVariant id : orderArray) {
         uint8_t inverter_id = id.as<uint8_t>();
-        if (inverter_id < INV_MAX_COUNT) {
+        if (inverter_id < Configuration.get().Inverter.size()) {
             INVERTER_CONFIG_T& inverter = Configuration.get().Inverter[inverter_id];
             inverter.Order = order;
         }
@@ -63,6 +63,7 @@ void WebApiPrometheusClass::onPrometheusMetricsGet(AsyncWebServerRequest* reques
         stream->print("# TYPE wifi_station gauge\n");
         stream->printf("wifi_station{bssid=\"%s\"} 1\n", WiFi.BSSIDstr().c_str());
 
+        bool printChannelHelp = true;
         for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
             auto inv = Hoymiles.getInverterByPos(i);
 
@@ -91,16 +92,26 @@ void WebApiPrometheusClass::onPrometheusMetricsGet(AsyncWebServerRequest* reques
                     serial.c_str(), i, name, inv->SystemConfigPara()->getLimitPercent() * inv->DevInfo()->getMaxPower() / 100.0);
             }
 
+            // RF channels are only hopped by the NRF radio
+            if (inv->getRadio() == Hoymiles.getRadioNrf()) {
+                addChannelQuality(stream, serial, i, inv, printChannelHelp);
+                printChannelHelp = false;
+            }
+
             // Loop all channels if Statistics have been updated at least once since DTU boot
             if (inv->Statistics()->getLastUpdate() > 0) {
+                // All fields of one frame
+                StatisticsValues_t values;
+                inv->Statistics()->getValues(values);
+
                 for (auto& t : inv->Statistics()->getChannelTypes()) {
                     for (auto& c : inv->Statistics()->getChannelsByType(t)) {
                         addPanelInfo(stream, serial, i, inv, t, c);
                         for (uint8_t f = 0; f < sizeof(_publishFields) / sizeof(_publishFields[0]); f++) {
                             if (t == TYPE_INV && _publishFields[f].field == FLD_PDC) {
-                                addField(stream, serial, i, inv, t, c, _publishFields[f].field, _metricTypes[_publishFields[f].type], "PowerDC");
+                                addField(stream, serial, i, inv, values, t, c, _publishFields[f].field, _metricTypes[_publishFields[f].type], "PowerDC");
                             } else {
-                                addField(stream, serial, i, inv, t, c, _publishFields[f].field, _metricTypes[_publishFields[f].type]);
+                                addField(stream, serial, i, inv, values, t, c, _publishFields[f].field, _metricTypes[_publishFields[f].type]);
                             }
                         }
                     }
@@ -117,7 +128,7 @@ void WebApiPrometheusClass::onPrometheusMetricsGet(AsyncWebServerRequest* reques
     }
 }
 
-void WebApiPrometheusClass::addField(AsyncResponseStream* stream, const String& serial, const uint8_t idx, std::shared_ptr<InverterAbstract> inv, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, const char* metricName, const char* channelName)
+void WebApiPrometheusClass::addField(AsyncResponseStream* stream, const String& serial, const uint8_t idx, std::shared_ptr<InverterAbstract> inv, const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, const char* metricName, const char* channelName)
 {
     if (inv->Statistics()->hasChannelFieldValue(type, channel, fieldId)) {
         const char* chanName = (channelName == nullptr) ? inv->Statistics()->getChannelFieldName(type, channel, fieldId) : channelName;
@@ -132,7 +143,7 @@ void WebApiPrometheusClass::addField(AsyncResponseStream* stream, const String&
             inv->name(),
             inv->Statistics()->getChannelTypeName(type),
             channel,
-            inv->Statistics()->getChannelFieldValueString(type, channel, fieldId).c_str());
+            inv->Statistics()->getChannelFieldValueString(values, type, channel, fieldId).c_str());
     }
 }
 
@@ -142,7 +153,11 @@ void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, const Stri
         return;
     }
 
-    const CONFIG_T& config = Configuration.get();
+    // idx is the position in Hoymiles, not the configuration slot
+    const INVERTER_CONFIG_T* inv_cfg = Configuration.getInverterConfig(inv->serial());
+    if (inv_cfg == nullptr) {
+        return;
+    }
 
     const bool printHelp = (idx == 0 && channel == 0);
     if (printHelp) {
@@ -154,7 +169,7 @@ void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, const Stri
         idx,
         inv->name(),
         channel,
-        config.Inverter[idx].channel[channel].Name);
+        inv_cfg->channel[channel].Name);
 
     if (printHelp) {
         stream->print("# HELP opendtu_MaxPower panel maximum output power\n");
@@ -165,7 +180,7 @@ void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, const Stri
         idx,
         inv->name(),
         channel,
-        config.Inverter[idx].channel[channel].MaxChannelPower);
+        inv_cfg->channel[channel].MaxChannelPower);
 
     if (printHelp) {
         stream->print("# HELP opendtu_YieldTotalOffset panel yield offset (for used inverters)\n");
@@ -176,5 +191,46 @@ void WebApiPrometheusClass::addPanelInfo(AsyncResponseStream* stream, const Stri
         idx,
         inv->name(),
         channel,
-        config.Inverter[idx].channel[channel].YieldTotalOffset);
+        inv_cfg->channel[channel].YieldTotalOffset);
+}
+
+void WebApiPrometheusClass::addChannelQuality(AsyncResponseStream* stream, const String& serial, const uint8_t idx, std::shared_ptr<InverterAbstract> inv, const bool printHelp)
+{
+    const ChannelQualityTable* quality = inv->ChannelQuality();
+
+    if (printHelp) {
+        stream->print("# HELP opendtu_rf_tx_rate moving rate of answered transmissions per RF channel\n");
+        stream->print("# TYPE opendtu_rf_tx_rate gauge\n");
+    }
+    for (uint8_t c = 0; c < CHANNEL_QUALITY_CHANNELS; c++) {
+        stream->printf("opendtu_rf_tx_rate{serial=\"%s\",unit=\"%d\",name=\"%s\",rf_channel=\"%d\"} %f\n",
+            serial.c_str(), idx, inv->name(), ChannelHopping::getChannel(c), quality->getEntry(c).txRate);
+    }
+
+    if (printHelp) {
+        stream->print("# HELP opendtu_rf_rx_rate moving amount of fragments per rx slot per RF channel\n");
+        stream->print("# TYPE opendtu_rf_rx_rate gauge\n");
+    }
+    for (uint8_t c = 0; c < CHANNEL_QUALITY_CHANNELS; c++) {
+        stream->printf("opendtu_rf_rx_rate{serial=\"%s\",unit=\"%d\",name=\"%s\",rf_channel=\"%d\"} %f\n",
+            serial.c_str(), idx, inv->name(), ChannelHopping::getChannel(c), quality->getEntry(c).rxRate);
+    }
+
+    if (printHelp) {
+        stream->print("# HELP opendtu_rf_rx_fragments received fragments per RF channel\n");
+        stream->print("# TYPE opendtu_rf_rx_fragments counter\n");
+    }
+    for (uint8_t c = 0; c < CHANNEL_QUALITY_CHANNELS; c++) {
+        stream->printf("opendtu_rf_rx_fragments{serial=\"%s\",unit=\"%d\",name=\"%s\",rf_channel=\"%d\"} %u\n",
+            serial.c_str(), idx, inv->name(), ChannelHopping::getChannel(c), quality->getEntry(c).rxFragments);
+    }
+
+    if (printHelp) {
+        stream->print("# HELP opendtu_rf_rssi average rssi of the received fragments per RF channel in dBm\n");
+        stream->print("# TYPE opendtu_rf_rssi gauge\n");
+    }
+    for (uint8_t c = 0; c < CHANNEL_QUALITY_CHANNELS; c++) {
+        stream->printf("opendtu_rf_rssi{serial=\"%s\",unit=\"%d\",name=\"%s\",rf_channel=\"%d\"} %d\n",
+            serial.c_str(), idx, inv->name(), ChannelHopping::getChannel(c), quality->getEntry(c).rssi);
+    }
 }
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+#include "WebApi_rfcapture.h"
+#include "WebApi.h"
+#include "WebApi_errors.h"
+#include <AsyncJson.h>
+#include <Hoymiles.h>
+#include <memory>
+#include <vector>
+
+void WebApiRfCaptureClass::init(AsyncWebServer& server, Scheduler& scheduler)
+{
+    using std::placeholders::_1;
+
+    server.on("/api/rfcapture/status", HTTP_GET, std::bind(&WebApiRfCaptureClass::onRfCaptureStatus, this, _1));
+    server.on("/api/rfcapture/config", HTTP_POST, std::bind(&WebApiRfCaptureClass::onRfCapturePost, this, _1));
+    server.on("/api/rfcapture/download", HTTP_GET, std::bind(&WebApiRfCaptureClass::onRfCaptureDownload, this, _1));
+}
+
+void WebApiRfCaptureClass::onRfCaptureStatus(AsyncWebServerRequest* request)
+{
+    if (!WebApi.checkCredentialsReadonly(request)) {
+        return;
+    }
+
+    AsyncJsonResponse* response = new AsyncJsonResponse();
+    auto& root = response->getRoot();
+
+    const RfCapture& capture = Hoymiles.getRfCapture();
+    const RfCaptureStatistics_t statistics = capture.getStatistics();
+    root["enabled"] = capture.isEnabled();
+    root["size"] = statistics.size;
+    root["used"] = statistics.used;
+    root["records"] = statistics.records;
+    root["overwritten"] = statistics.overwritten;
+
+    WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+}
+
+void WebApiRfCaptureClass::onRfCapturePost(AsyncWebServerRequest* request)
+{
+    if (!WebApi.checkCredentials(request)) {
+        return;
+    }
+
+    AsyncJsonResponse* response = new AsyncJsonResponse();
+    JsonDocument root;
+    if (!WebApi.parseRequestData(request, response, root)) {
+        return;
+    }
+
+    auto& retMsg = response->getRoot();
+
+    if (!root.containsKey("enabled")) {
+        retMsg["message"] = "Values are missing!";
+        retMsg["code"] = WebApiError::GenericValueMissing;
+        WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+        return;
+    }
+
+    RfCapture& capture = Hoymiles.getRfCapture();
+
+    if (!root["enabled"].as<bool>()) {
+        capture.end();
+    } else if (root["clear"].as<bool>() && capture.isEnabled()) {
+        capture.clear();
+    } else {
+        // Buffers larger than 512 bytes are placed in PSRAM (if available), see main.cpp
+        const uint32_t size = root["size"] | (ESP.getPsramSize() > 0 ? RF_CAPTURE_DEFAULT_SIZE_PSRAM : RF_CAPTURE_DEFAULT_SIZE);
+        if (!capture.begin(size)) {
+            retMsg["message"] = "Capture buffer could not be allocated!";
+            retMsg["code"] = WebApiError::GenericInternalServerError;
+            WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+            return;
+        }
+    }
+
+    retMsg["type"] = "success";
+    retMsg["message"] = "Settings saved!";
+    retMsg["code"] = WebApiError::GenericSuccess;
+
+    WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
+}
+
+void WebApiRfCaptureClass::onRfCaptureDownload(AsyncWebServerRequest* request)
+{
+    if (!WebApi.checkCredentials(request)) {
+        return;
+    }
+
+    const RfCapture& capture = Hoymiles.getRfCapture();
+    if (!capture.isEnabled()) {
+        request->send(404);
+        return;
+    }
+
+    // The file header lists the inverters so that the replay can create them with their type
+    struct DownloadState_t {
+        std::vector<uint8_t> header;
+        size_t headerSent;
+        uint32_t position;
+        uint32_t end;
+    };
+    auto state = std::make_shared<DownloadState_t>();
+
+    std::vector<uint64_t> serials;
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        serials.push_back(Hoymiles.getInverterByPos(i)->serial());
+    }
+    state->header.resize(sizeof(RfCaptureHeader_t) + serials.size() * sizeof(uint64_t));
+    RfCapture::writeHeader(state->header.data(), state->header.size(), serials.data(), serials.size());
+    state->headerSent = 0;
+
+    // Only the records captured until now, the capture continues in the meantime
+    state->position = capture.getStartPosition();
+    state->end = capture.getEndPosition();
+
+    AsyncWebServerResponse* response = request->beginChunkedResponse("application/octet-stream",
+        [state](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            if (state->headerSent < state->header.size()) {
+                const size_t len = std::min(maxLen, state->header.size() - state->headerSent);
+                memcpy(buffer, &state->header[state->headerSent], len);
+                state->headerSent += len;
+                return len;
+            }
+            const size_t len = Hoymiles.getRfCapture().read(state->position, state->end, buffer, maxLen);
+            if (len == 0 && static_cast<int32_t>(state->end - state->position) > 0 && Hoymiles.getRfCapture().isEnabled()) {
+                // The next record does not fit into this chunk, 0 would end the download
+                return RESPONSE_TRY_AGAIN;
+            }
+            return len;
+        });
+    response->addHeader("Content-Disposition", "attachment; filename=\"rfcapture.bin\"");
+    request->send(response);
+}
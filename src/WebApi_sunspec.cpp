@@ -39,7 +39,7 @@ void WebApiSunSpecClass::onSunSpecGet(AsyncWebServerRequest* request)
 
     JsonArray data = root["inverter"].to<JsonArray>();
 
-    for (uint8_t i = 0; i < INV_MAX_COUNT; i++) {
+    for (uint8_t i = 0; i < config.Inverter.size(); i++) {
         config.SunSpec.Inverter[i].Serial = config.Inverter[i].Serial;
 
         if (config.Inverter[i].Serial == 0) {
@@ -104,7 +104,7 @@ void WebApiSunSpecClass::onSunSpecPost(AsyncWebServerRequest* request)
     ModbusSunSpec.setManufacturerModel(config.SunSpec.Manufacturer, config.SunSpec.Model);
 
     JsonArray inverterArray = root["inverter"].as<JsonArray>();
-    if (inverterArray.size() > INV_MAX_COUNT) {
+    if (inverterArray.size() > config.SunSpec.Inverter.size()) {
         retMsg["message"] = "Invalid amount of max channel setting given!";
         retMsg["code"] = WebApiError::InverterInvalidMaxChannel;
         WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
@@ -119,7 +119,7 @@ void WebApiSunSpecClass::onSunSpecPost(AsyncWebServerRequest* request)
             return;
         }
 
-        if (item["id"].as<uint8_t>() > INV_MAX_COUNT - 1) {
+        if (item["id"].as<uint8_t>() >= config.SunSpec.Inverter.size()) {
             retMsg["message"] = "Invalid ID specified!";
             retMsg["code"] = WebApiError::InverterInvalidId;
             WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
@@ -4,6 +4,7 @@
  */
 #include "WebApi_sysstatus.h"
 #include "Configuration.h"
+#include "MessageOutput.h"
 #include "NetworkSettings.h"
 #include "PinMapping.h"
 #include "WebApi.h"
@@ -23,6 +24,67 @@ void WebApiSysstatusClass::init(AsyncWebServer& server, Scheduler& scheduler)
     server.on("/api/system/status", HTTP_GET, std::bind(&WebApiSysstatusClass::onSystemStatus, this, _1));
 }
 
+static void addRadioStatistics(JsonObject obj, const HoymilesRadio& radio)
+{
+    // The radio loop may run in its own task, use the consistent copy
+    const RadioStatistics_t snapshot = radio.getStatisticsSnapshot();
+
+    obj["rx_overflow"] = snapshot.rxOverflow;
+    obj["rx_highwater"] = snapshot.rxHighWaterMark;
+
+    obj["cmd_pool_size"] = radio.getCommandPoolSize();
+    obj["cmd_pool_used"] = radio.getCommandPoolUsed();
+    obj["cmd_pool_highwater"] = radio.getCommandPoolHighWaterMark();
+    obj["cmd_pool_exhausted"] = radio.getCommandPoolExhaustedCount();
+    obj["cmd_coalesced"] = radio.getCommandCoalescedCount();
+    obj["cmd_succeeded"] = snapshot.commands.succeeded;
+    obj["cmd_failed"] = snapshot.commands.failed;
+
+    static const char* const priorityNames[CommandPriority_Max] = { "control", "realtime", "metadata" };
+    JsonObject wait = obj["cmd_wait"].to<JsonObject>();
+    for (uint8_t i = 0; i < CommandPriority_Max; i++) {
+        const CommandWaitStatistics_t stats = radio.getCommandWaitStatistics(static_cast<CommandPriority_t>(i));
+        JsonObject prio = wait[priorityNames[i]].to<JsonObject>();
+        prio["count"] = stats.count;
+        prio["avg_ms"] = stats.count > 0 ? static_cast<uint32_t>(stats.totalWait / stats.count) : 0;
+        prio["max_ms"] = stats.maxWait;
+        prio["promoted"] = stats.promoted;
+    }
+
+    const RxTimingStatistics_t& timing = snapshot.rxTiming;
+    JsonObject rx = obj["rx_timing"].to<JsonObject>();
+    rx["exchanges"] = timing.exchanges;
+    rx["completed_early"] = timing.completedEarly;
+    rx["avg_elapsed_ms"] = timing.exchanges > 0 ? static_cast<uint32_t>(timing.totalElapsed / timing.exchanges) : 0;
+    rx["avg_timeout_ms"] = timing.exchanges > 0 ? static_cast<uint32_t>(timing.totalTimeout / timing.exchanges) : 0;
+
+    static const char* const latencyClasses[] = { "realtime", "alarm", "devinfo", "config", "control" };
+    JsonObject retransmit = obj["retransmit"].to<JsonObject>();
+    for (uint8_t c = 0; c < CommandLatencyClass_Max; c++) {
+        const RetransmitStatistics_t& stats = snapshot.retransmit[c];
+        JsonObject cls = retransmit[latencyClasses[c]].to<JsonObject>();
+        cls["rounds"] = stats.rounds;
+        cls["fragments"] = stats.fragments;
+        cls["saved"] = stats.fragments - stats.rounds;
+    }
+}
+
+static void addChannelQuality(JsonArray array, const ChannelQualityTable& quality)
+{
+    for (uint8_t c = 0; c < CHANNEL_QUALITY_CHANNELS; c++) {
+        const ChannelQualityEntry_t& entry = quality.getEntry(c);
+        JsonObject obj = array.add<JsonObject>();
+        obj["channel"] = ChannelHopping::getChannel(c);
+        obj["tx"] = entry.txCount;
+        obj["tx_answered"] = entry.txAnswered;
+        obj["tx_rate"] = entry.txRate;
+        obj["rx_slots"] = entry.rxSlots;
+        obj["rx_fragments"] = entry.rxFragments;
+        obj["rx_rate"] = entry.rxRate;
+        obj["rssi"] = entry.rssi;
+    }
+}
+
 void WebApiSysstatusClass::onSystemStatus(AsyncWebServerRequest* request)
 {
     if (!WebApi.checkCredentialsReadonly(request)) {
@@ -72,9 +134,28 @@ void WebApiSysstatusClass::onSystemStatus(AsyncWebServerRequest* request)
     root["nrf_configured"] = PinMapping.isValidNrf24Config();
     root["nrf_connected"] = Hoymiles.getRadioNrf()->isConnected();
     root["nrf_pvariant"] = Hoymiles.getRadioNrf()->isPVariant();
+    addRadioStatistics(root["nrf_statistics"].to<JsonObject>(), *Hoymiles.getRadioNrf());
+    addChannelQuality(root["nrf_statistics"]["channels"].to<JsonArray>(), Hoymiles.getRadioNrf()->getChannelHopping().getTotals());
 
     root["cmt_configured"] = PinMapping.isValidCmt2300Config();
     root["cmt_connected"] = Hoymiles.getRadioCmt()->isConnected();
+    addRadioStatistics(root["cmt_statistics"].to<JsonObject>(), *Hoymiles.getRadioCmt());
+
+    const CmtRetuneStatistics_t retune = Hoymiles.getRadioCmt()->getRetuneStatistics();
+    root["cmt_statistics"]["retunes"] = retune.retunes;
+    root["cmt_statistics"]["retunes_skipped"] = retune.skipped;
+    root["cmt_statistics"]["pa_writes"] = retune.paLevelWrites;
+    root["cmt_statistics"]["pa_adaptive"] = Hoymiles.getRadioCmt()->isPALevelAdaptive();
+
+    const RadioTaskStatistics_t task = Hoymiles.getRadioTaskStatistics();
+    root["radio_task"]["running"] = Hoymiles.isRadioTaskRunning();
+    root["radio_task"]["iterations"] = task.iterations;
+    root["radio_task"]["wakeups"] = task.wakeups;
+
+    const MessageOutputStatistics_t output = MessageOutput.getStatistics();
+    root["console"]["dropped"] = output.droppedBytes;
+    root["console"]["ws_dropped"] = output.wsDroppedBytes;
+    root["console"]["highwater"] = output.highWaterMark;
 
     WebApi.sendJsonResponse(request, response, __FUNCTION__, __LINE__);
 }
@@ -57,8 +57,10 @@ void WebApiWsLiveClass::sendDataTaskCb()
         return;
     }
 
+    _lastPublishStats.resize(Hoymiles.getNumInverters(), 0);
+
     // Loop all inverters
-    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+    for (uint8_t i = 0; i < _lastPublishStats.size(); i++) {
         auto inv = Hoymiles.getInverterByPos(i);
         if (inv == nullptr) {
             continue;
@@ -126,6 +128,7 @@ void WebApiWsLiveClass::generateInverterCommonJsonResponse(JsonObject& root, std
     root["order"] = inv_cfg->Order;
     root["data_age"] = (millis() - inv->Statistics()->getLastUpdate()) / 1000;
     root["poll_enabled"] = inv->getEnablePolling();
+    root["poll_interval"] = inv->PollInterval()->getInterval() / 1000.0;
     root["reachable"] = inv->isReachable();
     root["producing"] = inv->isProducing();
     root["limit_relative"] = inv->SystemConfigPara()->getLimitPercent();
@@ -143,6 +146,10 @@ void WebApiWsLiveClass::generateInverterChannelJsonResponse(JsonObject& root, st
         return;
     }
 
+    // All fields of one frame
+    StatisticsValues_t values;
+    inv->Statistics()->getValues(values);
+
     // Loop all channels
     for (auto& t : inv->Statistics()->getChannelTypes()) {
         auto chanTypeObj = root[inv->Statistics()->getChannelTypeName(t)].to<JsonObject>();
@@ -150,25 +157,25 @@ void WebApiWsLiveClass::generateInverterChannelJsonResponse(JsonObject& root, st
             if (t == TYPE_DC) {
                 chanTypeObj[String(static_cast<uint8_t>(c))]["name"]["u"] = inv_cfg->channel[c].Name;
             }
-            addField(chanTypeObj, inv, t, c, FLD_PAC);
-            addField(chanTypeObj, inv, t, c, FLD_UAC);
-            addField(chanTypeObj, inv, t, c, FLD_IAC);
+            addField(chanTypeObj, inv, values, t, c, FLD_PAC);
+            addField(chanTypeObj, inv, values, t, c, FLD_UAC);
+            addField(chanTypeObj, inv, values, t, c, FLD_IAC);
             if (t == TYPE_INV) {
-                addField(chanTypeObj, inv, t, c, FLD_PDC, "Power DC");
+                addField(chanTypeObj, inv, values, t, c, FLD_PDC, "Power DC");
             } else {
-                addField(chanTypeObj, inv, t, c, FLD_PDC);
+                addField(chanTypeObj, inv, values, t, c, FLD_PDC);
             }
-            addField(chanTypeObj, inv, t, c, FLD_UDC);
-            addField(chanTypeObj, inv, t, c, FLD_IDC);
-            addField(chanTypeObj, inv, t, c, FLD_YD);
-            addField(chanTypeObj, inv, t, c, FLD_YT);
-            addField(chanTypeObj, inv, t, c, FLD_F);
-            addField(chanTypeObj, inv, t, c, FLD_T);
-            addField(chanTypeObj, inv, t, c, FLD_PF);
-            addField(chanTypeObj, inv, t, c, FLD_Q);
-            addField(chanTypeObj, inv, t, c, FLD_EFF);
+            addField(chanTypeObj, inv, values, t, c, FLD_UDC);
+            addField(chanTypeObj, inv, values, t, c, FLD_IDC);
+            addField(chanTypeObj, inv, values, t, c, FLD_YD);
+            addField(chanTypeObj, inv, values, t, c, FLD_YT);
+            addField(chanTypeObj, inv, values, t, c, FLD_F);
+            addField(chanTypeObj, inv, values, t, c, FLD_T);
+            addField(chanTypeObj, inv, values, t, c, FLD_PF);
+            addField(chanTypeObj, inv, values, t, c, FLD_Q);
+            addField(chanTypeObj, inv, values, t, c, FLD_EFF);
             if (t == TYPE_DC && inv->Statistics()->getStringMaxPower(c) > 0) {
-                addField(chanTypeObj, inv, t, c, FLD_IRR);
+                addField(chanTypeObj, inv, values, t, c, FLD_IRR);
                 chanTypeObj[String(c)][inv->Statistics()->getChannelFieldName(t, c, FLD_IRR)]["max"] = inv->Statistics()->getStringMaxPower(c);
             }
         }
@@ -181,7 +188,7 @@ void WebApiWsLiveClass::generateInverterChannelJsonResponse(JsonObject& root, st
     }
 }
 
-void WebApiWsLiveClass::addField(JsonObject& root, std::shared_ptr<InverterAbstract> inv, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, String topic)
+void WebApiWsLiveClass::addField(JsonObject& root, std::shared_ptr<InverterAbstract> inv, const StatisticsValues_t& values, const ChannelType_t type, const ChannelNum_t channel, const FieldId_t fieldId, String topic)
 {
     if (inv->Statistics()->hasChannelFieldValue(type, channel, fieldId)) {
         String chanName;
@@ -192,7 +199,7 @@ void WebApiWsLiveClass::addField(JsonObject& root, std::shared_ptr<InverterAbstr
         }
         String chanNum;
         chanNum = channel;
-        root[chanNum][chanName]["v"] = inv->Statistics()->getChannelFieldValue(type, channel, fieldId);
+        root[chanNum][chanName]["v"] = inv->Statistics()->getChannelFieldValue(values, type, channel, fieldId);
         root[chanNum][chanName]["u"] = inv->Statistics()->getChannelFieldUnit(type, channel, fieldId);
         root[chanNum][chanName]["d"] = inv->Statistics()->getChannelFieldDigits(type, channel, fieldId);
     }
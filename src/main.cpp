@@ -5,6 +5,7 @@
 #include "Configuration.h"
 #include "Datastore.h"
 #include "Display_Graphic.h"
+#include "EventHistory.h"
 #include "InverterSettings.h"
 #include "Led_Single.h"
 #include "MessageOutput.h"
@@ -41,7 +42,7 @@ void setup()
     while (!Serial)
         yield();
 #endif
-    MessageOutput.init(scheduler);
+    MessageOutput.init();
     MessageOutput.println();
     MessageOutput.println("Starting OpenDTU");
 
@@ -156,6 +157,8 @@ void setup()
 
     Datastore.init(scheduler);
 
+    EventHistory.init(scheduler);
+
     // Initialize Modbus SunSpec
     MessageOutput.print(F("Initialize Modbus (SunSpec)... "));
     ModbusSunSpec.init(scheduler);
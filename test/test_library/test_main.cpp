@@ -0,0 +1,534 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Checks of the library building blocks on the host, without radio traffic.
+Run with pio test -e native -f test_library
+*/
+#include "Benchmark.h"
+#include "HostAlloc.h"
+#include "SimFleet.h"
+#include <EventIndex.h>
+#include <Hoymiles.h>
+#include <HoymilesLog.h>
+#include <MpscRingBuffer.h>
+#include <SnapshotArray.h>
+#include <SpscRingBuffer.h>
+#include <crc.h>
+#include <inverters/HERF_2CH.h>
+#include <inverters/HMS_1CH.h>
+#include <inverters/HMS_1CHv2.h>
+#include <inverters/HMS_2CH.h>
+#include <inverters/HMS_4CH.h>
+#include <inverters/HMT_4CH.h>
+#include <inverters/HMT_6CH.h>
+#include <inverters/HM_1CH.h>
+#include <inverters/HM_2CH.h>
+#include <inverters/HM_4CH.h>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unity.h>
+
+class StringOutput : public Print {
+public:
+    size_t write(uint8_t c) override
+    {
+        text += static_cast<char>(c);
+        return 1;
+    }
+    int availableForWrite() override { return 4096; }
+
+    std::string text;
+};
+
+static std::vector<std::unique_ptr<InverterAbstract>> createModels()
+{
+    std::vector<std::unique_ptr<InverterAbstract>> models;
+    models.push_back(std::make_unique<HM_1CH>(nullptr, 0x112100000001));
+    models.push_back(std::make_unique<HM_2CH>(nullptr, 0x114100000001));
+    models.push_back(std::make_unique<HM_4CH>(nullptr, 0x116100000001));
+    models.push_back(std::make_unique<HERF_2CH>(nullptr, 0x282100000001));
+    models.push_back(std::make_unique<HMS_1CH>(nullptr, 0x112400000001));
+    models.push_back(std::make_unique<HMS_1CHv2>(nullptr, 0x112500000001));
+    models.push_back(std::make_unique<HMS_2CH>(nullptr, 0x114400000001));
+    models.push_back(std::make_unique<HMS_4CH>(nullptr, 0x116400000001));
+    models.push_back(std::make_unique<HMT_4CH>(nullptr, 0x136100000001));
+    models.push_back(std::make_unique<HMT_6CH>(nullptr, 0x138200000001));
+    for (auto& inv : models) {
+        inv->init();
+    }
+    return models;
+}
+
+// Fills the payload with random bytes and decodes it
+static void receiveFrame(StatisticsParser& parser, uint8_t payload[], std::mt19937& rng)
+{
+    for (uint8_t i = 0; i < STATISTIC_PACKET_SIZE; i++) {
+        payload[i] = rng();
+    }
+    parser.beginAppendFragment();
+    parser.clearBuffer();
+    parser.appendFragment(0, payload, parser.getExpectedByteCount());
+    parser.endAppendFragment();
+}
+
+// Independent decode of a raw field
+static float decodeField(const byteAssign_t& pos, const uint8_t payload[])
+{
+    int64_t val = 0;
+    for (uint8_t i = 0; i < pos.num; i++) {
+        val = (val << 8) | payload[pos.start + i];
+    }
+    if (pos.isSigned && val >= (1ll << (8 * pos.num - 1))) {
+        val -= 1ll << (8 * pos.num);
+    }
+    return static_cast<float>(val) / pos.div;
+}
+
+static float sumChannels(StatisticsParser& parser, const ChannelType_t type, const FieldId_t fieldId)
+{
+    float sum = 0;
+    for (auto& c : parser.getChannelsByType(type)) {
+        sum += parser.getChannelFieldValue(type, c, fieldId);
+    }
+    return sum;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_crc_variants_match_bitwise(void)
+{
+    std::mt19937 rng(1);
+    uint8_t buf[255];
+    for (auto& b : buf) {
+        b = rng();
+    }
+
+    for (uint16_t len = 0; len <= sizeof(buf); len++) {
+        TEST_ASSERT_EQUAL_UINT8(crc8_bitwise(buf, len), crc8_table(buf, len));
+        TEST_ASSERT_EQUAL_UINT16(crc16_bitwise(buf, len, 0xffff), crc16_table(buf, len, 0xffff));
+        TEST_ASSERT_EQUAL_UINT16(crc16_bitwise(buf, len, 0xffff), crc16_slice4(buf, len, 0xffff));
+        TEST_ASSERT_EQUAL_UINT16(crc16_bitwise(buf, len, 0x1234), crc16_slice4(buf, len, 0x1234));
+        if (len < 32) {
+            for (uint16_t startBit = 0; startBit < 8; startBit++) {
+                TEST_ASSERT_EQUAL_UINT16(crc16nrf24_bitwise(buf, len * 8, startBit, 0xffff), crc16nrf24_table(buf, len * 8, startBit, 0xffff));
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(crc16_bitwise(buf, 27, 0xffff), crc16(buf, 27));
+}
+
+void test_spsc_ring_buffer_keeps_order(void)
+{
+    SpscRingBuffer<uint32_t, 8> buffer;
+    uint32_t next = 0;
+    uint32_t expected = 0;
+
+    for (uint32_t round = 0; round < 5; round++) {
+        while (buffer.push(next)) {
+            next++;
+        }
+        TEST_ASSERT_EQUAL_UINT(buffer.capacity(), buffer.size());
+
+        uint32_t item;
+        for (uint8_t i = 0; i < 3 && buffer.pop(item); i++) {
+            TEST_ASSERT_EQUAL_UINT32(expected++, item);
+        }
+    }
+
+    uint32_t item;
+    while (buffer.pop(item)) {
+        TEST_ASSERT_EQUAL_UINT32(expected++, item);
+    }
+    TEST_ASSERT_EQUAL_UINT32(next, expected);
+    TEST_ASSERT_TRUE(buffer.empty());
+    TEST_ASSERT_EQUAL_UINT32(5, buffer.getOverflowCount());
+    TEST_ASSERT_EQUAL_UINT32(8, buffer.getHighWaterMark());
+}
+
+void test_mpsc_ring_buffer_keeps_messages_whole(void)
+{
+    MpscRingBuffer<16, 8> buffer;
+    const char* messages[] = { "short", "a message longer than one slot", "x" };
+    std::string written;
+    for (const char* m : messages) {
+        TEST_ASSERT_TRUE(buffer.write(reinterpret_cast<const uint8_t*>(m), strlen(m)));
+        written += m;
+    }
+
+    // Does not fit into the remaining slots and is dropped as a whole
+    const std::string large(5 * 16, 'y');
+    TEST_ASSERT_FALSE(buffer.write(reinterpret_cast<const uint8_t*>(large.data()), large.size()));
+    TEST_ASSERT_EQUAL_UINT32(large.size(), buffer.getDroppedBytes());
+
+    uint8_t out[256];
+    const size_t len = buffer.read(out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING(written.c_str(), std::string(reinterpret_cast<char*>(out), len).c_str());
+    TEST_ASSERT_TRUE(buffer.empty());
+}
+
+void test_snapshot_array_returns_last_publication(void)
+{
+    SnapshotArray<uint32_t> snapshot;
+    snapshot.resize(5);
+
+    uint32_t values[5] = {};
+    snapshot.read(values);
+    for (const uint32_t v : values) {
+        TEST_ASSERT_EQUAL_UINT32(0, v);
+    }
+
+    uint32_t lastVersion = snapshot.getVersion();
+    for (uint32_t round = 1; round <= 3; round++) {
+        const uint32_t published[5] = { round, round * 2, round * 3, round * 4, round * 5 };
+        snapshot.publish(published);
+
+        const uint32_t version = snapshot.read(values);
+        TEST_ASSERT_GREATER_THAN_UINT32(lastVersion, version);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(published, values, sizeof(values));
+        lastVersion = version;
+    }
+}
+
+void test_statistics_decode_all_models(void)
+{
+    std::mt19937 rng(1);
+    for (auto& inv : createModels()) {
+        StatisticsParser& parser = *inv->Statistics();
+        uint8_t payload[STATISTIC_PACKET_SIZE];
+        receiveFrame(parser, payload, rng);
+
+        const byteAssign_t* assignment = inv->getByteAssignment();
+        for (uint8_t i = 0; i < inv->getByteAssignmentSize(); i++) {
+            const byteAssign_t& pos = assignment[i];
+            TEST_ASSERT_TRUE(parser.hasChannelFieldValue(pos.type, pos.ch, pos.fieldId));
+            if (pos.div != CMD_CALC) {
+                TEST_ASSERT_EQUAL_FLOAT_MESSAGE(decodeField(pos, payload), parser.getChannelFieldValue(pos.type, pos.ch, pos.fieldId), inv->typeName().c_str());
+            }
+        }
+
+        if (parser.hasChannelFieldValue(TYPE_INV, CH0, FLD_PDC)) {
+            TEST_ASSERT_EQUAL_FLOAT(sumChannels(parser, TYPE_DC, FLD_PDC), parser.getChannelFieldValue(TYPE_INV, CH0, FLD_PDC));
+        }
+        if (parser.hasChannelFieldValue(TYPE_INV, CH0, FLD_YT)) {
+            TEST_ASSERT_EQUAL_FLOAT(sumChannels(parser, TYPE_DC, FLD_YT), parser.getChannelFieldValue(TYPE_INV, CH0, FLD_YT));
+        }
+    }
+}
+
+void test_statistics_offsets(void)
+{
+    std::mt19937 rng(2);
+    HM_4CH inv(nullptr, 0x116100000001);
+    inv.init();
+    StatisticsParser& parser = *inv.Statistics();
+    uint8_t payload[STATISTIC_PACKET_SIZE];
+    receiveFrame(parser, payload, rng);
+
+    const float raw = parser.getChannelFieldValue(TYPE_DC, CH1, FLD_YT);
+    const float total = parser.getChannelFieldValue(TYPE_INV, CH0, FLD_YT);
+
+    parser.setChannelFieldOffset(TYPE_DC, CH1, FLD_YT, 12.5f);
+    TEST_ASSERT_EQUAL_FLOAT(12.5f, parser.getChannelFieldOffset(TYPE_DC, CH1, FLD_YT));
+    TEST_ASSERT_EQUAL_FLOAT(raw + 12.5f, parser.getChannelFieldValue(TYPE_DC, CH1, FLD_YT));
+    TEST_ASSERT_EQUAL_FLOAT(total + 12.5f, parser.getChannelFieldValue(TYPE_INV, CH0, FLD_YT));
+
+    // Kept for the next frame
+    receiveFrame(parser, payload, rng);
+    const byteAssign_t* pos = parser.getAssignmentByChannelField(TYPE_DC, CH1, FLD_YT);
+    TEST_ASSERT_EQUAL_FLOAT(decodeField(*pos, payload) + 12.5f, parser.getChannelFieldValue(TYPE_DC, CH1, FLD_YT));
+
+    parser.setChannelFieldOffset(TYPE_DC, CH1, FLD_YT, 0);
+    TEST_ASSERT_EQUAL_FLOAT(0, parser.getChannelFieldOffset(TYPE_DC, CH1, FLD_YT));
+    TEST_ASSERT_EQUAL_FLOAT(decodeField(*pos, payload), parser.getChannelFieldValue(TYPE_DC, CH1, FLD_YT));
+}
+
+void test_statistics_zero_data(void)
+{
+    std::mt19937 rng(3);
+    HMT_6CH inv(nullptr, 0x138200000001);
+    inv.init();
+    StatisticsParser& parser = *inv.Statistics();
+    uint8_t payload[STATISTIC_PACKET_SIZE];
+    receiveFrame(parser, payload, rng);
+
+    const float yieldTotal = parser.getChannelFieldValue(TYPE_INV, CH0, FLD_YT);
+    const uint32_t generation = parser.getGeneration();
+
+    parser.zeroRuntimeData();
+    TEST_ASSERT_EQUAL_UINT32(generation + 1, parser.getGeneration());
+    for (auto& c : parser.getChannelsByType(TYPE_DC)) {
+        TEST_ASSERT_EQUAL_FLOAT(0, parser.getChannelFieldValue(TYPE_DC, c, FLD_UDC));
+        TEST_ASSERT_EQUAL_FLOAT(0, parser.getChannelFieldValue(TYPE_DC, c, FLD_PDC));
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0, parser.getChannelFieldValue(TYPE_INV, CH0, FLD_PDC));
+    TEST_ASSERT_EQUAL_FLOAT(yieldTotal, parser.getChannelFieldValue(TYPE_INV, CH0, FLD_YT));
+
+    parser.zeroDailyData();
+    TEST_ASSERT_EQUAL_FLOAT(0, parser.getChannelFieldValue(TYPE_INV, CH0, FLD_YD));
+    TEST_ASSERT_EQUAL_FLOAT(yieldTotal, parser.getChannelFieldValue(TYPE_INV, CH0, FLD_YT));
+}
+
+void test_statistics_render_without_allocations(void)
+{
+    std::mt19937 rng(4);
+    for (auto& inv : createModels()) {
+        StatisticsParser& parser = *inv->Statistics();
+        uint8_t payload[STATISTIC_PACKET_SIZE];
+        receiveFrame(parser, payload, rng);
+
+        const uint64_t allocations = HostAlloc::getAllocationCount();
+        uint32_t fields = 0;
+        for (auto& t : parser.getChannelTypes()) {
+            for (auto& c : parser.getChannelsByType(t)) {
+                for (uint8_t i = 0; i < FIELD_CNT; i++) {
+                    const FieldId_t fieldId = static_cast<FieldId_t>(i);
+                    if (parser.hasChannelFieldValue(t, c, fieldId)
+                        && parser.getChannelFieldName(t, c, fieldId) != nullptr
+                        && parser.getChannelFieldUnit(t, c, fieldId) != nullptr
+                        && parser.getChannelFieldDigits(t, c, fieldId) <= 3) {
+                        fields++;
+                    }
+                }
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT64(allocations, HostAlloc::getAllocationCount());
+        TEST_ASSERT_EQUAL_UINT32(inv->getByteAssignmentSize(), fields);
+    }
+}
+
+void test_channel_lists_match_byte_assignment(void)
+{
+    for (auto& inv : createModels()) {
+        StatisticsParser& parser = *inv->Statistics();
+        const byteAssign_t* assignment = inv->getByteAssignment();
+
+        for (auto& t : parser.getChannelTypes()) {
+            uint8_t expected = 0;
+            for (uint8_t i = 0; i < inv->getByteAssignmentSize(); i++) {
+                if (assignment[i].type == t) {
+                    expected |= 1 << assignment[i].ch;
+                }
+            }
+
+            uint8_t listed = 0;
+            int8_t last = -1;
+            for (auto& c : parser.getChannelsByType(t)) {
+                TEST_ASSERT_GREATER_THAN(last, static_cast<int8_t>(c));
+                TEST_ASSERT_TRUE(parser.getChannelsByType(t).contains(c));
+                listed |= 1 << c;
+                last = c;
+            }
+            TEST_ASSERT_EQUAL_UINT8(expected, listed);
+            TEST_ASSERT_EQUAL_UINT8(__builtin_popcount(expected), parser.getChannelsByType(t).size());
+        }
+    }
+}
+
+void test_inverter_lookup(void)
+{
+    NullOutput output;
+    SimFleet fleet(BenchmarkArgs(""), &output);
+    fleet.addInverters(50, "mixed");
+
+    for (uint8_t i = 0; i < Hoymiles.getNumInverters(); i++) {
+        const auto inv = Hoymiles.getInverterByPos(i);
+        TEST_ASSERT_EQUAL_PTR(inv.get(), Hoymiles.findInverterBySerial(inv->serial()));
+        TEST_ASSERT_EQUAL_PTR(inv.get(), Hoymiles.getInverterBySerial(inv->serial()).get());
+
+        serial_u s;
+        s.u64 = inv->serial();
+        fragment_t fragment = {};
+        fragment.fragment[0] = 0x95;
+        fragment.fragment[1] = s.b[3];
+        fragment.fragment[2] = s.b[2];
+        fragment.fragment[3] = s.b[1];
+        fragment.fragment[4] = s.b[0];
+        fragment.len = 27;
+        TEST_ASSERT_EQUAL_PTR(inv.get(), Hoymiles.findInverterByFragment(fragment));
+    }
+
+    TEST_ASSERT_NULL(Hoymiles.findInverterBySerial(SimFleet::buildSerial("hm", 1000)));
+    TEST_ASSERT_NULL(Hoymiles.getInverterBySerial(SimFleet::buildSerial("hm", 1000)));
+}
+
+void test_log_deferred_matches_eager(void)
+{
+    StringOutput outputs[2];
+    const uint8_t payload[] = { 0x95, 0x10, 0x00, 0x00, 0x00, 0x80, 0x12, 0x23, 0x04, 0x01 };
+    const String name = "RealTimeRunData";
+    const int8_t rssi = -60;
+
+    for (uint8_t m = 0; m < 2; m++) {
+        HoymilesLog.setOutput(&outputs[m]);
+        HoymilesLog.setDeferred(m == 1);
+
+        HOY_LOG(RADIO, DEBUG, "TX %s Channel: %d --> ", name.c_str(), 3);
+        HOY_LOG_HEX(RADIO, DEBUG, payload, sizeof(payload));
+        HOY_LOG(RADIO, DEBUG, "| %d dBm\r\n", rssi);
+        HOY_LOG(RADIO, INFO, "CMT: Retune to %.2f MHz (%u retunes, %u skipped)\r\n", 865000000 / 1000000.0, 12u, 0u);
+        HOY_LOG(RADIO, INFO, "RX %.2f MHz --> %5.1f %-6s|\r\n", 863.25f, -1.25, "ab");
+        HOY_LOG(RADIO, INFO, "%x %X %02x %o %c %u %%\r\n", rssi, 0xABCDu, 7, 8, 'z', static_cast<uint8_t>(200));
+        HOY_LOG(RADIO, INFO, "%lu %lld %ld\r\n", 4000000000ul, -5000000000ll, -1l);
+        HOY_LOG(SCHEDULER, INFO, "Fetch inverter: %X%08X\r\n", 0x1161u, 0x10000000u);
+        HOY_LOG(PARSER, ERROR, "FATAL: (%s, %d) stats packet too large for buffer\r\n", "StatisticsParser.cpp", 92);
+
+        while (HoymilesLog.flush(outputs[m]) > 0) { }
+    }
+    HoymilesLog.setDeferred(HOY_LOG_DEFERRED);
+    HoymilesLog.setOutput(&Serial);
+
+    TEST_ASSERT_TRUE(outputs[0].text.size() > 0);
+    TEST_ASSERT_EQUAL_STRING(outputs[0].text.c_str(), outputs[1].text.c_str());
+}
+
+void test_event_index_merges_known_events(void)
+{
+    EventIndex index;
+    const EventHistoryEntry_t active = { 1000, 0, 124, 0, 0 };
+    TEST_ASSERT_TRUE(index.insert(1, active));
+    TEST_ASSERT_FALSE(index.insert(1, active));
+
+    // The end of an active event is taken over once, a later active report keeps it
+    EventHistoryEntry_t ended = active;
+    ended.EndTime = 2000;
+    TEST_ASSERT_TRUE(index.insert(1, ended));
+    TEST_ASSERT_FALSE(index.insert(1, ended));
+    TEST_ASSERT_FALSE(index.insert(1, active));
+    TEST_ASSERT_EQUAL_UINT(1, index.size());
+
+    std::vector<EventHistoryEntry_t> page;
+    TEST_ASSERT_EQUAL_UINT(1, index.getEvents(1, 0, UINT32_MAX, 0, 10, page));
+    TEST_ASSERT_EQUAL_UINT32(2000, page[0].EndTime);
+
+    // Same start with another message or of another inverter is a new event
+    EventHistoryEntry_t other = active;
+    other.MessageId = 1;
+    TEST_ASSERT_TRUE(index.insert(1, other));
+    TEST_ASSERT_TRUE(index.insert(2, active));
+    TEST_ASSERT_EQUAL_UINT(3, index.size());
+}
+
+void test_event_index_dates_late_events_to_the_previous_day(void)
+{
+    const uint32_t day = 19000;
+    const uint32_t now = 3600;
+
+    const EventHistoryEntry_t today = EventIndex::makeEntry(day, now, now + 60, 0, 1, 0);
+    TEST_ASSERT_EQUAL_UINT32(day * EVENT_INDEX_SECONDS_PER_DAY + now + 60, today.Start);
+    TEST_ASSERT_EQUAL_UINT32(0, today.EndTime);
+
+    const EventHistoryEntry_t yesterday = EventIndex::makeEntry(day, now, 23 * 3600, 23 * 3600 + 60, 1, 1);
+    TEST_ASSERT_EQUAL_UINT32((day - 1) * EVENT_INDEX_SECONDS_PER_DAY + 23 * 3600, yesterday.Start);
+    TEST_ASSERT_EQUAL_UINT32(23 * 3600 + 60, yesterday.EndTime);
+    TEST_ASSERT_EQUAL_UINT8(1, yesterday.MessageType);
+
+    // Times moved below midnight by the timezone offset
+    const EventHistoryEntry_t wrapped = EventIndex::makeEntry(day, now, -600, 86400 + 60, 1, 0);
+    TEST_ASSERT_EQUAL_UINT32((day - 1) * EVENT_INDEX_SECONDS_PER_DAY + 86400 - 600, wrapped.Start);
+    TEST_ASSERT_EQUAL_UINT32(60, wrapped.EndTime);
+}
+
+void test_event_index_pages_newest_first(void)
+{
+    EventIndex index;
+    for (const uint32_t start : { 1005, 1001, 1009, 1000, 1003, 1007, 1002, 1008, 1004, 1006 }) {
+        TEST_ASSERT_TRUE(index.insert(1, { start, 0, 1, 0, 0 }));
+    }
+
+    std::vector<EventHistoryEntry_t> page;
+    TEST_ASSERT_EQUAL_UINT(10, index.getEvents(1, 0, UINT32_MAX, 0, 3, page));
+    TEST_ASSERT_EQUAL_UINT(3, page.size());
+    TEST_ASSERT_EQUAL_UINT32(1009, page[0].Start);
+    TEST_ASSERT_EQUAL_UINT32(1007, page[2].Start);
+
+    TEST_ASSERT_EQUAL_UINT(10, index.getEvents(1, 0, UINT32_MAX, 9, 3, page));
+    TEST_ASSERT_EQUAL_UINT(1, page.size());
+    TEST_ASSERT_EQUAL_UINT32(1000, page[0].Start);
+
+    TEST_ASSERT_EQUAL_UINT(10, index.getEvents(1, 0, UINT32_MAX, 10, 3, page));
+    TEST_ASSERT_EQUAL_UINT(0, page.size());
+
+    // from and to are inclusive
+    TEST_ASSERT_EQUAL_UINT(3, index.getEvents(1, 1003, 1005, 0, 10, page));
+    TEST_ASSERT_EQUAL_UINT(3, page.size());
+    TEST_ASSERT_EQUAL_UINT32(1005, page[0].Start);
+    TEST_ASSERT_EQUAL_UINT32(1003, page[2].Start);
+
+    TEST_ASSERT_EQUAL_UINT(0, index.getEvents(2, 0, UINT32_MAX, 0, 10, page));
+    TEST_ASSERT_EQUAL_UINT(0, page.size());
+}
+
+void test_event_index_compact_drops_the_oldest(void)
+{
+    EventIndex index;
+    for (uint32_t start = 1000; start < 1010; start++) {
+        TEST_ASSERT_TRUE(index.insert(start % 2, { start, 0, 1, 0, 0 }));
+    }
+
+    TEST_ASSERT_EQUAL_UINT(10, index.compact(10).size());
+    TEST_ASSERT_EQUAL_UINT(10, index.size());
+
+    const std::vector<EventHistoryRecord_t> records = index.compact(4);
+    TEST_ASSERT_EQUAL_UINT(4, records.size());
+    TEST_ASSERT_EQUAL_UINT(4, index.size());
+    for (const auto& record : records) {
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1006, record.Entry.Start);
+        TEST_ASSERT_EQUAL_UINT64(record.Entry.Start % 2, record.Serial);
+    }
+
+    std::vector<EventHistoryEntry_t> page;
+    TEST_ASSERT_EQUAL_UINT(2, index.getEvents(0, 0, UINT32_MAX, 0, 10, page));
+    TEST_ASSERT_EQUAL_UINT32(1008, page[0].Start);
+    TEST_ASSERT_EQUAL_UINT32(1006, page[1].Start);
+    TEST_ASSERT_EQUAL_UINT(2, index.getEvents(1, 0, UINT32_MAX, 0, 10, page));
+    TEST_ASSERT_EQUAL_UINT32(1009, page[0].Start);
+}
+
+void test_alarm_messages_fall_back_to_all_types(void)
+{
+    // Messages of the type win over the ones for all types
+    TEST_ASSERT_EQUAL_STRING("MPPT-C: Input overvoltage", AlarmLogParser::getMessageText(215, AlarmMessageType_t::HMT));
+    TEST_ASSERT_EQUAL_STRING("PV-1: Input overvoltage", AlarmLogParser::getMessageText(215, AlarmMessageType_t::ALL));
+    TEST_ASSERT_EQUAL_STRING("Inverter start", AlarmLogParser::getMessageText(1, AlarmMessageType_t::HMT));
+
+    // Messages of another type are not used
+    TEST_ASSERT_EQUAL_STRING("Unknown", AlarmLogParser::getMessageText(171, AlarmMessageType_t::ALL));
+    TEST_ASSERT_EQUAL_STRING("Unbekannt", AlarmLogParser::getMessageText(9999, AlarmMessageType_t::HMT, AlarmMessageLocale_t::DE));
+
+    // Missing translations fall back to english
+    TEST_ASSERT_EQUAL_STRING("Wechselrichter gestartet", AlarmLogParser::getMessageText(1, AlarmMessageType_t::ALL, AlarmMessageLocale_t::DE));
+    TEST_ASSERT_EQUAL_STRING("Time calibration", AlarmLogParser::getMessageText(2, AlarmMessageType_t::ALL, AlarmMessageLocale_t::FR));
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_variants_match_bitwise);
+    RUN_TEST(test_spsc_ring_buffer_keeps_order);
+    RUN_TEST(test_mpsc_ring_buffer_keeps_messages_whole);
+    RUN_TEST(test_snapshot_array_returns_last_publication);
+    RUN_TEST(test_statistics_decode_all_models);
+    RUN_TEST(test_statistics_offsets);
+    RUN_TEST(test_statistics_zero_data);
+    RUN_TEST(test_statistics_render_without_allocations);
+    RUN_TEST(test_channel_lists_match_byte_assignment);
+    RUN_TEST(test_inverter_lookup);
+    RUN_TEST(test_log_deferred_matches_eager);
+    RUN_TEST(test_event_index_merges_known_events);
+    RUN_TEST(test_event_index_dates_late_events_to_the_previous_day);
+    RUN_TEST(test_event_index_pages_newest_first);
+    RUN_TEST(test_event_index_compact_drops_the_oldest);
+    RUN_TEST(test_alarm_messages_fall_back_to_all_types);
+    return UNITY_END();
+}
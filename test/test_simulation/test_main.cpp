@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Runs the scenarios of the benchmark suites in virtual time and checks the
+effect of the scheduling, timeout, hopping, retransmit, log and transmit power
+features against the same fleet without them. The fleets are smaller and
+shorter than in the suites, the checks only compare runs with each other.
+Run with pio test -e native -f test_simulation
+*/
+#include "Scenario.h"
+#include "SimFleet.h"
+#include <unity.h>
+
+static float getFailureRate(const uint32_t polls, const uint32_t failures)
+{
+    return polls + failures > 0 ? 100.0f * failures / (polls + failures) : 0;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_every_inverter_delivers_data(void)
+{
+    const FleetResult_t r = runFleet(BenchmarkArgs("--duration 60"), 20);
+    TEST_ASSERT_EQUAL_UINT32(20, r.inverters);
+    TEST_ASSERT_EQUAL_UINT32(0, r.missing);
+    TEST_ASSERT_GREATER_THAN_UINT32(20, r.polls);
+}
+
+void test_complete_answers_end_the_exchange_early(void)
+{
+    const FleetResult_t r = runFleet(BenchmarkArgs("--duration 60"), 10);
+    TEST_ASSERT_GREATER_THAN_UINT32(r.rxTiming.exchanges / 2, r.rxTiming.completedEarly);
+    TEST_ASSERT_LESS_THAN_UINT64(r.rxTiming.totalTimeout / 2, r.rxTiming.totalElapsed);
+}
+
+void test_radios_poll_in_parallel(void)
+{
+    const BenchmarkArgs args("--duration 60");
+    const FleetResult_t hm = runFleet(args.with("--mix hm"), 10);
+    const FleetResult_t hms = runFleet(args.with("--mix hms"), 10);
+    const FleetResult_t both = runFleet(args.with("--mix hm+hms"), 10);
+
+    // Half of the fleet on each radio is polled faster than the same fleet on the faster radio alone
+    TEST_ASSERT_GREATER_THAN_UINT32(hm.polls, both.polls);
+    TEST_ASSERT_GREATER_THAN_UINT32(hms.polls, both.polls);
+}
+
+void test_limits_are_coalesced(void)
+{
+    const FleetResult_t r = runFleet(BenchmarkArgs("--limits 1200 --sources 6 --loss 0 --duration 60"), 5);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, r.limits.requested);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, r.limits.coalesced);
+    TEST_ASSERT_EQUAL_UINT32(r.limits.requested, r.limits.coalesced + r.limits.transmitted);
+    TEST_ASSERT_EQUAL_UINT32(0, r.limits.mismatches);
+}
+
+void test_limits_overtake_queued_requests(void)
+{
+    const FleetResult_t r = runFleet(BenchmarkArgs("--limits 30 --duration 300"), 25);
+    const CommandWaitStatistics_t& control = r.limits.wait[PRIO_CONTROL];
+    const CommandWaitStatistics_t& metadata = r.limits.wait[PRIO_METADATA];
+    TEST_ASSERT_GREATER_THAN_UINT32(0, control.count);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, metadata.count);
+    TEST_ASSERT_LESS_THAN_UINT32(metadata.maxWait, control.maxWait);
+    TEST_ASSERT_EQUAL_UINT32(0, r.limits.mismatches);
+}
+
+void test_adaptive_poll_prefers_changing_inverters(void)
+{
+    const BenchmarkArgs args("--cloudy 33 --offline 33 --duration 600");
+    const FleetResult_t fixed = runFleet(args.with("--adaptive-poll off"), 30);
+    const FleetResult_t adaptive = runFleet(args.with("--adaptive-poll on"), 30);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(2 * fixed.groups[GROUP_CLOUDY].polls, adaptive.groups[GROUP_CLOUDY].polls);
+    TEST_ASSERT_LESS_THAN_FLOAT(fixed.groups[GROUP_CLOUDY].powerError, adaptive.groups[GROUP_CLOUDY].powerError);
+    TEST_ASSERT_GREATER_THAN_FLOAT(adaptive.groups[GROUP_STABLE].interval, adaptive.groups[GROUP_OFFLINE].interval);
+}
+
+void test_adaptive_poll_keeps_commands_without_polling(void)
+{
+    uint32_t interval;
+    {
+        NullOutput output;
+        SimFleet fleet(BenchmarkArgs("--adaptive-poll on --poll-min 5 --poll-max 30"), &output);
+        fleet.addInverters(2, "hm");
+
+        // E.g. night mode, the inverter is not polled but takes commands
+        const auto inv = Hoymiles.getInverterByPos(0);
+        inv->setEnablePolling(false);
+        for (uint32_t i = 0; i < 120 * 1000 * 4; i++) {
+            fleet.tick(250);
+        }
+        interval = inv->PollInterval()->getInterval();
+    }
+
+    // Not backed off like an unreachable inverter
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(30 * 1000, interval);
+}
+
+void test_learned_timeout_polls_faster(void)
+{
+    const BenchmarkArgs args("--far 50");
+    const FleetResult_t fixed = runFleet(args.with("--learned-timeout off"), 20);
+    const FleetResult_t learned = runFleet(args.with("--learned-timeout on"), 20);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(fixed.polls, learned.polls);
+    TEST_ASSERT_TRUE(getFailureRate(learned.polls, learned.failures) <= getFailureRate(fixed.polls, fixed.failures) + 1);
+    TEST_ASSERT_LESS_THAN_FLOAT(learned.groups[GROUP_FAR].timeout, learned.groups[GROUP_STABLE].timeout);
+}
+
+void test_adaptive_hopping_avoids_jammed_channels(void)
+{
+    const BenchmarkArgs args("--mix hm --jam 23,40");
+    const FleetResult_t roundRobin = runFleet(args.with("--hopping round-robin"), 20);
+    const FleetResult_t adaptive = runFleet(args.with("--hopping adaptive"), 20);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(roundRobin.polls, adaptive.polls);
+    TEST_ASSERT_LESS_THAN_FLOAT(getFailureRate(roundRobin.polls, roundRobin.failures), getFailureRate(adaptive.polls, adaptive.failures));
+}
+
+void test_retransmit_requests_several_fragments(void)
+{
+    const FleetResult_t r = runFleet(BenchmarkArgs("--loss 0.2 --duration 120"), 10);
+    const RetransmitStatistics_t& s = r.retransmit[LATENCY_REALTIME];
+    TEST_ASSERT_GREATER_THAN_UINT32(0, s.rounds);
+    TEST_ASSERT_GREATER_THAN_UINT32(s.rounds, s.fragments);
+}
+
+void test_large_fleet_delivers_data(void)
+{
+    const FleetResult_t r = runFleet(BenchmarkArgs("--duration 120"), 100);
+    TEST_ASSERT_EQUAL_UINT32(0, r.missing);
+    // Library heap per inverter without the configuration, see native/README.md
+    TEST_ASSERT_LESS_THAN_UINT64(4096 * r.inverters, r.libraryBytes);
+}
+
+void test_deferred_log_does_not_block(void)
+{
+    const BenchmarkArgs args("--baud 115200 --fifo 3 --duration 120");
+    const FleetResult_t deferred = runFleet(args.with("--log deferred"), 10);
+    const FleetResult_t eager = runFleet(args.with("--log eager"), 10);
+
+    TEST_ASSERT_EQUAL_UINT64(0, deferred.log.blockedUs);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, deferred.log.bytes);
+    TEST_ASSERT_GREATER_THAN_UINT32(eager.polls, deferred.polls);
+}
+
+void test_cmt_register_cache_and_tx_power(void)
+{
+    const BenchmarkArgs args("");
+    const CmtResult_t fixed = runCmtFleet(args.with("--tx-power static"));
+    const CmtResult_t adaptive = runCmtFleet(args.with("--tx-power adaptive"));
+
+    for (const CmtResult_t* r : { &fixed, &adaptive }) {
+        TEST_ASSERT_GREATER_THAN_UINT32(0, r->polls);
+        TEST_ASSERT_EQUAL_UINT32(0, r->spi.channelWritesRedundant);
+        TEST_ASSERT_EQUAL_UINT32(0, r->spi.paLevelWritesRedundant);
+        TEST_ASSERT_EQUAL_UINT32(0, r->spi.channelReads);
+        TEST_ASSERT_LESS_THAN_UINT32(r->spi.packetsSent, r->spi.channelWrites);
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(fixed.level[DISTANCE_NEAR], adaptive.level[DISTANCE_NEAR]);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(fixed.failures + fixed.polls / 100, adaptive.failures);
+}
+
+void test_replay_matches_recording(void)
+{
+    const RecordResult_t recording = recordCapture(BenchmarkArgs("--duration 60"));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, recording.completed);
+
+    NullOutput output;
+    ReplayResult_t r;
+    TEST_ASSERT_TRUE(replayCapture(recording.capture, 1, r, &output));
+    TEST_ASSERT_EQUAL_UINT32(0, r.crcErrors);
+    TEST_ASSERT_EQUAL_UINT32(0, r.errors);
+    TEST_ASSERT_EQUAL_UINT32(recording.completed, r.complete);
+    TEST_ASSERT_EQUAL_UINT32(recording.values.size(), r.values.size());
+    for (const auto& v : recording.values) {
+        const ReplayValues_t& replayed = r.values[v.first];
+        TEST_ASSERT_EQUAL_FLOAT(v.second.power, replayed.power);
+        TEST_ASSERT_EQUAL_FLOAT(v.second.yieldTotal, replayed.yieldTotal);
+    }
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_every_inverter_delivers_data);
+    RUN_TEST(test_complete_answers_end_the_exchange_early);
+    RUN_TEST(test_radios_poll_in_parallel);
+    RUN_TEST(test_limits_are_coalesced);
+    RUN_TEST(test_limits_overtake_queued_requests);
+    RUN_TEST(test_adaptive_poll_prefers_changing_inverters);
+    RUN_TEST(test_adaptive_poll_keeps_commands_without_polling);
+    RUN_TEST(test_learned_timeout_polls_faster);
+    RUN_TEST(test_adaptive_hopping_avoids_jammed_channels);
+    RUN_TEST(test_retransmit_requests_several_fragments);
+    RUN_TEST(test_large_fleet_delivers_data);
+    RUN_TEST(test_deferred_log_does_not_block);
+    RUN_TEST(test_cmt_register_cache_and_tx_power);
+    RUN_TEST(test_replay_matches_recording);
+    return UNITY_END();
+}
@@ -0,0 +1,83 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+/*
+ * Copyright (C) 2024 Thomas Basler and others
+ */
+
+/*
+Stress tests of the data exchanged between threads in real time.
+Run with pio test -e native -f test_threads
+*/
+#include "Scenario.h"
+#include "SimFleet.h"
+#include <unity.h>
+
+#define TEST_THREADS_DURATION 500 // ms per run
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_spsc_handoff_keeps_every_fragment(void)
+{
+    for (const bool locked : { true, false }) {
+        const HandoffResult_t r = runSpsc(200000, locked);
+        TEST_ASSERT_EQUAL_UINT32(0, r.errors);
+    }
+}
+
+void test_mpsc_handoff_keeps_messages_in_order(void)
+{
+    for (const uint32_t baud : { 0u, 115200u }) {
+        const HandoffResult_t r = runMpsc(4, 2000, 16, baud, 1, false);
+        TEST_ASSERT_EQUAL_UINT32(0, r.errors);
+        TEST_ASSERT_EQUAL_UINT64(r.written, r.received + r.dropped);
+        TEST_ASSERT_GREATER_THAN_UINT32(0, r.received);
+    }
+}
+
+void test_snapshot_is_never_torn(void)
+{
+    uint32_t reads;
+    TEST_ASSERT_EQUAL_UINT32(0, runSnapshotStress(TEST_THREADS_DURATION, reads));
+    TEST_ASSERT_GREATER_THAN_UINT32(0, reads);
+}
+
+void test_statistics_readers_see_whole_frames(void)
+{
+    NullOutput output;
+    SimFleet fleet(BenchmarkArgs(""), &output);
+    const auto inv = fleet.addInverter(SimFleet::buildSerial("hmt", 0));
+    TEST_ASSERT_NOT_NULL(inv.get());
+
+    const StatisticsResult_t r = runStatisticsReaders(*inv, READERS_LOCK_FREE, 4, TEST_THREADS_DURATION);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, r.frames);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, r.reads);
+    TEST_ASSERT_EQUAL_UINT64(0, r.inconsistent);
+}
+
+void test_radio_task_keeps_polling_while_the_loop_is_busy(void)
+{
+    const BenchmarkArgs args("--duration 1000");
+    const TaskResult_t loop = runRadioTask(args.with("--radio-task off"));
+    const TaskResult_t task = runRadioTask(args.with("--radio-task on"));
+
+    TEST_ASSERT_EQUAL_UINT32(0, loop.inconsistent);
+    TEST_ASSERT_EQUAL_UINT32(0, task.inconsistent);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, task.reads);
+    TEST_ASSERT_GREATER_THAN_UINT32(loop.succeeded, task.succeeded);
+}
+
+int main(int /*argc*/, char** /*argv*/)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_spsc_handoff_keeps_every_fragment);
+    RUN_TEST(test_mpsc_handoff_keeps_messages_in_order);
+    RUN_TEST(test_snapshot_is_never_torn);
+    RUN_TEST(test_statistics_readers_see_whole_frames);
+    RUN_TEST(test_radio_task_keeps_polling_while_the_loop_is_busy);
+    return UNITY_END();
+}
@@ -4,11 +4,14 @@ export interface CountryDef {
     freq_max: number;
     freq_legal_min: number;
     freq_legal_max: number;
+    pa_legal_max: number;
 }
 
 export interface DtuConfig {
     serial: number;
     pollinterval: number;
+    pollinterval_min: number;
+    pollinterval_max: number;
     nrf_enabled: boolean;
     nrf_palevel: number;
     cmt_enabled: boolean;
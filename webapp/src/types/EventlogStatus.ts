@@ -3,9 +3,12 @@ export interface EventlogItem {
     message: string;
     start_time: number;
     end_time: number;
+    timestamp?: number;
 }
 
 export interface EventlogItems {
+    total: number;
+    offset: number;
     count: number;
     events: Array<EventlogItem>;
 }
\ No newline at end of file
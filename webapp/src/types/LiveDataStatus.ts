@@ -27,6 +27,7 @@ export interface Inverter {
     order: number;
     data_age: number;
     poll_enabled: boolean;
+    poll_interval: number;
     reachable: boolean;
     producing: boolean;
     limit_relative: number;